@@ -20,6 +20,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
+#include "tim.h"
 #include "usart.h"
 #include "gpio.h"
 
@@ -32,6 +33,38 @@
 
 //#include "Serial.h"
 #include "Serial_test.h"
+#include "Trace.h"
+#include "Shell.h"
+#include "Rpc.h"
+#include "Modbus.h"
+#include "Timebase.h"
+#include "KVstore.h"
+#include "FlashLog.h"
+#include "RamFunc.h"
+#include "Pool.h"
+#include "Startup.h"
+#include "Fault.h"
+#include "Prof.h"
+#include "Latency.h"
+#include "Led.h"
+#include "Input.h"
+#include "Capture.h"
+#include "Wave.h"
+#include "Logic.h"
+#include "Adc.h"
+#include "Encoder.h"
+//#include "Log_test.h"
+//#include "KVstore_test.h"
+//#include "FlashLog_test.h"
+//#include "RamFunc_test.h"
+//#include "Gpio_test.h"
+//#include "Input_test.h"
+//#include "Capture_test.h"
+//#include "Wave_test.h"
+//#include "Logic_test.h"
+//#include "Adc_test.h"
+//#include "Encoder_test.h"
+//#include "Fault_test.h"
 
 /* USER CODE END Includes */
 
@@ -57,6 +90,7 @@
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
+static void MX_NVIC_Init(void);
 /* USER CODE BEGIN PFP */
 
 /* USER CODE END PFP */
@@ -73,7 +107,8 @@ void SystemClock_Config(void);
 int main(void)
 {
   /* USER CODE BEGIN 1 */
-    
+    Startup_init();
+    Fault_init();
   /* USER CODE END 1 */
   
 
@@ -89,22 +124,66 @@ int main(void)
     // RingBuff.push(&ringBuffer_test, 'c');
 
     // x = RingBuff.get_nBytes(&ringBuffer_test);
-
+    Startup_stamp(STARTUP_HAL_INIT);
   /* USER CODE END Init */
 
   /* Configure the system clock */
   SystemClock_Config();
 
   /* USER CODE BEGIN SysInit */
-
+    Startup_stamp(STARTUP_CLOCK);
   /* USER CODE END SysInit */
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
   MX_USART1_UART_Init();
-  /* USER CODE BEGIN 2 */
+  MX_TIM4_Init();
 
+  /* Initialize interrupts */
+  MX_NVIC_Init();
+  /* USER CODE BEGIN 2 */
+    Startup_stamp(STARTUP_TIM_NVIC);
+    RamFunc_init();
+    Pool_init();
+    Timebase_init(&htim4);
+    Led_init();
+    Input_init();
+    Capture_init();
+    Wave_init();
+    Logic_init();
+    Adc_init();
+    Encoder_init();
+    Trace_init();
+    Prof_init();
+    Latency_init();
+    Startup_stamp(STARTUP_MODULES);
     serial_test_init();
+    Startup_stamp(STARTUP_SERIAL);
+    // log_test_run();
+    // kv_test_run();
+    FlashLog_init();
+    Startup_stamp(STARTUP_FLASHLOG);
+    // flog_test_run();
+    // ramfunc_test_run();
+    // gpio_test_run();
+    // input_test_run();
+    // capture_test_run();
+    // wave_test_run();
+    // logic_test_run();
+    // adc_test_run();
+    // encoder_test_run();
+    KVstore_init((uintptr_t)__kvstore_start, &kv_flash_hal);
+    Startup_stamp(STARTUP_KVSTORE);
+    Shell_init(&serial_0);
+    Startup_stamp(STARTUP_SHELL);
+#if ( STARTUP_PRINT_AT_BOOT == 1 )
+    Startup_print(&serial_0);
+#endif
+    Fault_print(&serial_0);
+    if (Fault_last() != NULL) {
+        Led.code(LED_CODE_FAULT);
+    }
+    // fault_test_run();
 
   /* USER CODE END 2 */
 
@@ -114,7 +193,16 @@ int main(void)
   {
     /* USER CODE END WHILE */
 
-    serial_test_exe();
+    if ( (Trace.dump_exe() == 0) && (FlashLog.export_exe() == 0) && (Prof.dump_exe() == 0) ) {
+      Shell.exe();
+      Capture.exe();
+      Logic.exe();
+      Adc.exe();
+    }
+    Encoder.exe();
+    Rpc.exe();
+    Modbus.exe();
+    KVstore.exe();
 
     /* USER CODE BEGIN 3 */
   }
@@ -155,6 +243,17 @@ void SystemClock_Config(void)
   }
 }
 
+/**
+  * @brief NVIC Configuration.
+  * @retval None
+  */
+static void MX_NVIC_Init(void)
+{
+  /* FLASH_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(FLASH_IRQn, 3, 0);
+  HAL_NVIC_EnableIRQ(FLASH_IRQn);
+}
+
 /* USER CODE BEGIN 4 */
 
 /* USER CODE END 4 */
@@ -92,8 +92,15 @@
 /*!< Uncomment the following line if you need to relocate your vector Table in
      Internal SRAM. */ 
 /* #define VECT_TAB_SRAM */
-#define VECT_TAB_OFFSET  0x00000000U /*!< Vector Table base offset field. 
-                                  This value must be a multiple of 0x200. */
+/* Table is not linked to SRAM_BASE in this project, use RAMFUNC_SRAM_VECTORS
+   (source/RamFunc) instead, it copies active table to SRAM at run time */
+#ifndef VECT_TAB_OFFSET
+#define VECT_TAB_OFFSET  0x00002000U /*!< Vector Table base offset field. 
+                                  This value must be a multiple of 0x200. 
+                                  Application is linked behind the bootloader
+                                  (STM32F103C8_FLASH.ld), bootloader build
+                                  defines VECT_TAB_OFFSET=0 */
+#endif
 
 
 /**
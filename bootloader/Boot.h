@@ -0,0 +1,130 @@
+/**
+ * @file Boot.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief UART bootloader: flash layout and transfer protocol (tools/boot/boot_flash.py)
+ *
+ * flash: 0x08000000 bootloader (7K), 0x08001C00 boot info page, 0x08002000 application
+ * (32K, STM32F103C8_FLASH.ld), FlashLog and KVstore regions after it are not touched.
+ *
+ * host -> device frame:
+ *  BOOT_SOF_HOST, type, seq (u16), len (u16), payload[len], crc32 (u32) of type..payload
+ * device -> host reply:
+ *  BOOT_SOF_DEV, type, seq (u16), ~(sum of type and seq bytes)
+ *
+ * START (payload: image size, image crc32, baud, all u32) erases application region and
+ * is answered with ACK 0 at current baud, then both sides switch to requested baud.
+ * DATA blocks (seq = block number, BOOT_BLOCK_SIZE bytes each, last one can be shorter)
+ * are sent in sliding window of BOOT_WINDOW blocks. ACK n is cumulative: all blocks
+ * before n are accepted. NAK n asks for go back to block n. Block with bad crc or out of
+ * order is dropped.
+ * END is answered with DONE after whole image crc matches, then device resets into the
+ * new application. ERR replies carry boot_err_t in seq.
+ *
+ * DELTA (payload boot_delta_t) starts update from patch against installed image
+ * (tools/boot/boot_delta.py). DATA blocks then carry the patch stream, made of ops:
+ *  BOOT_OP_COPY, len (u16), src (u16): len bytes from application region offset src
+ *  BOOT_OP_LIT, len (u16), bytes[len]
+ * New image is built in page buffer and each page is erased and programmed as soon as it
+ * is complete, so COPY reads new content below current page and old content from it on.
+ * Generator keeps sources inside this view. Update is in place: when it is interrupted,
+ * info page stays in update state and full image has to be sent.
+ *
+ * Received blocks are collected in two page buffers. One is programmed while the other
+ * is filled, reception itself goes to RAM ring by DMA, so it never waits for flash.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef BOOT_H
+#define BOOT_H
+
+#include <stdint.h>
+
+//=======================================================================================
+#define BOOT_APP_ADDR       0x08002000u
+#define BOOT_APP_SIZE       (32u * 1024u)
+#define BOOT_INFO_ADDR      0x08001C00u
+#define BOOT_PAGE_SIZE      1024u
+
+#define BOOT_BAUD           115200u     // baud after reset, host can ask for more in START
+#define BOOT_BLOCK_SIZE     256u
+/**
+ * @brief blocks in flight. DMA ring must hold whole window
+ */
+#define BOOT_WINDOW         6u
+#define BOOT_RX_RING_SIZE   2048u
+
+/**
+ * @brief application sets this value in BKP->DR1 and resets, to stay in bootloader
+ */
+#define BOOT_REQ_MAGIC      0xB007u
+//=======================================================================================
+
+#define BOOT_SOF_HOST       0x5Au
+#define BOOT_SOF_DEV        0xA5u
+#define BOOT_FRAME_HDR      5u      // type, seq, len
+#define BOOT_FRAME_MAX      (1u + BOOT_FRAME_HDR + BOOT_BLOCK_SIZE + 4u)
+
+#if ((BOOT_WINDOW * BOOT_FRAME_MAX) > BOOT_RX_RING_SIZE)
+    #error "Boot: DMA ring does not hold the whole window"
+#endif
+
+typedef enum _boot_type_t{
+    /* host -> device */
+    BOOT_T_START = 0x01,
+    BOOT_T_DATA = 0x02,
+    BOOT_T_END = 0x03,
+    BOOT_T_DELTA = 0x04,
+    /* device -> host */
+    BOOT_T_ACK = 0x80,
+    BOOT_T_NAK = 0x81,
+    BOOT_T_DONE = 0x82,
+    BOOT_T_ERR = 0x83,
+}boot_type_t;
+
+typedef enum _boot_err_t{
+    BOOT_ERR_SIZE = 1,      // image does not fit into application region
+    BOOT_ERR_STATE,         // DATA or END without START
+    BOOT_ERR_FLASH,         // erase or program failed
+    BOOT_ERR_CRC,           // image crc does not match
+    BOOT_ERR_BAUD,
+    BOOT_ERR_BASE,          // installed image is not the one patch was made against
+    BOOT_ERR_PATCH,         // malformed patch stream
+}boot_err_t;
+
+typedef struct _boot_start_t{
+    uint32_t    size;
+    uint32_t    crc;
+    uint32_t    baud;
+}boot_start_t;
+
+typedef struct _boot_delta_t{
+    boot_start_t    start;      // new image
+    uint32_t        base_size;  // installed image
+    uint32_t        base_crc;
+    uint32_t        patch_size;
+}boot_delta_t;
+
+typedef enum _boot_op_t{
+    BOOT_OP_COPY = 0x01,
+    BOOT_OP_LIT = 0x02,
+}boot_op_t;
+
+/**
+ * @brief boot info page. Written on START (state erased = update in progress), state is
+ * cleared to BOOT_STATE_VALID when image is verified. Erased page means application was
+ * flashed by debugger, it is started when its vector table looks sane.
+ */
+typedef struct _boot_info_t{
+    uint32_t    magic;
+    uint32_t    size;
+    uint32_t    crc;
+    uint32_t    state;
+}boot_info_t;
+
+#define BOOT_INFO_MAGIC     0x424F4F54u     // "BOOT"
+#define BOOT_STATE_VALID    0x00000000u
+
+#endif /* BOOT_H */
@@ -0,0 +1,174 @@
+/**
+ * @file boot_hw.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief bootloader hardware layer on registers
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "boot_hw.h"
+#include "Boot.h"
+
+static uint8_t boot_rx_ring[BOOT_RX_RING_SIZE];
+static uint16_t boot_rx_rd;
+static uint32_t boot_crc_table[256];
+
+//=========================================================
+/* clock */
+
+void boot_clock_init(void) {
+    RCC->CR |= RCC_CR_HSION;
+    while ((RCC->CR & RCC_CR_HSIRDY) == 0) {
+    }
+    /* 64 MHz needs 2 wait states */
+    FLASH->ACR = FLASH_ACR_PRFTBE | FLASH_ACR_LATENCY_1;
+    /* PLL source HSI / 2, APB1 max 36 MHz */
+    RCC->CFGR = RCC_CFGR_PLLMULL16 | RCC_CFGR_PPRE1_DIV2;
+    RCC->CR |= RCC_CR_PLLON;
+    while ((RCC->CR & RCC_CR_PLLRDY) == 0) {
+    }
+    RCC->CFGR |= RCC_CFGR_SW_PLL;
+    while ((RCC->CFGR & RCC_CFGR_SWS) != RCC_CFGR_SWS_PLL) {
+    }
+    SystemCoreClock = BOOT_CORE_CLK;
+}
+
+//=========================================================
+/* uart */
+
+void boot_uart_init(uint32_t baud) {
+    RCC->APB2ENR |= RCC_APB2ENR_IOPAEN | RCC_APB2ENR_USART1EN;
+    RCC->AHBENR |= RCC_AHBENR_DMA1EN;
+
+    /* PA9 alternate push pull 50 MHz, PA10 input floating */
+    GPIOA->CRH = (GPIOA->CRH & ~(GPIO_CRH_MODE9 | GPIO_CRH_CNF9 | GPIO_CRH_MODE10 | GPIO_CRH_CNF10)) |
+                 GPIO_CRH_MODE9 | GPIO_CRH_CNF9_1 | GPIO_CRH_CNF10_0;
+
+    /* DMA1 channel 5 = USART1_RX, circular, never stops */
+    DMA1_Channel5->CCR = 0;
+    DMA1_Channel5->CPAR = (uint32_t)&USART1->DR;
+    DMA1_Channel5->CMAR = (uint32_t)boot_rx_ring;
+    DMA1_Channel5->CNDTR = BOOT_RX_RING_SIZE;
+    DMA1_Channel5->CCR = DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_PL_1;
+    DMA1_Channel5->CCR |= DMA_CCR_EN;
+    boot_rx_rd = 0;
+
+    USART1->BRR = (BOOT_CORE_CLK + (baud / 2u)) / baud;
+    USART1->CR3 = USART_CR3_DMAR;
+    USART1->CR1 = USART_CR1_UE | USART_CR1_TE | USART_CR1_RE;
+}
+
+void boot_uart_baud(uint32_t baud) {
+    boot_uart_wait_tx();
+    USART1->CR1 &= ~USART_CR1_UE;
+    USART1->BRR = (BOOT_CORE_CLK + (baud / 2u)) / baud;
+    USART1->CR1 |= USART_CR1_UE;
+}
+
+void boot_uart_write(const uint8_t *pData, uint16_t len) {
+    while (len--) {
+        while ((USART1->SR & USART_SR_TXE) == 0) {
+        }
+        USART1->DR = *pData++;
+    }
+}
+
+void boot_uart_wait_tx(void) {
+    while ((USART1->SR & USART_SR_TC) == 0) {
+    }
+}
+
+uint16_t boot_uart_rx_cnt(void) {
+    uint16_t wr = (uint16_t)(BOOT_RX_RING_SIZE - DMA1_Channel5->CNDTR);
+
+    /* CNDTR is reloaded to ring size at the end */
+    if (wr >= BOOT_RX_RING_SIZE) {
+        wr = 0;
+    }
+    return (uint16_t)((wr + BOOT_RX_RING_SIZE - boot_rx_rd) % BOOT_RX_RING_SIZE);
+}
+
+uint8_t boot_uart_rx_get(void) {
+    uint8_t data = boot_rx_ring[boot_rx_rd];
+
+    boot_rx_rd = (uint16_t)((boot_rx_rd + 1u) % BOOT_RX_RING_SIZE);
+    return data;
+}
+
+//=========================================================
+/* flash */
+
+void boot_flash_unlock(void) {
+    if ((FLASH->CR & FLASH_CR_LOCK) != 0) {
+        FLASH->KEYR = FLASH_KEY1;
+        FLASH->KEYR = FLASH_KEY2;
+    }
+}
+
+uint8_t boot_flash_busy(void) {
+    return (FLASH->SR & FLASH_SR_BSY) != 0;
+}
+
+uint8_t boot_flash_error(void) {
+    uint32_t sr = FLASH->SR;
+
+    FLASH->SR = FLASH_SR_EOP | FLASH_SR_PGERR | FLASH_SR_WRPRTERR;
+    return (sr & (FLASH_SR_PGERR | FLASH_SR_WRPRTERR)) != 0;
+}
+
+uint8_t boot_flash_erase(uint32_t addr) {
+    while (boot_flash_busy()) {
+    }
+    (void)boot_flash_error();
+    FLASH->CR = FLASH_CR_PER;
+    FLASH->AR = addr;
+    FLASH->CR = FLASH_CR_PER | FLASH_CR_STRT;
+    /* first read stalls until erase is done */
+    while (boot_flash_busy()) {
+    }
+    FLASH->CR = 0;
+    return boot_flash_error();
+}
+
+void boot_flash_program_start(uint32_t addr, uint16_t val) {
+    FLASH->CR = FLASH_CR_PG;
+    *(volatile uint16_t *)addr = val;
+}
+
+uint8_t boot_flash_program(uint32_t addr, uint16_t val) {
+    while (boot_flash_busy()) {
+    }
+    (void)boot_flash_error();
+    boot_flash_program_start(addr, val);
+    while (boot_flash_busy()) {
+    }
+    FLASH->CR = 0;
+    return boot_flash_error();
+}
+
+//=========================================================
+/* crc32, same as zlib crc32 (reflected 0xEDB88320) */
+
+void boot_crc32_init(void) {
+    uint32_t i;
+    uint32_t j;
+    uint32_t c;
+
+    for (i = 0; i < 256u; ++i) {
+        c = i;
+        for (j = 0; j < 8u; ++j) {
+            c = (c & 1u) ? ((c >> 1) ^ 0xEDB88320u) : (c >> 1);
+        }
+        boot_crc_table[i] = c;
+    }
+}
+
+uint32_t boot_crc32(uint32_t crc, const uint8_t *pData, uint32_t len) {
+    crc = ~crc;
+    while (len--) {
+        crc = boot_crc_table[(crc ^ *pData++) & 0xFFu] ^ (crc >> 8);
+    }
+    return ~crc;
+}
@@ -0,0 +1,49 @@
+/**
+ * @file boot_hw.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief bootloader hardware layer on registers (no HAL, bootloader has 7K of flash):
+ * clock, USART1 with DMA reception into RAM ring, flash programming, crc32
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef BOOT_HW_H
+#define BOOT_HW_H
+
+#include <stdint.h>
+
+#include "stm32f1xx.h"
+
+/**
+ * @brief HSI / 2 * 16 = 64 MHz, USART1 on APB2 can do up to 4 Mbaud
+ */
+#define BOOT_CORE_CLK       64000000u
+
+void     boot_clock_init(void);
+
+/**
+ * @brief USART1 (PA9 Tx, PA10 Rx), reception by DMA1 channel 5 into circular ring
+ */
+void     boot_uart_init(uint32_t baud);
+void     boot_uart_baud(uint32_t baud);
+void     boot_uart_write(const uint8_t *pData, uint16_t len);
+void     boot_uart_wait_tx(void);        // until last bit is on the line
+uint16_t boot_uart_rx_cnt(void);         // bytes waiting in ring
+uint8_t  boot_uart_rx_get(void);
+
+void     boot_flash_unlock(void);
+uint8_t  boot_flash_erase(uint32_t addr);                 // blocking, 0: ok
+uint8_t  boot_flash_program(uint32_t addr, uint16_t val); // blocking, 0: ok
+/**
+ * @brief start programming of one half word, check boot_flash_busy() before next one
+ */
+void     boot_flash_program_start(uint32_t addr, uint16_t val);
+uint8_t  boot_flash_busy(void);
+uint8_t  boot_flash_error(void);         // error of last operation, clears it
+
+void     boot_crc32_init(void);
+uint32_t boot_crc32(uint32_t crc, const uint8_t *pData, uint32_t len); // start with 0
+
+#endif /* BOOT_HW_H */
@@ -0,0 +1,584 @@
+/**
+ * @file boot_main.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief UART bootloader, protocol is described in Boot.h
+ *
+ * Separate image, not part of TrueStudio project. Build:
+ *  arm-none-eabi-gcc -mcpu=cortex-m3 -mthumb -Os -ffunction-sections -Wl,--gc-sections
+ *   -DSTM32F103xB -DVECT_TAB_OFFSET=0 -Ibootloader -ICore/Inc
+ *   -IDrivers/CMSIS/Include -IDrivers/CMSIS/Device/ST/STM32F1xx/Include
+ *   bootloader/boot_main.c bootloader/boot_hw.c Core/Src/system_stm32f1xx.c
+ *   startup/startup_stm32f103xb.s -T STM32F103C8_BOOT.ld --specs=nano.specs -o boot.elf
+ *
+ * Application is started right after reset when it is valid and no stay request was
+ * set in BKP->DR1 (shell command "boot"). Clock is switched to PLL only when staying,
+ * application always starts from the same reset state of RCC.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include <string.h>
+
+#include "Boot.h"
+#include "boot_hw.h"
+
+#define PAGE_BUF_CNT        2u
+#define RAM_START           0x20000000u
+#define RAM_END             (RAM_START + (20u * 1024u))
+
+typedef enum _buf_state_t{
+    BUF_FREE = 0,
+    BUF_FILL,       // receiving blocks
+    BUF_READY,      // complete, waits for flash
+    BUF_PROG,       // being programmed
+}buf_state_t;
+
+typedef struct _page_buf_t{
+    uint8_t     state;
+    uint16_t    page;       // page index in application region
+    uint16_t    prog_off;   // next half word to program
+    uint16_t    data[BOOT_PAGE_SIZE / 2];
+}page_buf_t;
+
+typedef enum _rx_state_t{
+    RX_SOF = 0,
+    RX_HDR,
+    RX_BODY,
+    RX_DONE,        // complete frame waits for processing
+}rx_state_t;
+
+static struct {
+    uint8_t     state;
+    uint16_t    cnt;
+    uint16_t    len;
+    uint8_t     frame[BOOT_FRAME_MAX - 1u];     // without SOF
+}rx;
+
+static struct {
+    uint8_t         started;
+    uint8_t         delta;          // DATA carries patch stream
+    boot_start_t    start;
+    uint32_t        stream_size;    // image or patch
+    uint16_t        rx_next;        // next expected block
+    uint16_t        blocks;         // in whole stream
+    uint8_t         nak_sent;       // one NAK per gap, cleared by in order block
+    uint8_t         flash_err;
+    page_buf_t      buf[PAGE_BUF_CNT];
+    page_buf_t      *p_fill;
+    page_buf_t      *p_prog;
+}boot;
+
+/* patch stream decoder */
+static struct {
+    uint8_t     hdr[5];
+    uint8_t     hdr_cnt;
+    uint16_t    lit_left;       // literal bytes still to come
+    uint32_t    out;            // new image bytes produced
+}patch;
+
+//=========================================================
+/* boot decision */
+
+static uint8_t app_vectors_ok(void) {
+    uint32_t sp = *(volatile uint32_t *)BOOT_APP_ADDR;
+    uint32_t pc = *(volatile uint32_t *)(BOOT_APP_ADDR + 4u);
+
+    return (sp > RAM_START) && (sp <= RAM_END) &&
+           (pc >= BOOT_APP_ADDR) && (pc < (BOOT_APP_ADDR + BOOT_APP_SIZE));
+}
+
+static uint8_t app_valid(void) {
+    const volatile boot_info_t *p_info = (const volatile boot_info_t *)BOOT_INFO_ADDR;
+
+    if (p_info->magic == 0xFFFFFFFFu) {
+        /* no update was ever done, application from debugger */
+        return app_vectors_ok();
+    }
+    return (p_info->magic == BOOT_INFO_MAGIC) && (p_info->state == BOOT_STATE_VALID) &&
+           app_vectors_ok();
+}
+
+static uint8_t stay_requested(void) {
+    uint8_t stay = 0;
+
+    RCC->APB1ENR |= RCC_APB1ENR_PWREN | RCC_APB1ENR_BKPEN;
+    if ((BKP->DR1 & 0xFFFFu) == BOOT_REQ_MAGIC) {
+        PWR->CR |= PWR_CR_DBP;
+        BKP->DR1 = 0;
+        PWR->CR &= ~PWR_CR_DBP;
+        stay = 1;
+    }
+    RCC->APB1ENR &= ~(RCC_APB1ENR_PWREN | RCC_APB1ENR_BKPEN);
+    return stay;
+}
+
+static void app_jump(void) {
+    uint32_t sp = *(volatile uint32_t *)BOOT_APP_ADDR;
+    void (*p_reset)(void) = (void (*)(void))(*(volatile uint32_t *)(BOOT_APP_ADDR + 4u));
+
+    SCB->VTOR = BOOT_APP_ADDR;
+    __set_MSP(sp);
+    p_reset();
+}
+
+//=========================================================
+/* replies */
+
+static void reply(uint8_t type, uint16_t seq) {
+    uint8_t msg[5];
+
+    msg[0] = BOOT_SOF_DEV;
+    msg[1] = type;
+    msg[2] = (uint8_t)seq;
+    msg[3] = (uint8_t)(seq >> 8);
+    msg[4] = (uint8_t)~(msg[1] + msg[2] + msg[3]);
+    boot_uart_write(msg, sizeof(msg));
+}
+
+static void nak_once(void) {
+    if (!boot.nak_sent) {
+        boot.nak_sent = 1;
+        reply(BOOT_T_NAK, boot.rx_next);
+    }
+}
+
+//=========================================================
+/* page buffers */
+
+static void buf_free(page_buf_t *p_buf) {
+    memset(p_buf->data, 0xFF, sizeof(p_buf->data));
+    p_buf->state = BUF_FREE;
+}
+
+static page_buf_t *buf_get_free(void) {
+    uint8_t i;
+
+    for (i = 0; i < PAGE_BUF_CNT; ++i) {
+        if (boot.buf[i].state == BUF_FREE) {
+            return &boot.buf[i];
+        }
+    }
+    return NULL;
+}
+
+static page_buf_t *buf_get_ready(void) {
+    uint8_t i;
+
+    for (i = 0; i < PAGE_BUF_CNT; ++i) {
+        if (boot.buf[i].state == BUF_READY) {
+            return &boot.buf[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief one half word per call, so frames are parsed between programming operations.
+ * Erased half words (0xFFFF) are skipped. CPU still stalls on flash fetch while
+ * programming, DMA keeps filling the ring meanwhile.
+ */
+static void prog_step(void) {
+    page_buf_t *p_buf = boot.p_prog;
+    uint32_t addr;
+
+    if (boot_flash_busy()) {
+        return;
+    }
+    if (p_buf == NULL) {
+        p_buf = buf_get_ready();
+        if (p_buf == NULL) {
+            return;
+        }
+        p_buf->state = BUF_PROG;
+        p_buf->prog_off = 0;
+        boot.p_prog = p_buf;
+    } else if (boot_flash_error()) {
+        boot.flash_err = 1;
+    }
+
+    while ((p_buf->prog_off < (BOOT_PAGE_SIZE / 2u)) && (p_buf->data[p_buf->prog_off] == 0xFFFFu)) {
+        p_buf->prog_off++;
+    }
+    if (p_buf->prog_off >= (BOOT_PAGE_SIZE / 2u)) {
+        FLASH->CR = 0;
+        buf_free(p_buf);
+        boot.p_prog = NULL;
+        return;
+    }
+    addr = BOOT_APP_ADDR + ((uint32_t)p_buf->page * BOOT_PAGE_SIZE) + ((uint32_t)p_buf->prog_off * 2u);
+    boot_flash_program_start(addr, p_buf->data[p_buf->prog_off]);
+    p_buf->prog_off++;
+}
+
+static void prog_flush(void) {
+    if (boot.p_fill != NULL) {
+        boot.p_fill->state = BUF_READY;
+        boot.p_fill = NULL;
+    }
+    while ((boot.p_prog != NULL) || (buf_get_ready() != NULL)) {
+        prog_step();
+    }
+}
+
+//=========================================================
+/* frames */
+
+static uint32_t rd_u32(const uint8_t *p_src) {
+    return (uint32_t)p_src[0] | ((uint32_t)p_src[1] << 8) | ((uint32_t)p_src[2] << 16) | ((uint32_t)p_src[3] << 24);
+}
+
+static uint8_t info_program(uint32_t offset, uint32_t val) {
+    return boot_flash_program(BOOT_INFO_ADDR + offset, (uint16_t)val) |
+           boot_flash_program(BOOT_INFO_ADDR + offset + 2u, (uint16_t)(val >> 16));
+}
+
+static uint8_t start_parse(const uint8_t *p_payload) {
+    boot.start.size = rd_u32(&p_payload[0]);
+    boot.start.crc = rd_u32(&p_payload[4]);
+    boot.start.baud = rd_u32(&p_payload[8]);
+    if ((boot.start.size == 0) || (boot.start.size > BOOT_APP_SIZE)) {
+        reply(BOOT_T_ERR, BOOT_ERR_SIZE);
+        return 1;
+    }
+    /* BRR mantissa must be at least 1 */
+    if ((boot.start.baud != 0) && ((boot.start.baud > (BOOT_CORE_CLK / 16u)) || (boot.start.baud < 1200u))) {
+        reply(BOOT_T_ERR, BOOT_ERR_BAUD);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief START and DELTA. Full image: application region is erased here.
+ * Delta: installed image is checked, pages are erased one by one when patched.
+ */
+static void on_start(const uint8_t *p_payload, uint16_t len, uint8_t delta) {
+    uint32_t addr;
+    uint32_t base_size;
+    uint8_t err = 0;
+    uint8_t i;
+
+    boot.started = 0;
+    if (len != (delta ? sizeof(boot_delta_t) : sizeof(boot_start_t))) {
+        reply(BOOT_T_ERR, BOOT_ERR_STATE);
+        return;
+    }
+    prog_flush();
+    if (start_parse(p_payload)) {
+        return;
+    }
+    boot.stream_size = boot.start.size;
+    if (delta) {
+        base_size = rd_u32(&p_payload[12]);
+        if ((base_size > BOOT_APP_SIZE) ||
+            (boot_crc32(0, (const uint8_t *)BOOT_APP_ADDR, base_size) != rd_u32(&p_payload[16]))) {
+            reply(BOOT_T_ERR, BOOT_ERR_BASE);
+            return;
+        }
+        boot.stream_size = rd_u32(&p_payload[20]);
+        if ((boot.stream_size == 0) || (boot.stream_size > (0xFFFFu * BOOT_BLOCK_SIZE))) {
+            reply(BOOT_T_ERR, BOOT_ERR_SIZE);
+            return;
+        }
+    }
+
+    /* info page first: interrupted update is never started as valid application */
+    err |= boot_flash_erase(BOOT_INFO_ADDR);
+    err |= info_program(0, BOOT_INFO_MAGIC);
+    err |= info_program(4, boot.start.size);
+    err |= info_program(8, boot.start.crc);
+    if (!delta) {
+        for (addr = BOOT_APP_ADDR; addr < (BOOT_APP_ADDR + boot.start.size); addr += BOOT_PAGE_SIZE) {
+            err |= boot_flash_erase(addr);
+        }
+    }
+    if (err) {
+        reply(BOOT_T_ERR, BOOT_ERR_FLASH);
+        return;
+    }
+
+    for (i = 0; i < PAGE_BUF_CNT; ++i) {
+        buf_free(&boot.buf[i]);
+    }
+    memset(&patch, 0, sizeof(patch));
+    boot.p_fill = NULL;
+    boot.p_prog = NULL;
+    boot.rx_next = 0;
+    boot.blocks = (uint16_t)((boot.stream_size + BOOT_BLOCK_SIZE - 1u) / BOOT_BLOCK_SIZE);
+    boot.nak_sent = 0;
+    boot.flash_err = 0;
+    boot.delta = delta;
+    boot.started = 1;
+
+    reply(BOOT_T_ACK, 0);
+    if (boot.start.baud != 0) {
+        boot_uart_baud(boot.start.baud);
+    }
+}
+
+//=========================================================
+/* delta */
+
+/**
+ * @brief page is complete: erase and program it before next COPY can read it
+ */
+static void patch_commit(page_buf_t *p_buf, uint16_t page) {
+    uint32_t addr = BOOT_APP_ADDR + ((uint32_t)page * BOOT_PAGE_SIZE);
+    uint16_t i;
+
+    /* unchanged page is not erased */
+    if (memcmp(p_buf->data, (const void *)addr, BOOT_PAGE_SIZE) == 0) {
+        buf_free(p_buf);
+        return;
+    }
+    boot.flash_err |= boot_flash_erase(addr);
+    for (i = 0; i < (BOOT_PAGE_SIZE / 2u); ++i) {
+        if (p_buf->data[i] != 0xFFFFu) {
+            boot.flash_err |= boot_flash_program(addr + (i * 2u), p_buf->data[i]);
+        }
+    }
+    FLASH->CR = 0;
+    buf_free(p_buf);
+}
+
+static void patch_out(uint8_t data) {
+    page_buf_t *p_buf = &boot.buf[0];
+
+    ((uint8_t *)p_buf->data)[patch.out % BOOT_PAGE_SIZE] = data;
+    patch.out++;
+    if (((patch.out % BOOT_PAGE_SIZE) == 0) || (patch.out == boot.start.size)) {
+        patch_commit(p_buf, (uint16_t)((patch.out - 1u) / BOOT_PAGE_SIZE));
+    }
+}
+
+/**
+ * @return 0: ok, 1: malformed patch
+ */
+static uint8_t patch_feed(const uint8_t *p_data, uint16_t len) {
+    uint16_t op_len;
+    uint32_t src;
+
+    while (len != 0) {
+        if (patch.lit_left != 0) {
+            patch_out(*p_data++);
+            len--;
+            patch.lit_left--;
+            continue;
+        }
+        patch.hdr[patch.hdr_cnt++] = *p_data++;
+        len--;
+        if ((patch.hdr[0] != BOOT_OP_COPY) && (patch.hdr[0] != BOOT_OP_LIT)) {
+            return 1;
+        }
+        if (patch.hdr_cnt < ((patch.hdr[0] == BOOT_OP_COPY) ? 5u : 3u)) {
+            continue;
+        }
+        patch.hdr_cnt = 0;
+        op_len = (uint16_t)(patch.hdr[1] | (patch.hdr[2] << 8));
+        if ((op_len == 0) || ((patch.out + op_len) > boot.start.size)) {
+            return 1;
+        }
+        if (patch.hdr[0] == BOOT_OP_LIT) {
+            patch.lit_left = op_len;
+            continue;
+        }
+        src = (uint32_t)(patch.hdr[3] | (patch.hdr[4] << 8));
+        if ((src + op_len) > BOOT_APP_SIZE) {
+            return 1;
+        }
+        while (op_len--) {
+            patch_out(*(const volatile uint8_t *)(BOOT_APP_ADDR + src++));
+        }
+    }
+    return 0;
+}
+
+/**
+ * @return 0 when block can not be taken yet (no free page buffer), frame is kept
+ */
+static uint8_t on_data(uint16_t seq, const uint8_t *p_payload, uint16_t len) {
+    uint32_t offset = (uint32_t)seq * BOOT_BLOCK_SIZE;
+    uint32_t expected;
+    uint16_t page;
+    page_buf_t *p_buf;
+
+    if (!boot.started) {
+        reply(BOOT_T_ERR, BOOT_ERR_STATE);
+        return 1;
+    }
+    if (seq != boot.rx_next) {
+        if (seq < boot.rx_next) {
+            /* retransmitted after lost ACK */
+            reply(BOOT_T_ACK, boot.rx_next);
+        } else {
+            nak_once();
+        }
+        return 1;
+    }
+    expected = boot.stream_size - offset;
+    if (expected > BOOT_BLOCK_SIZE) {
+        expected = BOOT_BLOCK_SIZE;
+    }
+    if ((seq >= boot.blocks) || (len != expected)) {
+        nak_once();
+        return 1;
+    }
+
+    if (boot.delta) {
+        /* pages are committed inside, ring keeps receiving meanwhile */
+        if (patch_feed(p_payload, len)) {
+            boot.started = 0;
+            reply(BOOT_T_ERR, BOOT_ERR_PATCH);
+            return 1;
+        }
+        boot.rx_next++;
+        boot.nak_sent = 0;
+        reply(BOOT_T_ACK, boot.rx_next);
+        return 1;
+    }
+
+    page = (uint16_t)(offset / BOOT_PAGE_SIZE);
+    p_buf = boot.p_fill;
+    if (p_buf == NULL) {
+        p_buf = buf_get_free();
+        if (p_buf == NULL) {
+            return 0;
+        }
+        p_buf->state = BUF_FILL;
+        p_buf->page = page;
+        boot.p_fill = p_buf;
+    }
+    memcpy((uint8_t *)p_buf->data + (offset % BOOT_PAGE_SIZE), p_payload, len);
+    if ((((offset + len) % BOOT_PAGE_SIZE) == 0) || ((offset + len) >= boot.start.size)) {
+        p_buf->state = BUF_READY;
+        boot.p_fill = NULL;
+    }
+
+    boot.rx_next++;
+    boot.nak_sent = 0;
+    reply(BOOT_T_ACK, boot.rx_next);
+    return 1;
+}
+
+static void on_end(void) {
+    uint32_t crc;
+
+    if (!boot.started) {
+        reply(BOOT_T_ERR, BOOT_ERR_STATE);
+        return;
+    }
+    if (boot.rx_next < boot.blocks) {
+        nak_once();
+        return;
+    }
+    prog_flush();
+    boot.started = 0;
+    if (boot.delta && ((patch.out != boot.start.size) || (patch.lit_left != 0) || (patch.hdr_cnt != 0))) {
+        reply(BOOT_T_ERR, BOOT_ERR_PATCH);
+        return;
+    }
+    if (boot.flash_err) {
+        reply(BOOT_T_ERR, BOOT_ERR_FLASH);
+        return;
+    }
+    crc = boot_crc32(0, (const uint8_t *)BOOT_APP_ADDR, boot.start.size);
+    if (crc != boot.start.crc) {
+        reply(BOOT_T_ERR, BOOT_ERR_CRC);
+        return;
+    }
+    if (info_program(12, BOOT_STATE_VALID)) {
+        reply(BOOT_T_ERR, BOOT_ERR_FLASH);
+        return;
+    }
+    reply(BOOT_T_DONE, boot.rx_next);
+    boot_uart_wait_tx();
+    NVIC_SystemReset();
+}
+
+/**
+ * @return 0 when frame has to be processed again later
+ */
+static uint8_t frame_process(void) {
+    uint8_t type = rx.frame[0];
+    uint16_t seq = (uint16_t)(rx.frame[1] | (rx.frame[2] << 8));
+    const uint8_t *p_payload = &rx.frame[BOOT_FRAME_HDR];
+    uint32_t crc = rd_u32(&rx.frame[BOOT_FRAME_HDR + rx.len]);
+
+    if (boot_crc32(0, rx.frame, BOOT_FRAME_HDR + rx.len) != crc) {
+        if (boot.started) {
+            nak_once();
+        }
+        return 1;
+    }
+    switch (type) {
+    case BOOT_T_START:
+        on_start(p_payload, rx.len, 0);
+        break;
+    case BOOT_T_DELTA:
+        on_start(p_payload, rx.len, 1);
+        break;
+    case BOOT_T_DATA:
+        return on_data(seq, p_payload, rx.len);
+    case BOOT_T_END:
+        on_end();
+        break;
+    default:
+        break;
+    }
+    return 1;
+}
+
+static void rx_exe(void) {
+    uint8_t data;
+
+    while ((rx.state != RX_DONE) && (boot_uart_rx_cnt() != 0)) {
+        data = boot_uart_rx_get();
+        switch (rx.state) {
+        case RX_SOF:
+            if (data == BOOT_SOF_HOST) {
+                rx.cnt = 0;
+                rx.state = RX_HDR;
+            }
+            break;
+        case RX_HDR:
+            rx.frame[rx.cnt++] = data;
+            if (rx.cnt == BOOT_FRAME_HDR) {
+                rx.len = (uint16_t)(rx.frame[3] | (rx.frame[4] << 8));
+                /* corrupted length, hunt for next SOF */
+                rx.state = (rx.len > BOOT_BLOCK_SIZE) ? RX_SOF : RX_BODY;
+            }
+            break;
+        case RX_BODY:
+            rx.frame[rx.cnt++] = data;
+            if (rx.cnt == (BOOT_FRAME_HDR + rx.len + 4u)) {
+                rx.state = RX_DONE;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    if ((rx.state == RX_DONE) && frame_process()) {
+        rx.state = RX_SOF;
+    }
+}
+
+//=========================================================
+
+int main(void) {
+    if (!stay_requested() && app_valid()) {
+        app_jump();
+    }
+
+    boot_clock_init();
+    boot_crc32_init();
+    boot_flash_unlock();
+    boot_uart_init(BOOT_BAUD);
+
+    while (1) {
+        rx_exe();
+        prog_step();
+    }
+}
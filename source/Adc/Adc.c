@@ -0,0 +1,339 @@
+/**
+ * @file Adc.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief continuous ADC1 scan over DMA ping-pong buffer, block processing, record stream
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "Adc.h"
+/* dependencies */
+#include <string.h>
+
+#include "main.h"
+#include "CycleCnt.h"
+#include "Crit.h"
+#include "assert_gorenje.h"
+
+#define BUF_LEN         (2u * ADC_SCANS * ADC_CH_CNT)
+#define FRAME_HDR       4u
+#define HDR_LEN         (9u + ADC_CH_CNT)
+#define REC_LEN         (4u + (6u * ADC_CH_CNT))
+#define ADC_CLK_MAX     14000000u
+#define ADC_STAB_US     2u          // power up, tSTAB is 1 us
+
+#define ADC_CH_NUM(name, ch)    ch,
+
+typedef char adc_ch_cnt_check[(ADC_CH_CNT <= ADC_PROC_CH_MAX) ? 1 : -1];
+
+typedef struct _adc_ctrl_t{
+    serial_ctrl_desc_t  *p_serial;
+    uint32_t            last_cycles;    // elapsed is accumulated up to here
+    uint32_t            adc_clk;
+    uint16_t            conv_x2;    // conversion time in half ADC clocks
+    uint16_t            decim;
+    uint8_t             run_F;
+    uint8_t             last_F;
+    uint8_t             hdr_F;      // header frame pending
+    uint8_t             end_F;      // end frame pending
+    uint8_t             seq;
+}adc_ctrl_t;
+
+static uint8_t              start   (serial_ctrl_desc_t *p_serial, adc_smp_t smp, uint16_t decim);
+static void                 stop    (void);
+static uint8_t              last    (adc_rec_t *p_rec);
+static const adc_stats_t    *stats  (void);
+static uint8_t              exe     (void);
+
+//=========================================================
+/* create needed object  */
+static const uint8_t adc_ch_num[ADC_CH_CNT] = { ADC_CHANNELS(ADC_CH_NUM) };
+/* sample time + 12.5 ADC clocks, in half clocks, by SMPx code */
+static const uint16_t adc_conv_x2[8] = { 28, 40, 52, 82, 108, 136, 168, 504 };
+
+static uint16_t adc_buf[BUF_LEN];
+static adc_rec_t adc_out[ADC_OUT_CNT];
+static volatile uint8_t adc_head;       // written by DMA interrupt only
+static volatile uint8_t adc_tail;       // written by main loop only
+
+static adc_ctrl_t adc;
+static adc_proc_t adc_proc;
+static adc_rec_t adc_last;
+static adc_stats_t adc_stats;
+
+const Adc_methods_t Adc = {
+    &start,
+    &stop,
+    &last,
+    &stats,
+    &exe
+};
+//=========================================================
+
+/* constructor */
+void Adc_init(void) {
+    CycleCnt_init();
+    adc.p_serial = NULL;
+    adc.run_F = 0;
+    adc.last_F = 0;
+}
+
+/**
+ * @brief record completed by processing stage, DMA interrupt context
+ */
+static void record(const adc_rec_t *p_rec) {
+    uint8_t head = adc_head;
+
+    adc_last = *p_rec;
+    adc.last_F = 1;
+    adc_stats.records++;
+    if (adc.p_serial == NULL) {
+        return;
+    }
+    if ((uint8_t)(head - adc_tail) >= ADC_OUT_CNT) {
+        adc_stats.drops++;
+        return;
+    }
+    adc_out[head & (ADC_OUT_CNT - 1u)] = *p_rec;
+    /* record is written before consumer can see it */
+    __DMB();
+    adc_head = (uint8_t)(head + 1u);
+}
+
+/* 32 bit cycle counter wraps after 59 s at 72 MHz, interrupts and readers add short spans */
+static void elapsed_add(uint32_t cycles) {
+    adc_stats.elapsed += cycles - adc.last_cycles;
+    adc.last_cycles = cycles;
+}
+
+void DMA1_Channel1_IRQHandler(void) {
+    uint32_t start_cycles = CycleCnt_get();
+    uint32_t isr = DMA1->ISR & (DMA_ISR_HTIF1 | DMA_ISR_TCIF1);
+    const uint16_t *p_half;
+
+    elapsed_add(start_cycles);
+    DMA1->IFCR = DMA_IFCR_CGIF1;
+    if (isr == (DMA_ISR_HTIF1 | DMA_ISR_TCIF1)) {
+        /* both halves completed since last time, one of them was overwritten */
+        adc_stats.overruns++;
+    }
+    /* half DMA is not writing into */
+    p_half = (ADC_DMA->CNDTR > (BUF_LEN / 2u)) ? &adc_buf[BUF_LEN / 2u] : adc_buf;
+    Adc_proc_block(&adc_proc, p_half, ADC_SCANS, &record);
+    adc_stats.blocks++;
+
+    adc_stats.busy += (CycleCnt_get() - start_cycles) + ADC_ISR_OVERHEAD;
+}
+
+static void delay_us(uint32_t us) {
+    uint32_t start_cycles = CycleCnt_get();
+    uint32_t cycles = (SystemCoreClock / 1000000u) * us;
+
+    while ((CycleCnt_get() - start_cycles) < cycles) {
+    }
+}
+
+/**
+ * @brief ADC clock from PCLK2, lowest prescaler within ADC_CLK_MAX
+ */
+static uint32_t adc_clock(void) {
+    static const uint32_t pre[4] = { RCC_CFGR_ADCPRE_DIV2, RCC_CFGR_ADCPRE_DIV4,
+                                     RCC_CFGR_ADCPRE_DIV6, RCC_CFGR_ADCPRE_DIV8 };
+    uint32_t pclk2 = HAL_RCC_GetPCLK2Freq();
+    uint8_t i = 0;
+
+    while ( (i < 3u) && ((pclk2 / (2u * (i + 1u))) > ADC_CLK_MAX) ) {
+        i++;
+    }
+    MODIFY_REG(RCC->CFGR, RCC_CFGR_ADCPRE, pre[i]);
+    return pclk2 / (2u * (i + 1u));
+}
+
+static void frame_write(uint8_t type, const uint8_t *p_data, uint8_t len) {
+    uint8_t hdr[FRAME_HDR] = { 'A', type, len, adc.seq++ };
+
+    Serial.write(adc.p_serial, hdr, FRAME_HDR);
+    Serial.write(adc.p_serial, (uint8_t *)p_data, len);
+}
+
+//=========================================================
+/* methods implementation */
+
+static uint8_t start(serial_ctrl_desc_t *p_serial, adc_smp_t smp, uint16_t decim) {
+    GPIO_InitTypeDef gpio_init = { 0 };
+    uint32_t sqr[3] = { 0 };
+    uint32_t smp_all;
+    uint8_t i;
+
+    assert(smp <= ADC_SMP_239);
+
+    stop();
+    if (adc.end_F != 0) {
+        /* previous end frame is not sent yet */
+        return 0;
+    }
+    if (decim == 0) {
+        decim = ADC_DECIM_DEFAULT;
+    }
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_ADC1_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    gpio_init.Mode = GPIO_MODE_ANALOG;
+    for (i = 0; i < ADC_CH_CNT; ++i) {
+        /* channels 0 .. 7 are PA0 .. PA7, 8 and 9 are PB0 and PB1, 16 and 17 internal */
+        if (adc_ch_num[i] < 8u) {
+            gpio_init.Pin = (uint32_t)1u << adc_ch_num[i];
+            HAL_GPIO_Init(GPIOA, &gpio_init);
+        } else if (adc_ch_num[i] < 10u) {
+            gpio_init.Pin = (uint32_t)1u << (adc_ch_num[i] - 8u);
+            HAL_GPIO_Init(GPIOB, &gpio_init);
+        }
+        sqr[i / 6u] |= (uint32_t)adc_ch_num[i] << (5u * (i % 6u));
+    }
+
+    adc_stats = (adc_stats_t){ 0 };
+    adc.p_serial = p_serial;
+    adc.adc_clk = adc_clock();
+    adc.conv_x2 = adc_conv_x2[smp];
+    adc.decim = decim;
+    adc.seq = 0;
+    adc.hdr_F = (uint8_t)(p_serial != NULL);
+    adc.last_F = 0;
+    adc_head = 0;
+    adc_tail = 0;
+    adc_stats.rate = (2u * adc.adc_clk) / adc.conv_x2;
+    Adc_proc_init(&adc_proc, ADC_CH_CNT, decim);
+
+    /* power up and calibrate */
+    ADC1->CR2 = ADC_CR2_ADON;
+    delay_us(ADC_STAB_US);
+    ADC1->CR2 |= ADC_CR2_RSTCAL;
+    while ((ADC1->CR2 & ADC_CR2_RSTCAL) != 0) {
+    }
+    ADC1->CR2 |= ADC_CR2_CAL;
+    while ((ADC1->CR2 & ADC_CR2_CAL) != 0) {
+    }
+
+    /* same sample time on every channel, 3 bits each */
+    smp_all = (uint32_t)smp * 0x09249249u;
+    ADC1->SMPR1 = smp_all & 0x00FFFFFFu;
+    ADC1->SMPR2 = smp_all & 0x3FFFFFFFu;
+    ADC1->SQR3 = sqr[0];
+    ADC1->SQR2 = sqr[1];
+    ADC1->SQR1 = sqr[2] | ((uint32_t)(ADC_CH_CNT - 1u) << ADC_SQR1_L_Pos);
+    ADC1->CR1 = ADC_CR1_SCAN;
+
+    ADC_DMA->CCR = 0;
+    DMA1->IFCR = DMA_IFCR_CGIF1;
+    ADC_DMA->CPAR = (uint32_t)&ADC1->DR;
+    ADC_DMA->CMAR = (uint32_t)adc_buf;
+    ADC_DMA->CNDTR = BUF_LEN;
+    ADC_DMA->CCR = DMA_CCR_PSIZE_0 | DMA_CCR_MSIZE_0 | DMA_CCR_MINC | DMA_CCR_CIRC |
+                   DMA_CCR_HTIE | DMA_CCR_TCIE | DMA_CCR_EN;
+
+    NVIC_SetPriority(ADC_IRQn, ADC_IRQ_PRIO);
+    NVIC_ClearPendingIRQ(ADC_IRQn);
+    NVIC_EnableIRQ(ADC_IRQn);
+
+    /* software trigger, continuous scan from here on */
+    ADC1->CR2 = ADC_CR2_ADON | ADC_CR2_CONT | ADC_CR2_DMA | ADC_CR2_TSVREFE |
+                ADC_CR2_EXTSEL | ADC_CR2_EXTTRIG;
+    adc.last_cycles = CycleCnt_get();
+    adc.run_F = 1;
+    ADC1->CR2 |= ADC_CR2_SWSTART;
+    return 1;
+}
+
+static void stop(void) {
+    if (adc.run_F == 0) {
+        return;
+    }
+    /* power down, partial half buffer is dropped */
+    ADC1->CR2 = 0;
+    NVIC_DisableIRQ(ADC_IRQn);
+    ADC_DMA->CCR = 0;
+    DMA1->IFCR = DMA_IFCR_CGIF1;
+
+    elapsed_add(CycleCnt_get());
+    adc.run_F = 0;
+    adc.end_F = (uint8_t)(adc.p_serial != NULL);
+}
+
+static uint8_t last(adc_rec_t *p_rec) {
+    crit_state_t primask;
+    uint8_t valid;
+
+    assert(p_rec != NULL);
+
+    primask = Crit_enter();
+    *p_rec = adc_last;
+    valid = adc.last_F;
+    Crit_exit(primask);
+    return valid;
+}
+
+static const adc_stats_t *stats(void) {
+    crit_state_t basepri;
+
+    if (adc.run_F != 0) {
+        basepri = Crit_enter_prio(ADC_IRQ_PRIO);
+        elapsed_add(CycleCnt_get());
+        Crit_exit_prio(basepri);
+    }
+    return &adc_stats;
+}
+
+static uint8_t exe(void) {
+    serial_ctrl_desc_t *p_serial = adc.p_serial;
+    uint8_t hdr[HDR_LEN];
+    uint8_t tail = adc_tail;
+
+    if (p_serial == NULL) {
+        return 0;
+    }
+    if (adc.hdr_F != 0) {
+        if (Serial.Tx_free(p_serial) < (FRAME_HDR + HDR_LEN)) {
+            return 1;
+        }
+        hdr[0] = (uint8_t)adc.adc_clk;
+        hdr[1] = (uint8_t)(adc.adc_clk >> 8);
+        hdr[2] = (uint8_t)(adc.adc_clk >> 16);
+        hdr[3] = (uint8_t)(adc.adc_clk >> 24);
+        hdr[4] = (uint8_t)adc.conv_x2;
+        hdr[5] = (uint8_t)(adc.conv_x2 >> 8);
+        hdr[6] = (uint8_t)adc.decim;
+        hdr[7] = (uint8_t)(adc.decim >> 8);
+        hdr[8] = ADC_CH_CNT;
+        memcpy(&hdr[9], adc_ch_num, ADC_CH_CNT);
+        frame_write('H', hdr, HDR_LEN);
+        adc.hdr_F = 0;
+    }
+
+    /* whole frames only, shell output may go between them */
+    while ( (tail != adc_head) && (Serial.Tx_free(p_serial) >= (FRAME_HDR + REC_LEN)) ) {
+        /* seq, scans and channels are packed uint16, first REC_LEN bytes of the record */
+        frame_write('R', (const uint8_t *)&adc_out[tail & (ADC_OUT_CNT - 1u)], REC_LEN);
+        /* record is copied before producer can reuse it */
+        __DMB();
+        tail = (uint8_t)(tail + 1u);
+        adc_tail = tail;
+    }
+    if (tail != adc_head) {
+        return 1;
+    }
+
+    if (adc.end_F != 0) {
+        if (Serial.Tx_free(p_serial) < (FRAME_HDR + sizeof(adc_stats_t))) {
+            return 1;
+        }
+        frame_write('E', (const uint8_t *)&adc_stats, sizeof(adc_stats_t));
+        adc.end_F = 0;
+        adc.p_serial = NULL;
+        return 0;
+    }
+    return 1;
+}
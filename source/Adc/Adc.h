@@ -0,0 +1,107 @@
+/**
+ * @file Adc.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief continuous multi channel acquisition. ADC1 scans ADC_CHANNELS in continuous mode,
+ * DMA1 channel 1 moves every conversion into a circular ping-pong buffer of ADC_SCANS
+ * scans per half. Half and full transfer interrupt hands the finished half to the block
+ * processing stage (Adc_proc.h: mean, min, max per channel over decim scans), completed
+ * records are queued and streamed over serial by the main loop.
+ *
+ * No timer is left for a trigger, sample rate is set by ADC clock (PCLK2 / 2) and sample
+ * time: one conversion takes sample time + 12.5 ADC clocks. Temperature sensor needs
+ * 17.1 us sample time, only ADC_SMP_239 gives valid readings for it.
+ *
+ * Stream (little endian), every frame: 'A', type, len (uint8), seq (uint8), len bytes
+ *  - 'H' header: ADC clock (uint32), conversion time in half ADC clocks (uint16),
+ *    decim (uint16), nch (uint8), channel numbers (nch x uint8)
+ *  - 'R' record: seq (uint16), scans (uint16), mean, min, max per channel (uint16 each)
+ *  - 'E' end: adc_stats_t (2 x uint64, 5 x uint32, 4 bytes padding)
+ * Record queue full drops the record (seq shows it), processing more than half a buffer
+ * late is an overrun. tools/adc/adc_capture.py starts acquisition and writes CSV.
+ * Shell command "adc", benchmark: source/Adc/test, host build: tools/adc/adc_bench.c.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef ADC_H
+#define ADC_H
+
+#include <stdint.h>
+
+#include "Serial.h"
+#include "Adc_proc.h"
+
+/**
+ * @brief scan list, in scan order: X(name, ADC channel). PA0/PA1 are source/Latency pins
+ */
+#define ADC_CHANNELS(X) \
+    X(PA4,  4)          \
+    X(PA5,  5)          \
+    X(PB1,  9)          \
+    X(TEMP, 16)         \
+    X(VREF, 17)
+
+#define ADC_DMA             DMA1_Channel1
+#define ADC_IRQn            DMA1_Channel1_IRQn
+#define ADC_IRQ_PRIO        2u                  // below Timebase, like other DMA streams
+
+#define ADC_SCANS           32u                 // scans per half buffer
+#define ADC_OUT_CNT         8u                  // record queue, power of 2
+#define ADC_DECIM_DEFAULT   1000u
+
+/* exception entry and exit, not seen by cycle counter in handler */
+#define ADC_ISR_OVERHEAD    24u
+
+#define ADC_CH_ENUM(name, ch)   ADC_CH_##name,
+typedef enum _adc_ch_t{
+    ADC_CHANNELS(ADC_CH_ENUM)
+    ADC_CH_CNT
+}adc_ch_t;
+
+/**
+ * @brief sample time in ADC clocks, SMPx register code
+ */
+typedef enum _adc_smp_t{
+    ADC_SMP_1 = 0,      // 1.5
+    ADC_SMP_7,          // 7.5
+    ADC_SMP_13,         // 13.5
+    ADC_SMP_28,         // 28.5
+    ADC_SMP_41,         // 41.5
+    ADC_SMP_55,         // 55.5
+    ADC_SMP_71,         // 71.5
+    ADC_SMP_239         // 239.5
+}adc_smp_t;
+
+typedef struct _adc_stats_t{
+    uint64_t    busy;       // cycles in DMA interrupt
+    uint64_t    elapsed;    // cycles while running, accumulated per block, does not wrap
+    uint32_t    rate;       // conversions per second, all channels
+    uint32_t    blocks;     // half buffers processed
+    uint32_t    records;
+    uint32_t    drops;      // records lost to full queue
+    uint32_t    overruns;   // half buffers overwritten before processed
+}adc_stats_t;
+
+/**
+ * @brief struct of all available methods of this module
+ */
+typedef struct _Adc_methods_t{
+    /* decim 0: ADC_DECIM_DEFAULT. p_serial NULL only processes and counts, records can
+       still be read with last(). Returns 0 when end frame of previous stream is not sent yet */
+    uint8_t             (*start)    (serial_ctrl_desc_t *p_serial, adc_smp_t smp, uint16_t decim);
+    void                (*stop)     (void);
+    uint8_t             (*last)     (adc_rec_t *p_rec);     // 0 before first record
+    const adc_stats_t   *(*stats)   (void);
+    uint8_t             (*exe)      (void);     // call from main loop, returns 1 while streaming
+}Adc_methods_t;
+
+extern const Adc_methods_t Adc;
+
+/**
+ * @brief acquisition stopped, ADC1 powered down
+ */
+void Adc_init(void);
+
+#endif /* ADC_H */
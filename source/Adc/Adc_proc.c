@@ -0,0 +1,107 @@
+/**
+ * @file Adc_proc.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief block decimation with mean, min and max per channel
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "Adc_proc.h"
+/* dependencies */
+#include <stddef.h>
+
+#include "assert_gorenje.h"
+
+static void clear(adc_proc_t *p_proc) {
+    uint8_t ch;
+
+    for (ch = 0; ch < p_proc->nch; ++ch) {
+        p_proc->sum[ch] = 0;
+        p_proc->min[ch] = 0xFFFFu;
+        p_proc->max[ch] = 0;
+    }
+    p_proc->cnt = 0;
+}
+
+static void publish(adc_proc_t *p_proc, adc_rec_cb_t p_cb) {
+    uint32_t cnt = p_proc->cnt;
+    uint8_t ch;
+
+    for (ch = 0; ch < p_proc->nch; ++ch) {
+        p_proc->rec.ch[ch].mean = (uint16_t)((p_proc->sum[ch] + (cnt / 2u)) / cnt);
+        p_proc->rec.ch[ch].min = p_proc->min[ch];
+        p_proc->rec.ch[ch].max = p_proc->max[ch];
+    }
+    p_proc->rec.scans = p_proc->cnt;
+    if (p_cb != NULL) {
+        p_cb(&p_proc->rec);
+    }
+    p_proc->rec.seq++;
+    clear(p_proc);
+}
+
+/**
+ * @brief scans that all go into the current record
+ */
+static void accumulate(adc_proc_t *p_proc, const uint16_t *p_samples, uint16_t scans) {
+    const uint16_t *p_s;
+    uint32_t sum;
+    uint16_t min;
+    uint16_t max;
+    uint16_t v;
+    uint16_t k;
+    uint8_t nch = p_proc->nch;
+    uint8_t ch;
+
+    for (ch = 0; ch < nch; ++ch) {
+        p_s = &p_samples[ch];
+        sum = p_proc->sum[ch];
+        min = p_proc->min[ch];
+        max = p_proc->max[ch];
+        for (k = 0; k < scans; ++k) {
+            v = *p_s;
+            p_s += nch;
+            sum += v;
+            if (v < min) {
+                min = v;
+            }
+            if (v > max) {
+                max = v;
+            }
+        }
+        p_proc->sum[ch] = sum;
+        p_proc->min[ch] = min;
+        p_proc->max[ch] = max;
+    }
+    p_proc->cnt = (uint16_t)(p_proc->cnt + scans);
+}
+
+void Adc_proc_init(adc_proc_t *p_proc, uint8_t nch, uint16_t decim) {
+    assert( (nch != 0) && (nch <= ADC_PROC_CH_MAX) );
+    assert(decim != 0);
+
+    p_proc->nch = nch;
+    p_proc->decim = decim;
+    p_proc->rec.seq = 0;
+    clear(p_proc);
+}
+
+void Adc_proc_block(adc_proc_t *p_proc, const uint16_t *p_samples, uint16_t scans,
+                    adc_rec_cb_t p_cb) {
+    uint16_t chunk;
+
+    while (scans != 0) {
+        chunk = (uint16_t)(p_proc->decim - p_proc->cnt);
+        if (chunk > scans) {
+            chunk = scans;
+        }
+        accumulate(p_proc, p_samples, chunk);
+        p_samples += (uint32_t)chunk * p_proc->nch;
+        scans = (uint16_t)(scans - chunk);
+        if (p_proc->cnt == p_proc->decim) {
+            publish(p_proc, p_cb);
+        }
+    }
+}
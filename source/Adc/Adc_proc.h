@@ -0,0 +1,65 @@
+/**
+ * @file Adc_proc.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief block processing stage of source/Adc, no hardware dependencies (host build:
+ * tools/adc/adc_bench.c). Input is a block of interleaved scans (one sample per channel,
+ * channel order of the scan), output is one record per decim scans: mean, min and max of
+ * every channel. Records do not have to line up with blocks, accumulators carry over.
+ *
+ * Channels are walked one at a time with stride nch, so sum, min and max of the channel
+ * stay in registers for the whole block.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef ADC_PROC_H
+#define ADC_PROC_H
+
+#include <stdint.h>
+
+#define ADC_PROC_CH_MAX     8u
+/* sum of 12 bit samples fits uint32_t up to 2^20 scans */
+#define ADC_PROC_DECIM_MAX  0xFFFFu
+
+typedef struct _adc_ch_stat_t{
+    uint16_t    mean;       // rounded
+    uint16_t    min;
+    uint16_t    max;
+}adc_ch_stat_t;
+
+typedef struct _adc_rec_t{
+    uint16_t        seq;    // wraps, gaps show dropped records
+    uint16_t        scans;  // averaged in this record
+    adc_ch_stat_t   ch[ADC_PROC_CH_MAX];    // only nch are valid
+}adc_rec_t;
+
+typedef void (*adc_rec_cb_t)(const adc_rec_t *p_rec);
+
+typedef struct _adc_proc_t{
+    uint32_t    sum[ADC_PROC_CH_MAX];
+    uint16_t    min[ADC_PROC_CH_MAX];
+    uint16_t    max[ADC_PROC_CH_MAX];
+    uint16_t    cnt;        // scans accumulated
+    uint16_t    decim;
+    uint8_t     nch;
+    adc_rec_t   rec;        // passed to callback
+}adc_proc_t;
+
+/**
+ * @brief reset accumulators and record sequence
+ * @param nch           : channels per scan, 1 .. ADC_PROC_CH_MAX
+ * @param decim         : scans per record, 1 .. ADC_PROC_DECIM_MAX
+ */
+void Adc_proc_init(adc_proc_t *p_proc, uint8_t nch, uint16_t decim);
+
+/**
+ * @brief accumulate block, call p_cb for every completed record (from caller context,
+ * record is only valid during the call)
+ * @param p_samples     : scans * nch samples, interleaved
+ */
+void Adc_proc_block(adc_proc_t *p_proc, const uint16_t *p_samples, uint16_t scans,
+                    adc_rec_cb_t p_cb);
+
+#endif /* ADC_PROC_H */
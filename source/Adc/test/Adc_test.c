@@ -0,0 +1,56 @@
+#include "Adc_test.h"
+#include "Adc.h"
+#include "Serial.h"
+#include "Shell.h"
+#include "stm32f1xx_hal.h"
+
+static void run(adc_smp_t smp) {
+    const adc_stats_t *p_stats;
+    adc_rec_t rec;
+    uint32_t samples;
+    uint32_t start;
+    uint8_t ch;
+
+    if (Adc.start(NULL, smp, ADC_TEST_DECIM) == 0) {
+        Shell_print(&serial_0, "adc busy, end frame of previous stream not sent yet\r\n");
+        return;
+    }
+    start = HAL_GetTick();
+    while ((HAL_GetTick() - start) < ADC_TEST_MS) {
+    }
+    Adc.stop();
+
+    p_stats = Adc.stats();
+    samples = p_stats->blocks * ADC_SCANS * ADC_CH_CNT;
+    Shell_print_u32(&serial_0, smp);
+    Shell_print(&serial_0, " ");
+    Shell_print_u32(&serial_0, p_stats->rate);
+    Shell_print(&serial_0, " ");
+    Shell_print_u32(&serial_0, (p_stats->elapsed != 0) ?
+                    (uint32_t)(((uint64_t)p_stats->busy * 1000u) / p_stats->elapsed) : 0);
+    Shell_print(&serial_0, " ");
+    Shell_print_u32(&serial_0, (samples != 0) ? (uint32_t)(((uint64_t)p_stats->busy * 10u) / samples) : 0);
+    Shell_print(&serial_0, " ");
+    Shell_print_u32(&serial_0, p_stats->overruns);
+    if (Adc.last(&rec) != 0) {
+        for (ch = 0; ch < ADC_CH_CNT; ++ch) {
+            Shell_print(&serial_0, " ");
+            Shell_print_u32(&serial_0, rec.ch[ch].mean);
+        }
+    }
+    Shell_print(&serial_0, "\r\n");
+}
+
+void adc_test_run(void) {
+    uint8_t smp;
+
+    Shell_print(&serial_0, "\r\nADC benchmark, core clock ");
+    Shell_print_u32(&serial_0, SystemCoreClock / 1000000u);
+    Shell_print(&serial_0, " MHz, ");
+    Shell_print_u32(&serial_0, ADC_CH_CNT);
+    Shell_print(&serial_0, " channels\r\n");
+    Shell_print(&serial_0, "smp, conversions/s, load permille, cycles per sample x10, overruns, means\r\n");
+    for (smp = ADC_SMP_1; smp <= ADC_SMP_239; ++smp) {
+        run((adc_smp_t)smp);
+    }
+}
@@ -0,0 +1,29 @@
+/**
+ * @file Adc_test.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief sustained rate and CPU load of source/Adc. Acquisition runs at every sample time
+ * for ADC_TEST_MS with output discarded (no link), so only conversion, DMA and block
+ * processing are measured. Reports conversion rate, load, processing cycles per sample,
+ * overruns and means of the last record (ADC counts).
+ *
+ * Load is DMA interrupt time over run time, DMA bus cycles are not included. Fastest
+ * setting shows the highest sample rate the processing stage keeps up with: no overruns.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef ADC_TEST_H
+#define ADC_TEST_H
+
+#define ADC_TEST_MS         200u
+#define ADC_TEST_DECIM      100u
+
+/**
+ * @brief run benchmark once and print result over serial_0. Serial must be initialized,
+ * acquisition stopped.
+ */
+void adc_test_run(void);
+
+#endif /* ADC_TEST_H */
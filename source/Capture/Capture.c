@@ -0,0 +1,374 @@
+/**
+ * @file Capture.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief timer input capture to DMA ring buffers, period and duty statistics
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "Capture.h"
+/* dependencies */
+#include "Timebase.h"
+#include "CycleCnt.h"
+#include "Crit.h"
+#include "Shell.h"
+#include "TimOwner.h"
+#include "assert_gorenje.h"
+
+#define BUF_MSK         (CAPTURE_BUF_SIZE - 1u)
+
+typedef struct _capture_ctrl_t{
+    uint32_t            rise_total;     // captures written by DMA since restart
+    uint32_t            fall_total;
+    uint32_t            rise_rd;        // next rising capture for periods
+    uint32_t            pair_rd;        // next rising capture for high time
+    uint32_t            flush_total;    // rise_total at last flush
+    uint16_t            rise_wr;        // DMA position at last processing
+    uint16_t            fall_wr;
+    uint16_t            last_rise;
+    uint16_t            flush_us;       // one timer wrap, at most 0xFFFF
+    uint8_t             prev_F;         // last_rise is valid
+    uint8_t             align_F;        // falling capture offset not known yet
+    uint8_t             fall_ofs;       // 1: first capture after restart was falling
+    uint8_t             run_F;
+    uint32_t            wrap_us;        // one timer wrap
+    uint32_t            idle_us;        // flush periods without rising edge
+    uint32_t            batch_start;    // Timebase us
+    uint32_t            batch_cycles;
+    capture_result_t    batch;          // being collected
+    capture_result_t    result;         // last published
+    serial_ctrl_desc_t  *p_stream;
+    uint32_t            stream_seq;
+}capture_ctrl_t;
+
+static uint8_t  start   (uint16_t psc);
+static void     stop    (void);
+static uint32_t result  (capture_result_t *p_result);
+static void     stream  (serial_ctrl_desc_t *p_serial);
+static void     exe     (void);
+
+//=========================================================
+/* create needed object  */
+static uint16_t capture_rise[CAPTURE_BUF_SIZE];
+static uint16_t capture_fall[CAPTURE_BUF_SIZE];
+static capture_ctrl_t cap;
+static const char cap_owner[] = "cap";
+
+const Capture_methods_t Capture = {
+    &start,
+    &stop,
+    &result,
+    &stream,
+    &exe
+};
+//=========================================================
+
+/* constructor */
+void Capture_init(void) {
+    CycleCnt_init();
+    stop();
+    cap.p_stream = NULL;
+}
+
+static void batch_clear(void) {
+    uint32_t tim_clk = cap.batch.tim_clk;
+    uint32_t restarts = cap.batch.restarts;
+
+    cap.batch = (capture_result_t){ 0 };
+    cap.batch.tim_clk = tim_clk;
+    cap.batch.restarts = restarts;
+    cap.batch.min = 0xFFFFu;
+}
+
+/**
+ * @brief rewind both DMA rings to the start, next capture is the first one
+ */
+static void restart(void) {
+    CAPTURE_TIM->CCER = 0;
+    CAPTURE_TIM->DIER = 0;
+    CAPTURE_DMA_RISE->CCR &= ~DMA_CCR_EN;
+    CAPTURE_DMA_FALL->CCR &= ~DMA_CCR_EN;
+    CAPTURE_DMA_RISE->CNDTR = CAPTURE_BUF_SIZE;
+    CAPTURE_DMA_FALL->CNDTR = CAPTURE_BUF_SIZE;
+    DMA1->IFCR = DMA_IFCR_CGIF2 | DMA_IFCR_CGIF3;
+    CAPTURE_DMA_RISE->CCR |= DMA_CCR_EN;
+    CAPTURE_DMA_FALL->CCR |= DMA_CCR_EN;
+
+    cap.rise_total = 0;
+    cap.fall_total = 0;
+    cap.rise_rd = 0;
+    cap.pair_rd = 0;
+    cap.flush_total = 0;
+    cap.idle_us = 0;
+    cap.rise_wr = 0;
+    cap.fall_wr = 0;
+    cap.prev_F = 0;
+    cap.align_F = 1;
+
+    CAPTURE_TIM->SR = 0;
+    CAPTURE_TIM->DIER = TIM_DIER_CC3DE | TIM_DIER_CC4DE;
+    /* IC4 on falling edge */
+    CAPTURE_TIM->CCER = TIM_CCER_CC3E | TIM_CCER_CC4E | TIM_CCER_CC4P;
+}
+
+static void periods(void) {
+    uint16_t rise;
+    uint16_t period;
+
+    while (cap.rise_rd != cap.rise_total) {
+        rise = capture_rise[cap.rise_rd & BUF_MSK];
+        if (cap.prev_F != 0) {
+            period = (uint16_t)(rise - cap.last_rise);
+            cap.batch.periods++;
+            cap.batch.sum += period;
+            if (period < cap.batch.min) {
+                cap.batch.min = period;
+            }
+            if (period > cap.batch.max) {
+                cap.batch.max = period;
+            }
+        }
+        cap.last_rise = rise;
+        cap.prev_F = 1;
+        cap.rise_rd++;
+    }
+}
+
+static void high_times(void) {
+    uint16_t high;
+
+    if (cap.align_F != 0) {
+        if ( (cap.rise_total < 2u) || (cap.fall_total < 1u) ) {
+            return;
+        }
+        /* falling capture before first rising one wraps to more than a period */
+        high = (uint16_t)(capture_fall[0] - capture_rise[0]);
+        cap.fall_ofs = (high < (uint16_t)(capture_rise[1] - capture_rise[0])) ? 0u : 1u;
+        cap.align_F = 0;
+    }
+    while ( (cap.pair_rd < cap.rise_total) && ((cap.pair_rd + cap.fall_ofs) < cap.fall_total) ) {
+        high = (uint16_t)(capture_fall[(cap.pair_rd + cap.fall_ofs) & BUF_MSK] - capture_rise[cap.pair_rd & BUF_MSK]);
+        cap.batch.high_cnt++;
+        cap.batch.high_sum += high;
+        cap.pair_rd++;
+    }
+}
+
+static void batch_check(void) {
+    uint32_t now = Timebase.now();
+    uint32_t cycles;
+
+    if ((now - cap.batch_start) < (CAPTURE_BATCH_MS * 1000u)) {
+        return;
+    }
+    cycles = CycleCnt_get();
+    cap.batch.elapsed = cycles - cap.batch_cycles;
+    cap.batch.seq = cap.result.seq + 1u;
+    cap.result = cap.batch;
+    batch_clear();
+    cap.batch_start = now;
+    cap.batch_cycles = cycles;
+}
+
+/**
+ * @brief consume new captures, DMA interrupt and flush deadline (same priority)
+ */
+static void process(void) {
+    uint32_t start_cycles = CycleCnt_get();
+    uint32_t isr = DMA1->ISR;
+    uint16_t wr;
+
+    DMA1->IFCR = DMA_IFCR_CGIF2;
+    if ( ((isr & (DMA_ISR_HTIF2 | DMA_ISR_TCIF2)) == (DMA_ISR_HTIF2 | DMA_ISR_TCIF2))
+         || ((CAPTURE_TIM->SR & (TIM_SR_CC3OF | TIM_SR_CC4OF)) != 0) ) {
+        /* half buffer late or DMA missed a capture, ring content is not consistent */
+        cap.batch.restarts++;
+        restart();
+    } else {
+        wr = (uint16_t)(CAPTURE_BUF_SIZE - CAPTURE_DMA_RISE->CNDTR);
+        cap.rise_total += (uint16_t)(wr - cap.rise_wr) & BUF_MSK;
+        cap.rise_wr = wr;
+        wr = (uint16_t)(CAPTURE_BUF_SIZE - CAPTURE_DMA_FALL->CNDTR);
+        cap.fall_total += (uint16_t)(wr - cap.fall_wr) & BUF_MSK;
+        cap.fall_wr = wr;
+        periods();
+        high_times();
+    }
+    batch_check();
+    cap.batch.busy += (CycleCnt_get() - start_cycles) + CAPTURE_ISR_OVERHEAD;
+}
+
+void DMA1_Channel2_IRQHandler(void) {
+    process();
+}
+
+/**
+ * @brief Timebase deadline once per timer wrap, several per wrap when it is longer than
+ * deadline range
+ */
+static void flush_cb(void) {
+    Timebase.deadline(TIMEBASE_CH_CAPTURE, cap.flush_us, &flush_cb);
+    process();
+    if (cap.rise_total != cap.flush_total) {
+        cap.idle_us = 0;
+    } else if (cap.prev_F != 0) {
+        cap.idle_us += cap.flush_us;
+        /* no rising edge for a whole wrap, next period would be taken modulo wrap */
+        if (cap.idle_us >= cap.wrap_us) {
+            cap.batch.restarts++;
+            restart();
+        }
+    }
+    cap.flush_total = cap.rise_total;
+}
+
+//=========================================================
+/* methods implementation */
+
+static uint8_t start(uint16_t psc) {
+    GPIO_InitTypeDef gpio_init = {0};
+    uint32_t tim_clk;
+    uint32_t wrap_us;
+
+    stop();
+    if (TimOwner_claim(CAPTURE_TIM, cap_owner) == 0) {
+        return 0;
+    }
+
+    /* timer clock is 2x PCLK1 when APB1 is divided */
+    tim_clk = HAL_RCC_GetPCLK1Freq();
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+        tim_clk *= 2u;
+    }
+    wrap_us = (uint32_t)(((uint64_t)65536u * (psc + 1u) * 1000000u) / tim_clk);
+    cap.wrap_us = wrap_us;
+    cap.flush_us = (wrap_us > 0xFFFFu) ? 0xFFFFu : (uint16_t)wrap_us;
+
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_TIM3_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    gpio_init.Pin = GPIO_PIN_0;
+    gpio_init.Mode = GPIO_MODE_INPUT;
+    gpio_init.Pull = GPIO_NOPULL;
+    HAL_GPIO_Init(GPIOB, &gpio_init);
+
+    CAPTURE_TIM->CR1 = 0;
+    CAPTURE_TIM->PSC = psc;
+    CAPTURE_TIM->ARR = 0xFFFFu;
+    CAPTURE_TIM->EGR = TIM_EGR_UG;
+    /* IC3 and IC4 both on TI3 */
+    CAPTURE_TIM->CCMR2 = TIM_CCMR2_CC3S_0 | TIM_CCMR2_CC4S_1;
+
+    CAPTURE_DMA_RISE->CPAR = (uint32_t)&CAPTURE_TIM->CCR3;
+    CAPTURE_DMA_RISE->CMAR = (uint32_t)capture_rise;
+    CAPTURE_DMA_RISE->CCR = DMA_CCR_PSIZE_0 | DMA_CCR_MSIZE_0 | DMA_CCR_MINC | DMA_CCR_CIRC |
+                            DMA_CCR_HTIE | DMA_CCR_TCIE;
+    CAPTURE_DMA_FALL->CPAR = (uint32_t)&CAPTURE_TIM->CCR4;
+    CAPTURE_DMA_FALL->CMAR = (uint32_t)capture_fall;
+    CAPTURE_DMA_FALL->CCR = DMA_CCR_PSIZE_0 | DMA_CCR_MSIZE_0 | DMA_CCR_MINC | DMA_CCR_CIRC;
+
+    cap.batch.tim_clk = tim_clk / (psc + 1u);
+    cap.batch.restarts = 0;
+    batch_clear();
+    cap.result = (capture_result_t){ 0 };
+    cap.stream_seq = 0;
+    restart();
+
+    /* same priority as Timebase, processing is not reentrant */
+    NVIC_SetPriority(CAPTURE_IRQn, NVIC_GetPriority(TIM4_IRQn));
+    NVIC_ClearPendingIRQ(CAPTURE_IRQn);
+    NVIC_EnableIRQ(CAPTURE_IRQn);
+
+    cap.batch_start = Timebase.now();
+    cap.batch_cycles = CycleCnt_get();
+    cap.run_F = 1;
+    CAPTURE_TIM->CR1 = TIM_CR1_CEN;
+    Timebase.deadline(TIMEBASE_CH_CAPTURE, cap.flush_us, &flush_cb);
+    return 1;
+}
+
+static void stop(void) {
+    /* TIM3 may be running for source/Encoder */
+    if (cap.run_F == 0) {
+        return;
+    }
+    Timebase.cancel(TIMEBASE_CH_CAPTURE);
+    NVIC_DisableIRQ(CAPTURE_IRQn);
+    CAPTURE_TIM->CR1 = 0;
+    CAPTURE_TIM->CCER = 0;
+    CAPTURE_TIM->DIER = 0;
+    CAPTURE_DMA_RISE->CCR = 0;
+    CAPTURE_DMA_FALL->CCR = 0;
+    cap.run_F = 0;
+    TimOwner_release(CAPTURE_TIM, cap_owner);
+}
+
+static uint32_t result(capture_result_t *p_result) {
+    crit_state_t basepri;
+
+    assert(p_result != NULL);
+
+    /* written by DMA interrupt and flush deadline, both at Timebase priority */
+    basepri = Crit_enter_prio(TIMEBASE_IRQ_PRIO);
+    *p_result = cap.result;
+    Crit_exit_prio(basepri);
+    return p_result->seq;
+}
+
+static void stream(serial_ctrl_desc_t *p_serial) {
+    cap.p_stream = p_serial;
+}
+
+static void exe(void) {
+    capture_result_t res;
+
+    if ( (cap.p_stream == NULL) || (cap.run_F == 0) ) {
+        return;
+    }
+    if (result(&res) != cap.stream_seq) {
+        cap.stream_seq = res.seq;
+        Capture_print(cap.p_stream, &res);
+    }
+}
+
+uint32_t Capture_freq_mhz(const capture_result_t *p_result) {
+    if (p_result->sum == 0) {
+        return 0;
+    }
+    return (uint32_t)(((uint64_t)p_result->periods * p_result->tim_clk * 1000u) / p_result->sum);
+}
+
+uint32_t Capture_duty_pm(const capture_result_t *p_result) {
+    if ( (p_result->high_cnt == 0) || (p_result->sum == 0) ) {
+        return 0;
+    }
+    return (uint32_t)(((uint64_t)p_result->high_sum * p_result->periods * 1000u) /
+                      ((uint64_t)p_result->high_cnt * p_result->sum));
+}
+
+void Capture_print(serial_ctrl_desc_t *p_serial, const capture_result_t *p_result) {
+    if (p_result->periods == 0) {
+        Shell_print(p_serial, "cap no signal, restarts ");
+        Shell_print_u32(p_serial, p_result->restarts);
+        Shell_print(p_serial, "\r\n");
+        return;
+    }
+    Shell_print(p_serial, "cap f ");
+    Shell_print_u32(p_serial, Capture_freq_mhz(p_result));
+    Shell_print(p_serial, " duty ");
+    Shell_print_u32(p_serial, Capture_duty_pm(p_result));
+    Shell_print(p_serial, " n ");
+    Shell_print_u32(p_serial, p_result->periods);
+    Shell_print(p_serial, " min ");
+    Shell_print_u32(p_serial, p_result->min);
+    Shell_print(p_serial, " max ");
+    Shell_print_u32(p_serial, p_result->max);
+    Shell_print(p_serial, " load ");
+    Shell_print_u32(p_serial, (p_result->elapsed != 0) ?
+                    (uint32_t)(((uint64_t)p_result->busy * 1000u) / p_result->elapsed) : 0);
+    Shell_print(p_serial, " restarts ");
+    Shell_print_u32(p_serial, p_result->restarts);
+    Shell_print(p_serial, "\r\n");
+}
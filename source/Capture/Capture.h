@@ -0,0 +1,94 @@
+/**
+ * @file Capture.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief frequency and duty cycle of signal on PB0 (TIM3_CH3). TIM3 free runs, IC3 captures
+ * rising and IC4 (mapped on TI3) falling edges; DMA1 channel 2 and 3 move captures into
+ * circular buffers, no interrupt per edge. Buffers are processed on DMA half / full
+ * transfer of rising channel and from a Timebase deadline once per timer wrap, or every
+ * 65 ms when the wrap is longer (low frequencies, lost signal). Both run on Timebase
+ * priority.
+ *
+ * Period is rising to rising, high time rising to matching falling edge, statistics are
+ * collected over CAPTURE_BATCH_MS and published as capture_result_t. Frequency is total
+ * periods over total ticks of the batch (reciprocal counting), so it is more accurate than
+ * one period at high frequencies. Periods must be shorter than half a timer wrap
+ * (65536 / 2 ticks), use prescaler for low frequencies.
+ *
+ * Processing more than half a buffer late or capture overrun restarts capture and is
+ * counted. Shell command "cap" starts, stops and streams results. Benchmark:
+ * source/Capture/test. TIM3 is shared with source/Encoder (source/TimOwner), start()
+ * refuses while encoder runs.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stdint.h>
+
+#include "Serial.h"
+
+#define CAPTURE_TIM             TIM3
+#define CAPTURE_DMA_RISE        DMA1_Channel2       // TIM3_CH3
+#define CAPTURE_DMA_FALL        DMA1_Channel3       // TIM3_CH4
+#define CAPTURE_IRQn            DMA1_Channel2_IRQn
+
+#define CAPTURE_BUF_SIZE        128u                // captures per edge, power of 2
+#define CAPTURE_BATCH_MS        100u
+
+/* exception entry and exit, not seen by cycle counter in handler */
+#define CAPTURE_ISR_OVERHEAD    24u
+
+typedef struct _capture_result_t{
+    uint32_t    seq;        // incremented on every batch
+    uint32_t    tim_clk;    // timer tick frequency in Hz, after prescaler
+    uint32_t    periods;
+    uint32_t    sum;        // ticks of all periods
+    uint16_t    min;        // ticks
+    uint16_t    max;
+    uint32_t    high_cnt;
+    uint32_t    high_sum;   // ticks
+    uint32_t    restarts;   // overruns and lost signal since start
+    uint32_t    busy;       // cycles spent in processing
+    uint32_t    elapsed;    // cycles of batch
+}capture_result_t;
+
+/**
+ * @brief struct of all available methods of this module
+ */
+typedef struct _Capture_methods_t{
+    /* timer tick = timer clock / (psc + 1), returns 0 when TIM3 is held by source/Encoder */
+    uint8_t     (*start)    (uint16_t psc);
+    void        (*stop)     (void);
+    uint32_t    (*result)   (capture_result_t *p_result);  // copy of last batch, returns seq
+    void        (*stream)   (serial_ctrl_desc_t *p_serial); // print every batch, NULL: off
+    void        (*exe)      (void);             // call from main loop, prints streamed batches
+}Capture_methods_t;
+
+extern const Capture_methods_t Capture;
+
+/**
+ * @brief frequency of batch in mHz, 0 without periods
+ */
+uint32_t Capture_freq_mhz(const capture_result_t *p_result);
+
+/**
+ * @brief duty cycle of batch in permille (mean high time over mean period)
+ */
+uint32_t Capture_duty_pm(const capture_result_t *p_result);
+
+/**
+ * @brief one line: "cap f <mHz> duty <permille> n <periods> min <ticks> max <ticks>
+ * load <permille> restarts <n>"
+ */
+void Capture_print(serial_ctrl_desc_t *p_serial, const capture_result_t *p_result);
+
+/**
+ * @brief capture stopped
+ */
+void Capture_init(void);
+
+#endif /* CAPTURE_H */
@@ -0,0 +1,102 @@
+#include "Capture_test.h"
+#include "Capture.h"
+#include "Serial.h"
+#include "Shell.h"
+#include "stm32f1xx_hal.h"
+
+#define GEN_TIM         TIM2
+#define GEN_DUTY_PM     250u
+#define WAIT_BATCHES    3u
+
+static const uint32_t test_freq[] = { 100, 1000, 10000, 50000, 100000, 200000, 300000, 400000, 500000 };
+
+static uint32_t tim_clk_get(void) {
+    uint32_t tim_clk = HAL_RCC_GetPCLK1Freq();
+
+    /* timer clock is 2x PCLK1 when APB1 is divided */
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+        tim_clk *= 2u;
+    }
+    return tim_clk;
+}
+
+/**
+ * @brief PWM on PA0, returns exact frequency in mHz and duty in permille
+ */
+static uint32_t gen_start(uint32_t freq, uint32_t *p_duty_pm) {
+    uint32_t ticks = tim_clk_get() / freq;
+    uint32_t psc = ticks / 65536u;
+
+    ticks /= (psc + 1u);
+    GEN_TIM->CR1 = 0;
+    GEN_TIM->PSC = psc;
+    GEN_TIM->ARR = ticks - 1u;
+    GEN_TIM->CCR1 = (ticks * GEN_DUTY_PM) / 1000u;
+    GEN_TIM->CCMR1 = TIM_CCMR1_OC1M_2 | TIM_CCMR1_OC1M_1 | TIM_CCMR1_OC1PE;    // PWM mode 1
+    GEN_TIM->CCER = TIM_CCER_CC1E;
+    GEN_TIM->EGR = TIM_EGR_UG;
+    GEN_TIM->CR1 = TIM_CR1_CEN;
+
+    *p_duty_pm = (GEN_TIM->CCR1 * 1000u) / ticks;
+    return (uint32_t)(((uint64_t)tim_clk_get() * 1000u) / ((psc + 1u) * ticks));
+}
+
+static void measure(uint32_t freq) {
+    capture_result_t res;
+    uint32_t set_mhz;
+    uint32_t set_duty;
+    uint32_t meas_mhz;
+    int32_t err_ppm;
+    uint32_t seq;
+    uint32_t start;
+
+    set_mhz = gen_start(freq, &set_duty);
+    Capture.start((uint16_t)(tim_clk_get() / (freq * 32768u)));
+
+    /* first batch is partial */
+    seq = 0;
+    start = HAL_GetTick();
+    while ( (seq < WAIT_BATCHES) && ((HAL_GetTick() - start) < ((WAIT_BATCHES + 1u) * CAPTURE_BATCH_MS)) ) {
+        seq = Capture.result(&res);
+    }
+    Capture.stop();
+    GEN_TIM->CR1 = 0;
+
+    meas_mhz = Capture_freq_mhz(&res);
+    err_ppm = (int32_t)((((int64_t)meas_mhz - (int64_t)set_mhz) * 1000000) / (int64_t)set_mhz);
+    Shell_print_u32(&serial_0, set_mhz);
+    Shell_print(&serial_0, " ");
+    Shell_print_u32(&serial_0, meas_mhz);
+    Shell_print(&serial_0, (err_ppm < 0) ? " -" : " ");
+    Shell_print_u32(&serial_0, (uint32_t)((err_ppm < 0) ? -err_ppm : err_ppm));
+    Shell_print(&serial_0, " ");
+    Shell_print_u32(&serial_0, set_duty);
+    Shell_print(&serial_0, " ");
+    Shell_print_u32(&serial_0, Capture_duty_pm(&res));
+    Shell_print(&serial_0, " ");
+    Shell_print_u32(&serial_0, (res.elapsed != 0) ? (uint32_t)(((uint64_t)res.busy * 1000u) / res.elapsed) : 0);
+    Shell_print(&serial_0, " ");
+    Shell_print_u32(&serial_0, res.restarts);
+    Shell_print(&serial_0, "\r\n");
+}
+
+void capture_test_run(void) {
+    GPIO_InitTypeDef gpio_init = {0};
+    uint8_t i;
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_TIM2_CLK_ENABLE();
+    gpio_init.Pin = GPIO_PIN_0;
+    gpio_init.Mode = GPIO_MODE_AF_PP;
+    gpio_init.Speed = GPIO_SPEED_FREQ_HIGH;
+    HAL_GPIO_Init(GPIOA, &gpio_init);
+
+    Shell_print(&serial_0, "\r\ncapture benchmark, core clock ");
+    Shell_print_u32(&serial_0, SystemCoreClock / 1000000u);
+    Shell_print(&serial_0, " MHz, jumper PA0 -> PB0\r\n");
+    Shell_print(&serial_0, "set mHz, measured mHz, error ppm, set duty, measured duty (permille), load permille, restarts\r\n");
+    for (i = 0; i < (sizeof(test_freq) / sizeof(test_freq[0])); ++i) {
+        measure(test_freq[i]);
+    }
+    Capture.stop();
+}
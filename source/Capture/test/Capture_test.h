@@ -0,0 +1,26 @@
+/**
+ * @file Capture_test.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief accuracy and CPU load of source/Capture across input frequencies. TIM2_CH1 PWM
+ * (PA0, 25 % duty) is the signal, jumper PA0 -> PB0 is needed. Capture prescaler is
+ * chosen so one period is below half a timer wrap.
+ *
+ * Generator and capture run from the same clock, so error shows quantization and lost
+ * edges of the method, not crystal tolerance. Load is processing time of DMA and flush
+ * handlers over batch time, DMA bus cycles are not included.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef CAPTURE_TEST_H
+#define CAPTURE_TEST_H
+
+/**
+ * @brief run benchmark once and print result over serial_0. Serial and Timebase must be
+ * initialized, TIM2 must be free (latency harness stopped).
+ */
+void capture_test_run(void);
+
+#endif /* CAPTURE_TEST_H */
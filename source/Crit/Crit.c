@@ -0,0 +1,51 @@
+/**
+ * @file Crit.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief critical section statistics
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "Crit.h"
+/* dependencies */
+#include "assert_gorenje.h"
+
+uint32_t crit_start[CRIT_KIND_CNT];
+
+static crit_stats_t crit_stats[CRIT_KIND_CNT];
+
+void Crit_hist_add(crit_stats_t *p_stats, uint32_t cycles, uint32_t pc) {
+    uint32_t bucket = 32u - __CLZ(cycles >> 1);
+
+    if (bucket >= CRIT_HIST_CNT) {
+        bucket = CRIT_HIST_CNT - 1u;
+    }
+    p_stats->hist[bucket]++;
+    p_stats->cnt++;
+    p_stats->sum += cycles;
+    if (cycles > p_stats->max) {
+        p_stats->max = cycles;
+        p_stats->max_pc = pc;
+    }
+}
+
+void Crit_record(crit_kind_t kind, uint32_t cycles, uint32_t pc) {
+    Crit_hist_add(&crit_stats[kind], cycles, pc);
+}
+
+const crit_stats_t *Crit_stats(crit_kind_t kind) {
+    assert(kind < CRIT_KIND_CNT);
+    return &crit_stats[kind];
+}
+
+void Crit_reset(void) {
+    crit_state_t primask = Crit_enter();
+    uint8_t kind;
+
+    for (kind = 0; kind < CRIT_KIND_CNT; ++kind) {
+        crit_stats[kind] = (crit_stats_t){ 0 };
+    }
+    Crit_exit(primask);
+}
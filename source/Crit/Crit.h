@@ -0,0 +1,143 @@
+/**
+ * @file Crit.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief critical sections. Crit_enter() masks all interrupts (PRIMASK), Crit_enter_prio()
+ * masks only priorities numerically >= prio (BASEPRI), higher ones still run. Both nest.
+ *
+ * With CRIT_STATS length of every outermost section is measured with DWT cycle counter
+ * into a log2 histogram, with address of the longest one (symbolize with
+ * tools/fault/fault_decode.py or the map file). Recording costs some 40 cycles at exit
+ * and is done while still masked. Shell command "lat" prints it (source/Latency).
+ *
+ * NVIC priority 0 can not be masked by BASEPRI, USART1 and SysTick run at 0. Sections that
+ * only race with Timebase priority (Timebase.now(), Capture.result()) use BASEPRI, so
+ * USART1 and the profiler are not delayed by them.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef CRIT_H
+#define CRIT_H
+
+#include <stdint.h>
+
+#include "stm32f1xx.h"
+#include "CycleCnt.h"
+
+#define CRIT_STATS          1
+
+/* log2 buckets: 0: 0..1 cycles, n: 2^n..2^(n+1) - 1, last one everything above */
+#define CRIT_HIST_CNT       16u
+
+typedef uint32_t crit_state_t;
+
+typedef enum _crit_kind_t{
+    CRIT_PRIMASK = 0,
+    CRIT_BASEPRI,
+    CRIT_KIND_CNT
+}crit_kind_t;
+
+/**
+ * @brief duration statistics, also used for interrupt latency (source/Latency)
+ */
+typedef struct _crit_stats_t{
+    uint32_t    cnt;
+    uint32_t    max;                    // cycles
+    uint32_t    max_pc;                 // where longest one ended
+    uint64_t    sum;
+    uint32_t    hist[CRIT_HIST_CNT];
+}crit_stats_t;
+
+extern uint32_t crit_start[CRIT_KIND_CNT];
+
+/**
+ * @brief add one duration to statistics, caller makes sure it is not preempted by
+ * another writer of the same statistics
+ */
+void Crit_hist_add(crit_stats_t *p_stats, uint32_t cycles, uint32_t pc);
+
+/**
+ * @brief record outermost section of given kind, called by Crit_exit*()
+ */
+void Crit_record(crit_kind_t kind, uint32_t cycles, uint32_t pc);
+
+/**
+ * @brief statistics of given kind
+ */
+const crit_stats_t *Crit_stats(crit_kind_t kind);
+
+/**
+ * @brief clear statistics of both kinds
+ */
+void Crit_reset(void);
+
+#if ( CRIT_STATS == 1 )
+    /* address of the exit site, inlined into caller */
+    #define CRIT_PC(pc)     __asm volatile ("mov %0, pc" : "=r" (pc))
+#endif
+
+/**
+ * @brief mask all interrupts
+ * @return crit_state_t : state to pass to Crit_exit()
+ */
+static inline crit_state_t Crit_enter(void) {
+    crit_state_t primask = __get_PRIMASK();
+
+    __disable_irq();
+#if ( CRIT_STATS == 1 )
+    if (primask == 0) {
+        crit_start[CRIT_PRIMASK] = CycleCnt_get();
+    }
+#endif
+    return primask;
+}
+
+/**
+ * @brief restore interrupt mask from Crit_enter()
+ */
+static inline void Crit_exit(crit_state_t primask) {
+#if ( CRIT_STATS == 1 )
+    uint32_t pc;
+
+    if (primask == 0) {
+        CRIT_PC(pc);
+        Crit_record(CRIT_PRIMASK, CycleCnt_get() - crit_start[CRIT_PRIMASK], pc);
+    }
+#endif
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief mask interrupts of priority prio and lower (numerically >= prio), prio > 0
+ * @return crit_state_t : state to pass to Crit_exit_prio()
+ */
+static inline crit_state_t Crit_enter_prio(uint8_t prio) {
+    crit_state_t basepri = __get_BASEPRI();
+
+    __set_BASEPRI_MAX((uint32_t)prio << (8u - __NVIC_PRIO_BITS));
+#if ( CRIT_STATS == 1 )
+    if (basepri == 0) {
+        crit_start[CRIT_BASEPRI] = CycleCnt_get();
+    }
+#endif
+    return basepri;
+}
+
+/**
+ * @brief restore BASEPRI from Crit_enter_prio()
+ */
+static inline void Crit_exit_prio(crit_state_t basepri) {
+#if ( CRIT_STATS == 1 )
+    uint32_t pc;
+
+    if (basepri == 0) {
+        CRIT_PC(pc);
+        Crit_record(CRIT_BASEPRI, CycleCnt_get() - crit_start[CRIT_BASEPRI], pc);
+    }
+#endif
+    __set_BASEPRI(basepri);
+}
+
+#endif /* CRIT_H */
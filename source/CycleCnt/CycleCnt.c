@@ -0,0 +1,24 @@
+/**
+ * @file CycleCnt.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief core clock cycle counter (DWT CYCCNT)
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ * 
+ */
+#include "CycleCnt.h"
+
+void CycleCnt_init(void) {
+    if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0) {
+        /* trace block must be enabled before DWT registers are accessible */
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+}
+
+uint32_t CycleCnt_toUs(uint32_t cycles) {
+    return cycles / (SystemCoreClock / 1000000U);
+}
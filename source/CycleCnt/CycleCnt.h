@@ -0,0 +1,39 @@
+/**
+ * @file CycleCnt.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief core clock cycle counter (DWT CYCCNT). Used as high resolution time base
+ * for tracing, profiling and benchmarks.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ * 
+ */
+
+#ifndef CYCLE_CNT_H
+#define CYCLE_CNT_H
+
+#include <stdint.h>
+
+#include "stm32f1xx.h"
+
+/**
+ * @brief enable DWT cycle counter. Safe to call more then once.
+ */
+void CycleCnt_init(void);
+
+/**
+ * @brief return current value of core clock cycle counter (wraps every 2^32 cycles)
+ */
+static inline uint32_t CycleCnt_get(void) {
+    return DWT->CYCCNT;
+}
+
+/**
+ * @brief convert number of core clock cycles to micro seconds
+ * @param cycles        : number of cycles
+ * @return uint32_t     : time in us
+ */
+uint32_t CycleCnt_toUs(uint32_t cycles);
+
+#endif /* CYCLE_CNT_H */
@@ -0,0 +1,287 @@
+/**
+ * @file Encoder.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief quadrature encoder, 32 bit position and edge timed velocity
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "Encoder.h"
+/* dependencies */
+#include "main.h"
+#include "Timebase.h"
+#include "CycleCnt.h"
+#include "Crit.h"
+#include "TimOwner.h"
+#include "assert_gorenje.h"
+
+/* enc_high flag: wrap interrupt is running, high is still old and UIF may be cleared */
+#define ENC_HIGH_BUSY   0x00010000u
+
+typedef struct _encoder_ctrl_t{
+    uint32_t    tick;       // HAL tick of last update
+    uint32_t    edge_t;     // last captured edge, Timebase us
+    int32_t     edge_pos;
+    uint16_t    last_ccr;   // raw capture pair of last update
+    uint16_t    last_stamp;
+    uint8_t     edge_F;     // edge_t and edge_pos are valid
+    uint8_t     run_F;
+}encoder_ctrl_t;
+
+static uint8_t                  start       (uint8_t filter);
+static void                     stop        (void);
+static void                     set         (int32_t position);
+static int32_t                  position    (void);
+static int32_t                  velocity    (void);
+static const encoder_stats_t    *stats      (void);
+static void                     exe         (void);
+
+//=========================================================
+/* create needed object  */
+/* upper half of position in bits 0 .. 15 and ENC_HIGH_BUSY, single store keeps both in step */
+static volatile uint32_t enc_high;
+static volatile uint16_t enc_stamp;     // written by DMA on every captured edge
+static volatile int32_t enc_velocity;   // single word, readers never see half an update
+
+static encoder_ctrl_t enc;
+static encoder_stats_t enc_stats;
+static const char enc_owner[] = "enc";
+
+const Encoder_methods_t Encoder = {
+    &start,
+    &stop,
+    &set,
+    &position,
+    &velocity,
+    &stats,
+    &exe
+};
+//=========================================================
+
+/* constructor */
+void Encoder_init(void) {
+    CycleCnt_init();
+    enc_high = 0;
+    enc_velocity = 0;
+    enc.run_F = 0;
+}
+
+void TIM3_IRQHandler(void) {
+    uint32_t start_cycles = CycleCnt_get();
+    uint16_t high = (uint16_t)enc_high;
+
+    /* reader preempting from here on can not rely on UIF, nor on old high */
+    enc_high = high | ENC_HIGH_BUSY;
+    ENCODER_TIM->SR = (uint16_t)~TIM_SR_UIF;
+    /* counter just wrapped, it is still near the end it wrapped to */
+    if (ENCODER_TIM->CNT < 0x8000u) {
+        high = (uint16_t)(high + 1u);
+    } else {
+        high = (uint16_t)(high - 1u);
+    }
+    enc_high = high;
+    enc_stats.wraps++;
+    enc_stats.busy += (CycleCnt_get() - start_cycles) + ENCODER_ISR_OVERHEAD;
+}
+
+/**
+ * @brief last captured edge, position (16 bit) and time stamp of the same edge
+ */
+static void edge_read(uint16_t *p_ccr, uint16_t *p_stamp) {
+    uint16_t ccr;
+
+    /* new edge in between changes CCR1, time stamp follows it within a DMA transfer */
+    do {
+        ccr = (uint16_t)ENCODER_TIM->CCR1;
+        *p_stamp = enc_stamp;
+    } while (ccr != (uint16_t)ENCODER_TIM->CCR1);
+    *p_ccr = ccr;
+}
+
+/**
+ * @brief velocity from last captured edges, called every ENCODER_PERIOD_MS
+ */
+static void update(void) {
+    int32_t vel = enc_velocity;
+    int64_t vel64;
+    int32_t bound;
+    int32_t pos;
+    uint32_t t_now;
+    uint32_t edge_t;
+    uint32_t idle;
+    int32_t edge_pos;
+    uint16_t ccr;
+    uint16_t stamp;
+
+    /* edge first, so it is never newer than t_now and pos */
+    edge_read(&ccr, &stamp);
+    t_now = Timebase.now();
+    pos = position();
+    enc_stats.updates++;
+
+    if ( (ccr != enc.last_ccr) || (stamp != enc.last_stamp) ) {
+        enc.last_ccr = ccr;
+        enc.last_stamp = stamp;
+        /* both are less than half a wrap away from now */
+        edge_t = t_now - (uint16_t)((uint16_t)t_now - stamp);
+        edge_pos = pos - (int16_t)((uint16_t)pos - ccr);
+        if ( (enc.edge_F != 0) && (edge_t != enc.edge_t) ) {
+            vel64 = (((int64_t)(edge_pos - enc.edge_pos) << ENCODER_VEL_SHIFT) * 1000000) /
+                    (int64_t)(edge_t - enc.edge_t);
+            /* above ENCODER_VEL_MAX */
+            if (vel64 > INT32_MAX) {
+                vel64 = INT32_MAX;
+                enc_stats.saturated++;
+            } else if (vel64 < INT32_MIN) {
+                vel64 = INT32_MIN;
+                enc_stats.saturated++;
+            }
+            vel = (int32_t)vel64;
+        }
+        enc.edge_t = edge_t;
+        enc.edge_pos = edge_pos;
+        enc.edge_F = 1;
+        enc_stats.edges++;
+    } else if (enc.edge_F != 0) {
+        /* slowing down: next edge is at least this far away */
+        idle = t_now - enc.edge_t;
+        if (idle > ENCODER_STOP_US) {
+            vel = 0;
+        } else if (idle != 0) {
+            bound = (int32_t)(((uint32_t)ENCODER_EDGE_COUNTS << ENCODER_VEL_SHIFT) * 1000000u / idle);
+            if (vel > bound) {
+                vel = bound;
+            } else if (vel < -bound) {
+                vel = -bound;
+            }
+        }
+    }
+    enc_velocity = vel;
+}
+
+//=========================================================
+/* methods implementation */
+
+static uint8_t start(uint8_t filter) {
+    GPIO_InitTypeDef gpio_init = { 0 };
+
+    assert(filter <= 15u);
+
+    stop();
+    if (TimOwner_claim(ENCODER_TIM, enc_owner) == 0) {
+        return 0;
+    }
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_TIM3_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    gpio_init.Pin = GPIO_PIN_6 | GPIO_PIN_7;
+    gpio_init.Mode = GPIO_MODE_INPUT;
+    gpio_init.Pull = GPIO_PULLUP;               // open collector encoders
+    HAL_GPIO_Init(GPIOA, &gpio_init);
+
+    ENCODER_TIM->CR1 = 0;
+    ENCODER_TIM->DIER = 0;
+    ENCODER_TIM->PSC = 0;
+    ENCODER_TIM->ARR = 0xFFFFu;
+    /* IC1 on TI1, IC2 on TI2, same filter, CC1 also captures counter on rising TI1 */
+    ENCODER_TIM->CCMR1 = TIM_CCMR1_CC1S_0 | TIM_CCMR1_CC2S_0 |
+                         ((uint32_t)filter << TIM_CCMR1_IC1F_Pos) | ((uint32_t)filter << TIM_CCMR1_IC2F_Pos);
+    ENCODER_TIM->CCMR2 = 0;
+    ENCODER_TIM->CCER = TIM_CCER_CC1E;
+    ENCODER_TIM->SMCR = TIM_SMCR_SMS_0 | TIM_SMCR_SMS_1;     // encoder mode 3, both inputs
+    ENCODER_TIM->CNT = 0;
+    ENCODER_TIM->CCR1 = 0;
+    ENCODER_TIM->SR = 0;
+
+    enc_high = 0;
+    enc_stamp = 0;
+    enc_velocity = 0;
+    enc_stats = (encoder_stats_t){ 0 };
+    enc.last_ccr = 0;
+    enc.last_stamp = 0;
+    enc.edge_F = 0;
+    enc.tick = HAL_GetTick();
+
+    ENCODER_DMA->CCR = 0;
+    ENCODER_DMA->CPAR = (uint32_t)ENCODER_STAMP_SRC;
+    ENCODER_DMA->CMAR = (uint32_t)&enc_stamp;
+    ENCODER_DMA->CNDTR = 1;
+    ENCODER_DMA->CCR = DMA_CCR_PSIZE_0 | DMA_CCR_MSIZE_0 | DMA_CCR_CIRC | DMA_CCR_PL_1 | DMA_CCR_EN;
+
+    NVIC_SetPriority(ENCODER_IRQn, NVIC_GetPriority(TIM4_IRQn));
+    NVIC_ClearPendingIRQ(ENCODER_IRQn);
+    NVIC_EnableIRQ(ENCODER_IRQn);
+
+    enc.run_F = 1;
+    ENCODER_TIM->DIER = TIM_DIER_UIE | TIM_DIER_CC1DE;
+    ENCODER_TIM->CR1 = TIM_CR1_CEN;
+    return 1;
+}
+
+static void stop(void) {
+    if (enc.run_F == 0) {
+        return;
+    }
+    /* position stays readable, it does not change anymore */
+    ENCODER_TIM->CR1 = 0;
+    ENCODER_TIM->DIER = 0;
+    ENCODER_DMA->CCR = 0;
+    NVIC_DisableIRQ(ENCODER_IRQn);
+    if ((ENCODER_TIM->SR & TIM_SR_UIF) != 0) {
+        TIM3_IRQHandler();
+    }
+    enc_velocity = 0;
+    enc.run_F = 0;
+    TimOwner_release(ENCODER_TIM, enc_owner);
+}
+
+static void set(int32_t position) {
+    crit_state_t primask = Crit_enter();
+
+    ENCODER_TIM->CNT = (uint16_t)position;
+    ENCODER_TIM->SR = (uint16_t)~TIM_SR_UIF;
+    enc_high = (uint16_t)((uint32_t)position >> 16);
+    enc.edge_F = 0;
+    Crit_exit(primask);
+}
+
+static int32_t position(void) {
+    uint32_t sr;
+    uint32_t high;
+    uint16_t cnt;
+
+    /* retry when wrap interrupt ran or a wrap happened in between */
+    do {
+        high = enc_high;
+        sr = ENCODER_TIM->SR;
+        cnt = (uint16_t)ENCODER_TIM->CNT;
+    } while ( (high != enc_high) || (((sr ^ ENCODER_TIM->SR) & TIM_SR_UIF) != 0) );
+    /* wrap interrupt pending or preempted halfway, caller runs above it or masked;
+       high is still the old one in both cases */
+    if ( ((high & ENC_HIGH_BUSY) != 0) ||
+         (((sr & TIM_SR_UIF) != 0) && ((ENCODER_TIM->DIER & TIM_DIER_UIE) != 0)) ) {
+        high = (cnt < 0x8000u) ? (high + 1u) : (high - 1u);
+    }
+    return (int32_t)((high << 16) | cnt);
+}
+
+static int32_t velocity(void) {
+    return enc_velocity;
+}
+
+static const encoder_stats_t *stats(void) {
+    return &enc_stats;
+}
+
+static void exe(void) {
+    if (enc.run_F == 0) {
+        return;
+    }
+    /* window length does not matter, edges carry their own time */
+    if ((HAL_GetTick() - enc.tick) >= ENCODER_PERIOD_MS) {
+        enc.tick = HAL_GetTick();
+        update();
+    }
+}
@@ -0,0 +1,78 @@
+/**
+ * @file Encoder.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief quadrature encoder on PA6 / PA7 (TIM3 CH1 / CH2). TIM3 in encoder mode 3 counts
+ * every edge of both inputs in hardware, update interrupt (once per 65536 counts) extends
+ * the counter to 32 bit. Wrap direction is taken from the counter half after the wrap, not
+ * from DIR, so jitter at the wrap point does not miscount.
+ *
+ * Velocity is estimated from edge timestamps, not from position differences over a fixed
+ * window. Every rising edge of PA6 captures the counter into CCR1 and DMA1 channel 6
+ * copies the source/Timebase counter (1 us) next to it, no CPU per edge. exe() takes the
+ * last captured edge every ENCODER_PERIOD_MS: counts between the last edges of two
+ * windows over exact time between them. Both edges are in the same phase of the signal,
+ * so there is no +-1 count quantization of window differencing; resolution is 1 us of
+ * the time base. Without new edges velocity is bounded by one signal period over time
+ * since last edge and drops to 0 after ENCODER_STOP_US. velocity() is int32 with
+ * ENCODER_VEL_SHIFT fraction bits, so it saturates at ENCODER_VEL_MAX (about 8.4 M counts/s,
+ * 2.1 MHz per input), faster rotation reads as +-INT32_MAX and is counted in stats.
+ *
+ * position() and velocity() are lock-free and may be called from any context, including
+ * interrupts that preempt the wrap interrupt. TIM3 is shared with source/Capture
+ * (source/TimOwner), start() refuses while capture runs. Shell command "enc", benchmark:
+ * source/Encoder/test.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef ENCODER_H
+#define ENCODER_H
+
+#include <stdint.h>
+
+#define ENCODER_TIM         TIM3
+#define ENCODER_IRQn        TIM3_IRQn
+#define ENCODER_DMA         DMA1_Channel6       // TIM3_CH1
+#define ENCODER_STAMP_SRC   (&TIM4->CNT)        // source/Timebase counter, 1 us
+
+#define ENCODER_PERIOD_MS   10u                 // velocity update
+#define ENCODER_STOP_US     500000u             // no edge for longer: velocity 0
+#define ENCODER_EDGE_COUNTS 4                   // counts between two captured edges
+#define ENCODER_VEL_SHIFT   8u                  // velocity fraction bits
+#define ENCODER_VEL_MAX     (INT32_MAX >> ENCODER_VEL_SHIFT)    // counts per second
+
+/* exception entry and exit, not seen by cycle counter in handler */
+#define ENCODER_ISR_OVERHEAD    24u
+
+typedef struct _encoder_stats_t{
+    uint32_t    wraps;      // overflow and underflow interrupts
+    uint32_t    updates;    // velocity updates
+    uint32_t    edges;      // updates with a new captured edge
+    uint32_t    saturated;  // updates above ENCODER_VEL_MAX
+    uint32_t    busy;       // cycles in wrap interrupt
+}encoder_stats_t;
+
+/**
+ * @brief struct of all available methods of this module
+ */
+typedef struct _Encoder_methods_t{
+    /* input filter ICxF 0 .. 15, returns 0 when TIM3 is held by source/Capture */
+    uint8_t                 (*start)    (uint8_t filter);
+    void                    (*stop)     (void);
+    void                    (*set)      (int32_t position);
+    int32_t                 (*position) (void);
+    int32_t                 (*velocity) (void);     // counts per second << ENCODER_VEL_SHIFT
+    const encoder_stats_t   *(*stats)   (void);
+    void                    (*exe)      (void);     // call from main loop
+}Encoder_methods_t;
+
+extern const Encoder_methods_t Encoder;
+
+/**
+ * @brief encoder stopped, position 0
+ */
+void Encoder_init(void);
+
+#endif /* ENCODER_H */
@@ -0,0 +1,175 @@
+#include "Encoder_test.h"
+#include "Encoder.h"
+#include "Serial.h"
+#include "Shell.h"
+#include "stm32f1xx_hal.h"
+
+#define GEN_TIM         TIM2
+#define GEN_DMA         DMA1_Channel2       // TIM2_UP, counts generator periods
+#define GEN_WRAPS_MAX   60000u              // below DMA counter range
+
+/* even, at least 4 ticks */
+static const uint16_t test_period[] = { 8000, 800, 80, 40, 20, 16, 12, 8, 6, 4 };
+
+static uint32_t gen_sink;
+
+static uint32_t tim_clk_get(void) {
+    uint32_t tim_clk = HAL_RCC_GetPCLK1Freq();
+
+    /* timer clock is 2x PCLK1 when APB1 is divided */
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+        tim_clk *= 2u;
+    }
+    return tim_clk;
+}
+
+/**
+ * @brief counter values 1 .. n visited by value c of a period
+ */
+static uint32_t visits(uint32_t n, uint32_t c, uint32_t period) {
+    return (n >= c) ? (((n - c) / period) + 1u) : 0u;
+}
+
+/**
+ * @brief PA0 and PA1 low, generator armed
+ */
+static void gen_setup(uint16_t period, uint8_t reverse) {
+    uint16_t lead = 1u;
+    uint16_t lag = (uint16_t)(1u + (period / 2u));
+
+    GEN_TIM->CR1 = 0;
+    GEN_TIM->DIER = 0;
+    GEN_TIM->PSC = 0;
+    GEN_TIM->ARR = (uint32_t)period - 1u;
+    GEN_TIM->CNT = 0;
+    GEN_TIM->CCR1 = (reverse != 0) ? lag : lead;
+    GEN_TIM->CCR2 = (reverse != 0) ? lead : lag;
+    GEN_TIM->CCMR1 = TIM_CCMR1_OC1M_2 | TIM_CCMR1_OC2M_2;     // forced inactive
+    GEN_TIM->CCER = TIM_CCER_CC1E | TIM_CCER_CC2E;
+    GEN_TIM->SR = 0;
+
+    GEN_DMA->CCR = 0;
+    GEN_DMA->CPAR = (uint32_t)&GEN_TIM->CNT;
+    GEN_DMA->CMAR = (uint32_t)&gen_sink;
+    GEN_DMA->CNDTR = 0xFFFFu;
+    GEN_DMA->CCR = DMA_CCR_PSIZE_1 | DMA_CCR_MSIZE_1 | DMA_CCR_EN;
+}
+
+/**
+ * @brief both outputs toggle once per period, a quarter of signal period apart
+ */
+static void gen_start(void) {
+    GEN_TIM->CCMR1 = TIM_CCMR1_OC1M_1 | TIM_CCMR1_OC1M_0 | TIM_CCMR1_OC2M_1 | TIM_CCMR1_OC2M_0;
+    GEN_TIM->DIER = TIM_DIER_UDE;
+    GEN_TIM->CR1 = TIM_CR1_CEN;
+}
+
+/**
+ * @brief stop generator, returns edges generated on both outputs
+ */
+static uint32_t gen_stop(uint16_t period) {
+    uint32_t ticks;
+
+    GEN_TIM->CR1 = 0;
+    GEN_TIM->DIER = 0;
+    ticks = ((0xFFFFu - GEN_DMA->CNDTR) * (uint32_t)period) + GEN_TIM->CNT;
+    GEN_DMA->CCR = 0;
+    return visits(ticks, GEN_TIM->CCR1, period) + visits(ticks, GEN_TIM->CCR2, period);
+}
+
+static void print_i32(int32_t value) {
+    Shell_print(&serial_0, (value < 0) ? " -" : " ");
+    Shell_print_u32(&serial_0, (uint32_t)((value < 0) ? -value : value));
+}
+
+/**
+ * @brief one direction, returns count error; velocity error (ppm of rate) in p_vel_ppm
+ */
+static int32_t run(uint16_t period, uint8_t reverse, uint32_t ms, int32_t *p_vel_ppm) {
+    uint32_t rate = (2u * tim_clk_get()) / period;
+    uint32_t edges;
+    uint32_t start;
+    int32_t vel;
+    int32_t pos;
+
+    gen_setup(period, reverse);
+    /* edges of forcing outputs low have passed the input filter */
+    HAL_Delay(1);
+    Encoder.set(0);
+    gen_start();
+    start = HAL_GetTick();
+    while ((HAL_GetTick() - start) < ms) {
+        Encoder.exe();
+    }
+    vel = Encoder.velocity();
+    edges = gen_stop(period);
+    pos = Encoder.position();
+
+    if (vel < 0) {
+        vel = -vel;
+    }
+    *p_vel_ppm = (int32_t)(((((int64_t)vel * 1000000) >> ENCODER_VEL_SHIFT) - ((int64_t)rate * 1000000)) /
+                           (int64_t)rate);
+    return ((pos < 0) ? -pos : pos) - (int32_t)edges;
+}
+
+void encoder_test_run(void) {
+    GPIO_InitTypeDef gpio_init = {0};
+    const encoder_stats_t *p_stats;
+    uint32_t tim_clk = tim_clk_get();
+    uint32_t wraps;
+    uint32_t cycles;
+    uint32_t ms;
+    int32_t err_fwd;
+    int32_t err_rev;
+    int32_t vel_ppm;
+    int32_t vel_rev_ppm;
+    uint8_t i;
+
+    Shell_print(&serial_0, "\r\nencoder benchmark, timer clock ");
+    Shell_print_u32(&serial_0, tim_clk / 1000u);
+    Shell_print(&serial_0, " kHz, jumpers PA0 -> PA6, PA1 -> PA7\r\n");
+    Shell_print(&serial_0, "period, counts/s, count error fwd rev, velocity error ppm fwd rev, wraps, wrap load ppm\r\n");
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_TIM2_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    gpio_init.Pin = GPIO_PIN_0 | GPIO_PIN_1;
+    gpio_init.Mode = GPIO_MODE_AF_PP;
+    gpio_init.Speed = GPIO_SPEED_FREQ_HIGH;
+    HAL_GPIO_Init(GPIOA, &gpio_init);
+    Encoder.start(0);
+
+    for (i = 0; i < (sizeof(test_period) / sizeof(test_period[0])); ++i) {
+        /* generator periods must fit DMA counter */
+        ms = (uint32_t)(((uint64_t)GEN_WRAPS_MAX * test_period[i] * 1000u) / tim_clk);
+        ms = (ms < ENCODER_TEST_MS) ? ms : ENCODER_TEST_MS;
+
+        p_stats = Encoder.stats();
+        wraps = p_stats->wraps;
+        cycles = p_stats->busy;
+        err_fwd = run(test_period[i], 0, ms, &vel_ppm);
+        err_rev = run(test_period[i], 1, ms, &vel_rev_ppm);
+        wraps = p_stats->wraps - wraps;
+        cycles = p_stats->busy - cycles;
+
+        Shell_print_u32(&serial_0, test_period[i]);
+        Shell_print(&serial_0, " ");
+        Shell_print_u32(&serial_0, (2u * tim_clk) / test_period[i]);
+        print_i32(err_fwd);
+        print_i32(err_rev);
+        if (((2u * tim_clk) / test_period[i]) > ENCODER_VEL_MAX) {
+            /* velocity() saturates, counting is still checked */
+            Shell_print(&serial_0, " sat sat");
+        } else {
+            print_i32(vel_ppm);
+            print_i32(vel_rev_ppm);
+        }
+        Shell_print(&serial_0, " ");
+        Shell_print_u32(&serial_0, wraps);
+        Shell_print(&serial_0, " ");
+        Shell_print_u32(&serial_0, (uint32_t)(((uint64_t)cycles * 1000u) / ((SystemCoreClock / 1000000u) * 2u * ms)));
+        Shell_print(&serial_0, "\r\n");
+    }
+    Encoder.stop();
+}
@@ -0,0 +1,31 @@
+/**
+ * @file Encoder_test.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief count rate limit of source/Encoder. TIM2 generates quadrature on PA0 / PA1
+ * (toggle outputs, quarter period apart), jumpers PA0 -> PA6 and PA1 -> PA7 are needed.
+ * Generator periods go down to 4 timer ticks (one count every 2 ticks), forward and
+ * reverse. TIM2 update events are counted by DMA1 channel 2, so generated edges are known
+ * exactly after generator stops: count error is exact, not a rate estimate.
+ *
+ * Reported per period: count rate, count error forward and reverse, velocity estimate
+ * error in ppm ("sat" above ENCODER_VEL_MAX), wrap interrupts and their CPU load in ppm. Highest rate with zero count
+ * error is the limit the hardware counts without CPU per edge; the only CPU cost is one
+ * wrap interrupt per 65536 counts and the velocity update.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef ENCODER_TEST_H
+#define ENCODER_TEST_H
+
+#define ENCODER_TEST_MS     200u
+
+/**
+ * @brief run benchmark once and print result over serial_0. Serial and Timebase must be
+ * initialized, TIM2 (latency harness, logic analyzer) and TIM3 (capture) free.
+ */
+void encoder_test_run(void);
+
+#endif /* ENCODER_TEST_H */
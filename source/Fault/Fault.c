@@ -0,0 +1,159 @@
+/**
+ * @file Fault.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief crash dump
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "Fault.h"
+/* dependencies */
+#include "stm32f1xx_hal.h"
+#include "Shell.h"
+#include "Startup.h"
+
+#define FAULT_MAGIC         0x464C5444u     // "FLTD"
+#define FAULT_RAM_START     0x20000000u
+#define FAULT_FRAME_SIZE    32u
+
+/* linker symbol, only address is used */
+extern uint32_t _estack;
+
+/* survives reset and bootloader, random after power on */
+KEEPRAM static fault_rec_t fault_rec;
+static fault_rec_t fault_last;
+static uint8_t fault_last_F;
+
+static const char * const fault_name[] = { "HardFault", "MemManage", "BusFault", "UsageFault" };
+
+void fault_capture(uint32_t *p_frame, uint32_t exc_return) __attribute__((used, noreturn));
+
+/**
+ * @brief common entry of all fault handlers: pass stacked frame (MSP or PSP, by
+ * EXC_RETURN bit 2) and EXC_RETURN. Naked, so SP is exactly as the core left it.
+ */
+__attribute__((naked)) void HardFault_Handler(void) {
+    __asm volatile (
+        "tst    lr, #4          \n"
+        "ite    eq              \n"
+        "mrseq  r0, msp         \n"
+        "mrsne  r0, psp         \n"
+        "mov    r1, lr          \n"
+        "b      fault_capture   \n"
+    );
+}
+void MemManage_Handler(void)    __attribute__((alias("HardFault_Handler")));
+void BusFault_Handler(void)     __attribute__((alias("HardFault_Handler")));
+void UsageFault_Handler(void)   __attribute__((alias("HardFault_Handler")));
+
+void fault_capture(uint32_t *p_frame, uint32_t exc_return) {
+    const uint32_t frame_addr = (uint32_t)p_frame;
+    const uint32_t *p_word;
+    uint8_t i;
+
+    if (fault_rec.magic != FAULT_MAGIC) {
+        fault_rec.magic = FAULT_MAGIC;
+        fault_rec.cnt = 0;
+    }
+    fault_rec.cnt++;
+    fault_rec.tick = HAL_GetTick();
+    fault_rec.exc = __get_IPSR() & 0x1FFu;
+    fault_rec.exc_return = exc_return;
+    fault_rec.cfsr = SCB->CFSR;
+    fault_rec.hfsr = SCB->HFSR;
+    fault_rec.mmfar = SCB->MMFAR;
+    fault_rec.bfar = SCB->BFAR;
+    fault_rec.sp = frame_addr;
+    fault_rec.stack_cnt = 0;
+
+    /* stacking itself may have failed, read frame only if it is all in RAM */
+    if ( (frame_addr >= FAULT_RAM_START) && ((frame_addr & 3u) == 0) &&
+         ((frame_addr + FAULT_FRAME_SIZE) <= (uint32_t)&_estack) ) {
+        for (i = 0; i < 8u; ++i) {
+            fault_rec.frame[i] = p_frame[i];
+        }
+        /* xPSR bit 9: core inserted an alignment word */
+        fault_rec.sp = frame_addr + FAULT_FRAME_SIZE + (((p_frame[7] >> 9) & 1u) * 4u);
+        for (p_word = (const uint32_t *)fault_rec.sp;
+             (p_word < &_estack) && (fault_rec.stack_cnt < FAULT_STACK_WORDS); ++p_word) {
+            fault_rec.stack[fault_rec.stack_cnt++] = *p_word;
+        }
+    } else {
+        for (i = 0; i < 8u; ++i) {
+            fault_rec.frame[i] = 0;
+        }
+    }
+    fault_rec.pending = 1;
+
+    if ((CoreDebug->DHCSR & CoreDebug_DHCSR_C_DEBUGEN_Msk) != 0) {
+        __BKPT(0);
+    }
+    NVIC_SystemReset();
+}
+
+void Fault_init(void) {
+    if ( (fault_rec.magic == FAULT_MAGIC) && (fault_rec.pending == 1u) ) {
+        fault_last = fault_rec;
+        fault_last_F = 1;
+    }
+    if (fault_rec.magic != FAULT_MAGIC) {
+        fault_rec.magic = FAULT_MAGIC;
+        fault_rec.cnt = 0;
+    }
+    fault_rec.pending = 0;
+
+    /* own handlers for configurable faults, otherwise all escalate to HardFault */
+    SCB->SHCSR |= SCB_SHCSR_USGFAULTENA_Msk | SCB_SHCSR_BUSFAULTENA_Msk | SCB_SHCSR_MEMFAULTENA_Msk;
+}
+
+const fault_rec_t *Fault_last(void) {
+    return (fault_last_F != 0) ? &fault_last : NULL;
+}
+
+void Fault_print(serial_ctrl_desc_t *p_serial) {
+    static const char * const reg_name[8] = { "r0", "r1", "r2", "r3", "r12", "lr", "pc", "psr" };
+    uint32_t i;
+
+    if (fault_last_F == 0) {
+        return;
+    }
+
+    /* line format is parsed by tools/fault/fault_decode.py */
+    Shell_print(p_serial, "FAULT ");
+    Shell_print(p_serial, ((fault_last.exc >= 3u) && (fault_last.exc <= 6u)) ?
+                fault_name[fault_last.exc - 3u] : "?");
+    Shell_print(p_serial, " cnt ");
+    Shell_print_u32(p_serial, fault_last.cnt);
+    Shell_print(p_serial, " tick ");
+    Shell_print_u32(p_serial, fault_last.tick);
+    Shell_print(p_serial, "\r\n");
+    for (i = 0; i < 8u; ++i) {
+        Shell_print(p_serial, reg_name[i]);
+        Shell_print(p_serial, " ");
+        Shell_print_hex(p_serial, fault_last.frame[i]);
+        Shell_print(p_serial, ((i & 3u) == 3u) ? "\r\n" : " ");
+    }
+    Shell_print(p_serial, "sp ");
+    Shell_print_hex(p_serial, fault_last.sp);
+    Shell_print(p_serial, " exc_return ");
+    Shell_print_hex(p_serial, fault_last.exc_return);
+    Shell_print(p_serial, "\r\ncfsr ");
+    Shell_print_hex(p_serial, fault_last.cfsr);
+    Shell_print(p_serial, " hfsr ");
+    Shell_print_hex(p_serial, fault_last.hfsr);
+    Shell_print(p_serial, " mmfar ");
+    Shell_print_hex(p_serial, fault_last.mmfar);
+    Shell_print(p_serial, " bfar ");
+    Shell_print_hex(p_serial, fault_last.bfar);
+    Shell_print(p_serial, "\r\nstack");
+    for (i = 0; i < fault_last.stack_cnt; ++i) {
+        Shell_print(p_serial, " ");
+        Shell_print_hex(p_serial, fault_last.stack[i]);
+        if ((i & 7u) == 7u) {
+            Shell_print(p_serial, (i + 1u < fault_last.stack_cnt) ? "\r\nstack" : "");
+        }
+    }
+    Shell_print(p_serial, "\r\nEND\r\n");
+}
@@ -0,0 +1,65 @@
+/**
+ * @file Fault.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief crash dump. HardFault, MemManage, BusFault and UsageFault handlers (generation
+ * of their Cube handlers is turned off in .ioc) store stacked registers, fault status
+ * registers and a bounded snapshot of the stack above the exception frame into a record in
+ * KEEPRAM (source/Startup), which neither startup code nor bootloader touches, and reset.
+ * On next boot the dump is printed on serial once, shell command "fault" prints it again.
+ * tools/fault/fault_decode.py symbolizes it against the .elf.
+ *
+ * With debugger attached handler stops on breakpoint instead of reset. Test over the
+ * bootloader path: source/Fault/test.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef FAULT_H
+#define FAULT_H
+
+#include <stdint.h>
+
+#include "Serial.h"
+
+/**
+ * @brief words of stack copied from SP at fault upwards (bounded by _estack)
+ */
+#define FAULT_STACK_WORDS   32u
+
+typedef struct _fault_rec_t{
+    uint32_t    magic;
+    uint32_t    pending;                    // not reported yet
+    uint32_t    cnt;                        // faults since power on
+    uint32_t    tick;                       // HAL tick at fault
+    uint32_t    exc;                        // exception number, 3 HardFault .. 6 UsageFault
+    uint32_t    exc_return;
+    uint32_t    frame[8];                   // r0, r1, r2, r3, r12, lr, pc, xpsr, 0 if invalid
+    uint32_t    sp;                         // SP before exception
+    uint32_t    cfsr;
+    uint32_t    hfsr;
+    uint32_t    mmfar;
+    uint32_t    bfar;
+    uint32_t    stack_cnt;
+    uint32_t    stack[FAULT_STACK_WORDS];
+}fault_rec_t;
+
+/**
+ * @brief take over pending dump from KEEPRAM and enable separate MemManage, BusFault and
+ * UsageFault exceptions. Call early in main.
+ */
+void Fault_init(void);
+
+/**
+ * @brief last captured dump, NULL if none since power on
+ */
+const fault_rec_t *Fault_last(void);
+
+/**
+ * @brief print last dump, nothing if there is none
+ * @param p_serial      : port
+ */
+void Fault_print(serial_ctrl_desc_t *p_serial);
+
+#endif /* FAULT_H */
@@ -0,0 +1,67 @@
+#include "Fault_test.h"
+#include "Fault.h"
+#include "Startup.h"
+#include "Serial.h"
+#include "Shell.h"
+#include "stm32f1xx_hal.h"
+
+#define TEST_ARMED          0x46544152u     // "FTAR"
+#define BOOT_VECTORS        FLASH_BASE
+#define APP_VECTORS         0x08002000u     // STM32F103C8_FLASH.ld FLASH
+
+/* next to the dump, bootloader must keep both */
+KEEPRAM static struct {
+    uint32_t    armed;
+    uint32_t    cnt;                        // last reported fault count, 0 if none
+}fault_test;
+
+/**
+ * @brief undefined instruction is the first one, stacked pc is the function address
+ */
+static __attribute__((naked, noinline)) void fault_trigger(void) {
+    __asm volatile ("udf #0xFA");
+}
+
+static void wait_tx_idle(void) {
+    /* flag is changed from uart interrupt */
+    while (*(volatile uint8_t *)&serial_0.Tx_active_F != 0) {
+        /* wait */
+    }
+}
+
+static void check(const char *p_name, uint8_t ok, uint8_t *p_fail) {
+    Shell_print(&serial_0, p_name);
+    Shell_print(&serial_0, ok ? " ok\r\n" : " FAIL\r\n");
+    if (!ok) {
+        *p_fail = 1;
+    }
+}
+
+void fault_test_run(void) {
+    const fault_rec_t *p_rec = Fault_last();
+    const uint32_t boot_reset = *(volatile uint32_t *)(BOOT_VECTORS + 4u);
+    uint8_t fail = 0;
+
+    Shell_print(&serial_0, "\r\nfault test, reset through ");
+    Shell_print(&serial_0, ((boot_reset >= BOOT_VECTORS) && (boot_reset < APP_VECTORS)) ?
+                "bootloader\r\n" : "application only, no bootloader in flash\r\n");
+
+    if (fault_test.armed != TEST_ARMED) {
+        fault_test.cnt = (p_rec != NULL) ? p_rec->cnt : 0;
+        fault_test.armed = TEST_ARMED;
+        Shell_print(&serial_0, "undefined instruction, check follows after reset\r\n");
+        wait_tx_idle();
+        fault_trigger();
+        return;
+    }
+    fault_test.armed = 0;
+
+    check("dump after reset", p_rec != NULL, &fail);
+    if (p_rec != NULL) {
+        check("UsageFault", p_rec->exc == 6u, &fail);
+        check("cfsr UNDEFINSTR", (p_rec->cfsr & SCB_CFSR_UNDEFINSTR_Msk) != 0, &fail);
+        check("stacked pc", p_rec->frame[6] == ((uint32_t)&fault_trigger & ~1u), &fail);
+        check("fault count", p_rec->cnt > fault_test.cnt, &fail);
+    }
+    Shell_print(&serial_0, fail ? "fault test FAIL\r\n" : "fault test ok\r\n");
+}
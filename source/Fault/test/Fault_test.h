@@ -0,0 +1,28 @@
+/**
+ * @file Fault_test.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief crash dump over the bootloader path. First run arms the test in KEEPRAM and
+ * executes an undefined instruction; fault handler stores the dump and resets, reset goes
+ * through the bootloader (same startup file, own .data, .bss and stack) into the
+ * application again. Second run checks that the dump survived: UsageFault, UNDEFINSTR in
+ * CFSR, stacked pc at the faulting instruction, fault count up. Result is printed
+ * over serial_0, the test then disarms itself.
+ *
+ * Run without debugger, with it the fault handler stops on breakpoint instead of reset.
+ * Without bootloader in flash only the warm reset path is covered, this is reported.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef FAULT_TEST_H
+#define FAULT_TEST_H
+
+/**
+ * @brief call once per boot after Fault_init() and Serial init, faults on first call
+ * after power on, checks the dump on the next boot
+ */
+void fault_test_run(void);
+
+#endif /* FAULT_TEST_H */
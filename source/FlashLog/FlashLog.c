@@ -0,0 +1,469 @@
+/**
+ * @file FlashLog.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief circular telemetry log in flash
+ *
+ * page: header (seq, magic) in first 8 bytes, then FLOG_SLOT_CNT record slots.
+ * Pages are written round robin, page with highest seq is written. Slot with all half
+ * words erased is free, slot with id 0xFFFF and other data is interrupted record.
+ *
+ * export frame: "FLG1", rec size (u8), reserved (u8), record count (u16), tick (u32),
+ * then records from oldest to newest (tools/flashlog/flashlog_export.py)
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "FlashLog.h"
+/* dependencies */
+#include "Crit.h"
+#include "assert_gorenje.h"
+#include "Startup.h"
+/* HAL dependencies */
+#include "stm32f1xx_hal.h"
+
+#define PAGE_MAGIC      0x464Cu
+#define ID_FREE         0xFFFFu
+#define EXP_NONE        0xFFu
+
+typedef struct _flog_page_hdr_t{
+    uint32_t    seq;
+    uint16_t    reserved;
+    uint16_t    magic;      // programmed last
+}flog_page_hdr_t;
+
+typedef struct _flog_exp_hdr_t{
+    char        magic[4];
+    uint8_t     rec_size;
+    uint8_t     reserved;
+    uint16_t    rec_cnt;
+    uint32_t    tick;
+}flog_exp_hdr_t;
+
+typedef enum _flog_op_t{
+    FLOG_OP_IDLE = 0,
+    FLOG_OP_PROG_REC,
+    FLOG_OP_PROG_HDR,
+    FLOG_OP_ERASE,
+}flog_op_t;
+
+static uint8_t              append     (uint16_t id, uint16_t arg);
+static void                 flush      (void);
+static void                 suspend    (void);
+static void                 resume     (void);
+static void                 export     (serial_ctrl_desc_t *p_serial);
+static uint8_t              export_exe (void);
+static const flog_stats_t * stats      (void);
+
+//=========================================================
+/* create needed object  */
+/* indexed by head/tail only, no zeroing at reset */
+NOINIT static flog_rec_t flog_stage[FLOG_STAGE_SIZE];
+
+static struct {
+    volatile uint16_t   head;       // staging ring, written by append()
+    volatile uint16_t   tail;       // advanced when record is programmed
+    volatile flog_op_t  op;         // flash operation in progress
+    volatile uint8_t    hold;
+    volatile uint8_t    op_done;    // set by HAL callbacks
+    volatile uint8_t    op_err;
+    uint8_t             wr_page;
+    uint8_t             next_erased;
+    uint16_t            wr_slot;
+    uint32_t            seq;
+    flog_stats_t        stats;
+}flog;
+
+static struct {
+    serial_ctrl_desc_t  *p_serial;
+    uint8_t             hdr_F;
+    volatile uint8_t    page;       // page being exported, it and pages up to end_page are not erased
+    uint8_t             end_page;
+    uint8_t             pages_left;
+    uint16_t            slot;
+    uint16_t            end_slot;
+    flog_exp_hdr_t      hdr;
+}flog_exp;
+
+FlashLog_methods_t FlashLog = {
+    &append,
+    &flush,
+    &suspend,
+    &resume,
+    &export,
+    &export_exe,
+    &stats
+};
+//=========================================================
+
+static uint32_t page_addr(uint8_t page) {
+    return (uint32_t)__flashlog_start + ((uint32_t)page * FLOG_PAGE_SIZE);
+}
+
+static const flog_page_hdr_t *page_hdr(uint8_t page) {
+    return (const flog_page_hdr_t *)page_addr(page);
+}
+
+static const flog_rec_t *slot_rec(uint8_t page, uint16_t slot) {
+    return (const flog_rec_t *)(page_addr(page) + sizeof(flog_page_hdr_t)) + slot;
+}
+
+static uint8_t next_page(uint8_t page) {
+    return (uint8_t)((page + 1u) % FLOG_PAGE_CNT);
+}
+
+static uint8_t slot_free(uint8_t page, uint16_t slot) {
+    const uint32_t *p_w = (const uint32_t *)slot_rec(page, slot);
+
+    return (p_w[0] == 0xFFFFFFFFu) && (p_w[1] == 0xFFFFFFFFu);
+}
+
+static uint8_t page_erased(uint8_t page) {
+    const uint32_t *p_w = (const uint32_t *)page_addr(page);
+    uint16_t i;
+
+    for (i = 0; i < (FLOG_PAGE_SIZE / 4u); ++i) {
+        if (p_w[i] != 0xFFFFFFFFu) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static uint64_t hdr_data(uint32_t seq) {
+    return (uint64_t)seq | ((uint64_t)0xFFFFu << 32) | ((uint64_t)PAGE_MAGIC << 48);
+}
+
+/* page is being exported, or will be */
+static uint8_t export_blocks(uint8_t page) {
+    uint8_t exp_page = flog_exp.page;
+
+    if (exp_page == EXP_NONE) {
+        return 0;
+    }
+    return ((page + FLOG_PAGE_CNT - exp_page) % FLOG_PAGE_CNT) <=
+           ((flog_exp.end_page + FLOG_PAGE_CNT - exp_page) % FLOG_PAGE_CNT);
+}
+
+/**
+ * @brief start next flash operation. Interrupts must be disabled, engine idle.
+ * Erase of next page goes first: records wait in RAM for ~20 ms once per page.
+ */
+static void start_next(void) {
+    FLASH_EraseInitTypeDef erase;
+    const flog_rec_t *p_rec;
+    uint8_t next = next_page(flog.wr_page);
+    flog_op_t op = FLOG_OP_IDLE;
+    HAL_StatusTypeDef status = HAL_OK;
+
+    HAL_FLASH_Unlock();
+    if ( (flog.next_erased == 0) && (export_blocks(next) == 0) ) {
+        erase.TypeErase = FLASH_TYPEERASE_PAGES;
+        erase.Banks = FLASH_BANK_1;
+        erase.PageAddress = page_addr(next);
+        erase.NbPages = 1;
+        op = FLOG_OP_ERASE;
+        status = HAL_FLASHEx_Erase_IT(&erase);
+    } else if (flog.head != flog.tail) {
+        if (flog.wr_slot < FLOG_SLOT_CNT) {
+            p_rec = &flog_stage[flog.tail & (FLOG_STAGE_SIZE - 1u)];
+            op = FLOG_OP_PROG_REC;
+            /* half words are programmed from low address up, id is the last one */
+            status = HAL_FLASH_Program_IT(FLASH_TYPEPROGRAM_DOUBLEWORD,
+                                          (uint32_t)slot_rec(flog.wr_page, flog.wr_slot),
+                                          (uint64_t)p_rec->tm | ((uint64_t)p_rec->arg << 32) |
+                                          ((uint64_t)p_rec->id << 48));
+        } else if (flog.next_erased != 0) {
+            op = FLOG_OP_PROG_HDR;
+            status = HAL_FLASH_Program_IT(FLASH_TYPEPROGRAM_DOUBLEWORD, page_addr(next),
+                                          hdr_data(flog.seq + 1u));
+        }
+    }
+
+    if (status != HAL_OK) {
+        /* flash is used by somebody else, retry on next append() */
+        flog.stats.errors++;
+        op = FLOG_OP_IDLE;
+    }
+    if (op == FLOG_OP_IDLE) {
+        HAL_FLASH_Lock();
+    }
+    flog.op = op;
+}
+
+static void kick(void) {
+    crit_state_t primask = Crit_enter();
+    if ( (flog.op == FLOG_OP_IDLE) && (flog.hold == 0) ) {
+        start_next();
+    }
+    Crit_exit(primask);
+}
+
+//=========================================================
+/* HAL flash callbacks, called from HAL_FLASH_IRQHandler */
+void HAL_FLASH_EndOfOperationCallback(uint32_t ReturnValue) {
+    (void)ReturnValue;
+    flog.op_done = 1;
+}
+
+void HAL_FLASH_OperationErrorCallback(uint32_t ReturnValue) {
+    (void)ReturnValue;
+    flog.op_err = 1;
+}
+
+void FlashLog_irq(void) {
+    crit_state_t primask;
+    uint8_t err = flog.op_err;
+
+    if ( (flog.op_done == 0) && (err == 0) ) {
+        return;
+    }
+    primask = Crit_enter();
+    switch (flog.op) {
+        case FLOG_OP_PROG_REC:
+            /* failed slot is skipped, record is written to the next one */
+            flog.wr_slot++;
+            if (err == 0) {
+                flog.tail++;
+                flog.stats.programmed++;
+            }
+            break;
+        case FLOG_OP_PROG_HDR:
+            if (err == 0) {
+                flog.wr_page = next_page(flog.wr_page);
+                flog.wr_slot = 0;
+                flog.seq++;
+            }
+            /* erase next page (again) */
+            flog.next_erased = 0;
+            break;
+        case FLOG_OP_ERASE:
+            if (err == 0) {
+                flog.next_erased = 1;
+                flog.stats.erases++;
+            }
+            break;
+        default:
+            break;
+    }
+    flog.op_done = 0;
+    flog.op_err = 0;
+    flog.op = FLOG_OP_IDLE;
+    if (err != 0) {
+        /* do not spin on broken flash from interrupt, next append() retries */
+        flog.stats.errors++;
+        HAL_FLASH_Lock();
+    } else if (flog.hold == 0) {
+        start_next();
+    } else {
+        HAL_FLASH_Lock();
+    }
+    Crit_exit(primask);
+}
+
+/* constructor */
+void FlashLog_init(void) {
+    FLASH_EraseInitTypeDef erase;
+    uint32_t page_err;
+    uint8_t page;
+    int16_t newest = -1;
+
+    assert((uint32_t)(__flashlog_end - __flashlog_start) == (FLOG_PAGE_CNT * FLOG_PAGE_SIZE));
+
+    for (page = 0; page < FLOG_PAGE_CNT; ++page) {
+        if (page_hdr(page)->magic != PAGE_MAGIC) {
+            continue;
+        }
+        if ( (newest < 0) || ((int32_t)(page_hdr(page)->seq - page_hdr((uint8_t)newest)->seq) > 0) ) {
+            newest = page;
+        }
+    }
+
+    if (newest < 0) {
+        /* empty log, blocking erase is fine at startup */
+        erase.TypeErase = FLASH_TYPEERASE_PAGES;
+        erase.Banks = FLASH_BANK_1;
+        erase.PageAddress = page_addr(0);
+        erase.NbPages = 1;
+        HAL_FLASH_Unlock();
+        (void)HAL_FLASHEx_Erase(&erase, &page_err);
+        (void)HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, page_addr(0), hdr_data(0));
+        HAL_FLASH_Lock();
+        newest = 0;
+    }
+
+    flog.wr_page = (uint8_t)newest;
+    flog.seq = page_hdr(flog.wr_page)->seq;
+    flog.wr_slot = 0;
+    while ( (flog.wr_slot < FLOG_SLOT_CNT) && (slot_free(flog.wr_page, flog.wr_slot) == 0) ) {
+        flog.wr_slot++;
+    }
+    flog.next_erased = page_erased(next_page(flog.wr_page));
+    flog_exp.page = EXP_NONE;
+
+    (void)append(FLOG_ID_BOOT, (uint16_t)(RCC->CSR >> 24));
+    __HAL_RCC_CLEAR_RESET_FLAGS();
+}
+
+//=========================================================
+/* methods implementation */
+
+static uint8_t append(uint16_t id, uint16_t arg) {
+    flog_rec_t *p_rec;
+    uint16_t fill;
+    crit_state_t primask;
+
+    assert(id != ID_FREE);
+
+    primask = Crit_enter();
+    fill = flog.head - flog.tail;
+    if (fill >= FLOG_STAGE_SIZE) {
+        flog.stats.dropped++;
+        Crit_exit(primask);
+        return 1;
+    }
+    p_rec = &flog_stage[flog.head & (FLOG_STAGE_SIZE - 1u)];
+    p_rec->tm = HAL_GetTick();
+    p_rec->arg = arg;
+    p_rec->id = id;
+    flog.head++;
+    flog.stats.appended++;
+    if (fill >= flog.stats.stage_max) {
+        flog.stats.stage_max = fill + 1u;
+    }
+    if ( (flog.op == FLOG_OP_IDLE) && (flog.hold == 0) ) {
+        start_next();
+    }
+    Crit_exit(primask);
+    return 0;
+}
+
+static void flush(void) {
+    uint32_t errors = flog.stats.errors;
+
+    while ( (flog.head != flog.tail) || (flog.op != FLOG_OP_IDLE) ) {
+        if ( (flog.hold != 0) || ((flog.stats.errors - errors) > FLOG_PAGE_CNT) ) {
+            break;
+        }
+        kick();
+    }
+}
+
+static void suspend(void) {
+    flog.hold = 1;
+    while (flog.op != FLOG_OP_IDLE) {
+        /* current operation completes in flash interrupt */
+    }
+}
+
+static void resume(void) {
+    flog.hold = 0;
+    kick();
+}
+
+/**
+ * @brief next record of export range
+ * @return NULL at the end
+ */
+static const flog_rec_t *export_next(uint8_t *pPage, uint16_t *pSlot, uint8_t *pPages_left) {
+    const flog_rec_t *p_rec;
+    uint16_t slot_end;
+
+    while (*pPages_left > 0) {
+        slot_end = (*pPage == flog_exp.end_page) ? flog_exp.end_slot : FLOG_SLOT_CNT;
+        if (page_hdr(*pPage)->magic == PAGE_MAGIC) {
+            while (*pSlot < slot_end) {
+                p_rec = slot_rec(*pPage, *pSlot);
+                (*pSlot)++;
+                if (p_rec->id != ID_FREE) {
+                    return p_rec;
+                }
+            }
+        }
+        *pPage = next_page(*pPage);
+        *pSlot = 0;
+        (*pPages_left)--;
+    }
+    return NULL;
+}
+
+static void export(serial_ctrl_desc_t *p_serial) {
+    uint8_t page;
+    uint8_t pages_left;
+    uint16_t slot = 0;
+    uint16_t cnt = 0;
+    crit_state_t primask;
+
+    assert(p_serial != NULL);
+
+    primask = Crit_enter();
+    flog_exp.end_page = flog.wr_page;
+    flog_exp.end_slot = flog.wr_slot;
+    /* oldest page first. Erased page after write page can get header any time, skip it.
+       From here on pages in range are not erased */
+    page = next_page(flog.wr_page);
+    pages_left = FLOG_PAGE_CNT;
+    if (page_hdr(page)->magic != PAGE_MAGIC) {
+        page = next_page(page);
+        pages_left--;
+    }
+    flog_exp.page = page;
+    Crit_exit(primask);
+
+    flog_exp.pages_left = pages_left;
+    while (export_next(&page, &slot, &pages_left) != NULL) {
+        cnt++;
+    }
+
+    flog_exp.hdr.magic[0] = 'F';
+    flog_exp.hdr.magic[1] = 'L';
+    flog_exp.hdr.magic[2] = 'G';
+    flog_exp.hdr.magic[3] = '1';
+    flog_exp.hdr.rec_size = sizeof(flog_rec_t);
+    flog_exp.hdr.reserved = 0;
+    flog_exp.hdr.rec_cnt = cnt;
+    flog_exp.hdr.tick = HAL_GetTick();
+    flog_exp.slot = 0;
+    flog_exp.hdr_F = 1;
+    flog_exp.p_serial = p_serial;
+}
+
+static uint8_t export_exe(void) {
+    serial_ctrl_desc_t *p_serial = flog_exp.p_serial;
+    const flog_rec_t *p_rec;
+    uint8_t page;
+
+    if (p_serial == NULL) {
+        return 0;
+    }
+
+    if (flog_exp.hdr_F != 0) {
+        if (Serial.Tx_free(p_serial) < sizeof(flog_exp.hdr)) {
+            return 1;
+        }
+        Serial.write(p_serial, (uint8_t *)&flog_exp.hdr, sizeof(flog_exp.hdr));
+        flog_exp.hdr_F = 0;
+    }
+
+    /* keep Tx buffer full, uart sends at line rate */
+    page = flog_exp.page;
+    while (Serial.Tx_free(p_serial) >= sizeof(flog_rec_t)) {
+        p_rec = export_next(&page, &flog_exp.slot, &flog_exp.pages_left);
+        if (p_rec == NULL) {
+            /* done, erase can continue */
+            flog_exp.page = EXP_NONE;
+            flog_exp.p_serial = NULL;
+            kick();
+            return 0;
+        }
+        Serial.write(p_serial, (uint8_t *)p_rec, sizeof(flog_rec_t));
+    }
+    /* release exported pages for erase */
+    flog_exp.page = page;
+    return 1;
+}
+
+static const flog_stats_t *stats(void) {
+    return &flog.stats;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file FlashLog.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief circular telemetry log in flash (FLASHLOG region in STM32F103C8_FLASH.ld),
+ * survives reset.
+ *
+ * FlashLog.append() only copies the record into RAM staging ring, so it is fast and can be
+ * called from interrupt. Records are programmed from flash interrupt with
+ * HAL_FLASH_Program_IT, one record (4 half words) per operation. Page after the one being
+ * written is erased in background (HAL_FLASHEx_Erase_IT) right after page switch, so
+ * page is ready before current one is full. Erasing drops the oldest page.
+ *
+ * Note: STM32F1 has one flash bank. Code fetch from flash stalls while program or erase is
+ * running, so interrupt driven writing removes busy waiting, but not the stall itself.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+
+#ifndef FLASH_LOG_H
+#define FLASH_LOG_H
+
+#include <stdint.h>
+
+#include "Serial.h"
+
+//=======================================================================================
+#define FLOG_PAGE_SIZE      1024    // STM32F103C8 flash page
+#define FLOG_PAGE_CNT       20
+/**
+ * @brief RAM staging ring, must be power of 2. Has to hold records appended while one
+ * page is erased (~20 ms)
+ */
+#define FLOG_STAGE_SIZE     32
+//=======================================================================================
+
+/**
+ * @brief record id. 0xFFFF is reserved (not programmed slot)
+ */
+typedef enum _flog_id_t{
+    FLOG_ID_BOOT = 0,       // arg: reset flags (RCC_CSR >> 24)
+    FLOG_ID_BENCH,
+    FLOG_ID_USER = 0x100,   // application ids from here on
+}flog_id_t;
+
+/**
+ * @brief record as it is in flash. id is in last half word, it is programmed last, so
+ * record with valid id is complete
+ */
+typedef struct _flog_rec_t{
+    uint32_t    tm;         // HAL_GetTick() in ms
+    uint16_t    arg;
+    uint16_t    id;
+}flog_rec_t;
+
+#define FLOG_SLOT_CNT       ((FLOG_PAGE_SIZE - sizeof(flog_rec_t)) / sizeof(flog_rec_t))
+
+typedef struct _flog_stats_t{
+    uint32_t    appended;
+    uint32_t    programmed;
+    uint32_t    dropped;        // staging ring full
+    uint32_t    errors;         // flash program/erase errors
+    uint32_t    erases;
+    uint16_t    stage_max;      // staging ring high water mark
+}flog_stats_t;
+
+/**
+ * @brief struct of all available methods of this module
+ */
+typedef struct _FlashLog_methods_t{
+    uint8_t                 (*append)     (uint16_t id, uint16_t arg);  // 0: ok, 1: dropped
+    void                    (*flush)      (void);   // wait until staged records are in flash
+    void                    (*suspend)    (void);   // finish current flash operation and hold
+    void                    (*resume)     (void);
+    void                    (*export)     (serial_ctrl_desc_t *p_serial); // start bulk export
+    uint8_t                 (*export_exe) (void);   // call from main loop, returns 1 while exporting
+    const flog_stats_t *    (*stats)      (void);
+}FlashLog_methods_t;
+
+extern FlashLog_methods_t FlashLog;
+
+/**
+ * @brief log region, defined in STM32F103C8_FLASH.ld
+ */
+extern uint8_t __flashlog_start[];
+extern uint8_t __flashlog_end[];
+
+/**
+ * @brief find write position (blocking erase if log is empty), enable flash interrupt,
+ * append boot record
+ */
+void FlashLog_init(void);
+
+/**
+ * @brief continue with next flash operation. Call from FLASH_IRQHandler after
+ * HAL_FLASH_IRQHandler(), HAL releases its lock only after the user callback.
+ */
+void FlashLog_irq(void);
+
+#endif /* FLASH_LOG_H */
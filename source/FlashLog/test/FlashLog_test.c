@@ -0,0 +1,107 @@
+#include "FlashLog_test.h"
+#include "FlashLog.h"
+#include "Serial.h"
+#include "Shell.h"
+#include "CycleCnt.h"
+/* HAL dependencies */
+#include "stm32f1xx_hal.h"
+
+#define BENCH_CNT       400u
+
+typedef struct _bench_t{
+    uint32_t    min;
+    uint32_t    max;
+    uint32_t    sum;
+    uint32_t    stall_max;  // longest gap between two iterations of the wait loop
+}bench_t;
+
+/**
+ * @brief busy wait for next ms tick, like main loop with nothing to do
+ */
+static void wait_tick(bench_t *p_bench) {
+    uint32_t tick = HAL_GetTick();
+    uint32_t last = CycleCnt_get();
+    uint32_t now;
+
+    while (HAL_GetTick() == tick) {
+        now = CycleCnt_get();
+        if ((now - last) > p_bench->stall_max) {
+            p_bench->stall_max = now - last;
+        }
+        last = now;
+    }
+}
+
+static void bench_add(bench_t *p_bench, uint32_t cycles) {
+    if (cycles < p_bench->min) {
+        p_bench->min = cycles;
+    }
+    if (cycles > p_bench->max) {
+        p_bench->max = cycles;
+    }
+    p_bench->sum += cycles;
+}
+
+static void bench_run(bench_t *p_bench, uint8_t sync) {
+    uint32_t i;
+    uint32_t start;
+
+    p_bench->min = 0xFFFFFFFFu;
+    p_bench->max = 0;
+    p_bench->sum = 0;
+    p_bench->stall_max = 0;
+
+    for (i = 0; i < BENCH_CNT; ++i) {
+        wait_tick(p_bench);
+        start = CycleCnt_get();
+        (void)FlashLog.append(FLOG_ID_BENCH, (uint16_t)i);
+        if (sync) {
+            FlashLog.flush();
+        }
+        bench_add(p_bench, CycleCnt_get() - start);
+    }
+    FlashLog.flush();
+}
+
+static void bench_print(const char *p_name, const bench_t *p_bench) {
+    Shell_print(&serial_0, p_name);
+    Shell_print(&serial_0, ": cycles min ");
+    Shell_print_u32(&serial_0, p_bench->min);
+    Shell_print(&serial_0, ", avg ");
+    Shell_print_u32(&serial_0, p_bench->sum / BENCH_CNT);
+    Shell_print(&serial_0, ", max ");
+    Shell_print_u32(&serial_0, p_bench->max);
+    Shell_print(&serial_0, " (");
+    Shell_print_u32(&serial_0, CycleCnt_toUs(p_bench->max));
+    Shell_print(&serial_0, " us), loop stall max ");
+    Shell_print_u32(&serial_0, CycleCnt_toUs(p_bench->stall_max));
+    Shell_print(&serial_0, " us\r\n");
+}
+
+void flog_test_run(void) {
+    bench_t async;
+    bench_t sync;
+    uint32_t dropped;
+    uint32_t erases;
+
+    CycleCnt_init();
+    FlashLog.flush();
+    dropped = FlashLog.stats()->dropped;
+    erases = FlashLog.stats()->erases;
+
+    bench_run(&async, 0);
+    bench_run(&sync, 1);
+
+    Shell_print(&serial_0, "\r\nFlashLog append, ");
+    Shell_print_u32(&serial_0, BENCH_CNT);
+    Shell_print(&serial_0, " records per mode, 1 per ms\r\n");
+    bench_print("async", &async);
+    bench_print("sync ", &sync);
+    Shell_print(&serial_0, "dropped ");
+    Shell_print_u32(&serial_0, FlashLog.stats()->dropped - dropped);
+    Shell_print(&serial_0, ", page erases ");
+    Shell_print_u32(&serial_0, FlashLog.stats()->erases - erases);
+    Shell_print(&serial_0, ", staged max ");
+    Shell_print_u32(&serial_0, FlashLog.stats()->stage_max);
+    Shell_print(&serial_0, "\r\n");
+}
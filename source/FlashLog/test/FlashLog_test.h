@@ -0,0 +1,25 @@
+/**
+ * @file FlashLog_test.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief FlashLog append latency benchmark. Records are appended once per ms, which makes
+ * the log cross a few pages, so background erase is included.
+ *  - async: FlashLog.append() only, records are programmed from flash interrupt.
+ *           Longest main loop stall (CPU waiting on flash bus) is reported as well.
+ *  - sync : FlashLog.append() + FlashLog.flush(), same as writing flash from main loop
+ * Benchmark writes FLOG_ID_BENCH records into the real log.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef FLASH_LOG_TEST_H
+#define FLASH_LOG_TEST_H
+
+/**
+ * @brief run benchmark once and print result over serial_0. Serial and FlashLog must be
+ * initialized.
+ */
+void flog_test_run(void);
+
+#endif /* FLASH_LOG_TEST_H */
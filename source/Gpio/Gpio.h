@@ -0,0 +1,65 @@
+/**
+ * @file Gpio.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief register level GPIO access for timing instrumentation and hot paths. Pin
+ * descriptor (gpio_pin_t) packs port index and pin mask into one integer, so for a
+ * constant descriptor port address and mask are folded by the compiler, also at -O0:
+ * set and clear are one BSRR/BRR store, toggle is one ODR load and one BSRR store.
+ * All writes go through BSRR/BRR, so other pins of the port are never touched and no
+ * critical section is needed, also for a port wide GPIO_WRITE_PORT().
+ *
+ * Pins are still configured by CubeMX (MX_GPIO_Init). Descriptor may hold more pins
+ * of the same port. Benchmark against HAL in test/Gpio_test.c.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef GPIO_H
+#define GPIO_H
+
+#include <stdint.h>
+
+#include "main.h"
+
+/* GPIOA..GPIOG are 0x400 apart on APB2 */
+#define GPIO_PORT_STRIDE    0x400u
+
+typedef uint32_t gpio_pin_t;
+
+/**
+ * @brief pin descriptor from CMSIS port and HAL pin mask, i.e. GPIO_PIN(GPIOC, GPIO_PIN_13)
+ */
+#define GPIO_PIN(port, mask) \
+    ((gpio_pin_t)(((((uint32_t)(port) - GPIOA_BASE) / GPIO_PORT_STRIDE) << 16) | ((uint32_t)(mask) & 0xFFFFu)))
+
+#define GPIO_PORT(pin)      ((GPIO_TypeDef *)(GPIOA_BASE + (((uint32_t)(pin) >> 16) * GPIO_PORT_STRIDE)))
+#define GPIO_MASK(pin)      ((uint32_t)(pin) & 0xFFFFu)
+
+/* board pins */
+#define GPIO_LED            GPIO_PIN(LED_PC13_GPIO_Port, LED_PC13_Pin)   // open drain, low: on
+
+#define GPIO_SET(pin)       (GPIO_PORT(pin)->BSRR = GPIO_MASK(pin))
+#define GPIO_CLR(pin)       (GPIO_PORT(pin)->BRR = GPIO_MASK(pin))
+#define GPIO_WRITE(pin, val) \
+    (GPIO_PORT(pin)->BSRR = ((val) != 0) ? GPIO_MASK(pin) : (GPIO_MASK(pin) << 16))
+#define GPIO_READ(pin)      ((GPIO_PORT(pin)->IDR & GPIO_MASK(pin)) != 0)
+
+/**
+ * @brief invert all pins of descriptor. Not atomic against another writer of the same pin
+ */
+#define GPIO_TOGGLE(pin) \
+    do { \
+        const uint32_t odr_ = GPIO_PORT(pin)->ODR; \
+        GPIO_PORT(pin)->BSRR = ((odr_ & GPIO_MASK(pin)) << 16) | (~odr_ & GPIO_MASK(pin)); \
+    } while (0)
+
+/**
+ * @brief pins in mask take their bit of value, one store, other pins unchanged
+ * @param port          : CMSIS port (GPIOA ..)
+ */
+#define GPIO_WRITE_PORT(port, mask, value) \
+    ((port)->BSRR = ((((uint32_t)(mask)) & ~((uint32_t)(value))) << 16) | (((uint32_t)(mask)) & ((uint32_t)(value))))
+
+#endif /* GPIO_H */
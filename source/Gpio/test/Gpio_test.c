@@ -0,0 +1,96 @@
+#include "Gpio_test.h"
+#include "Gpio.h"
+#include "Serial.h"
+#include "Shell.h"
+#include "CycleCnt.h"
+#include "Crit.h"
+
+/* toggles per run, loops are unrolled by 4 */
+#define TOGGLE_CNT      1000u
+
+typedef enum _gpio_bench_t{
+    BENCH_HAL_TOGGLE = 0,
+    BENCH_HAL_WRITE,
+    BENCH_TOGGLE,
+    BENCH_SET_CLR,
+    BENCH_CNT
+}gpio_bench_t;
+
+static const char * const bench_name[BENCH_CNT] = {
+    "HAL_GPIO_TogglePin ",
+    "HAL_GPIO_WritePin  ",
+    "GPIO_TOGGLE        ",
+    "GPIO_SET, GPIO_CLR "
+};
+
+/* one loop per method, so dispatch is not timed. Loop overhead is, it is the same for all */
+static uint32_t bench_run(gpio_bench_t bench) {
+    crit_state_t primask;
+    uint32_t start;
+    uint32_t cycles;
+    uint32_t i;
+
+    primask = Crit_enter();
+    start = CycleCnt_get();
+    switch (bench) {
+    case BENCH_HAL_TOGGLE:
+        for (i = 0; i < TOGGLE_CNT; i += 4u) {
+            HAL_GPIO_TogglePin(LED_PC13_GPIO_Port, LED_PC13_Pin);
+            HAL_GPIO_TogglePin(LED_PC13_GPIO_Port, LED_PC13_Pin);
+            HAL_GPIO_TogglePin(LED_PC13_GPIO_Port, LED_PC13_Pin);
+            HAL_GPIO_TogglePin(LED_PC13_GPIO_Port, LED_PC13_Pin);
+        }
+        break;
+    case BENCH_HAL_WRITE:
+        for (i = 0; i < TOGGLE_CNT; i += 4u) {
+            HAL_GPIO_WritePin(LED_PC13_GPIO_Port, LED_PC13_Pin, GPIO_PIN_SET);
+            HAL_GPIO_WritePin(LED_PC13_GPIO_Port, LED_PC13_Pin, GPIO_PIN_RESET);
+            HAL_GPIO_WritePin(LED_PC13_GPIO_Port, LED_PC13_Pin, GPIO_PIN_SET);
+            HAL_GPIO_WritePin(LED_PC13_GPIO_Port, LED_PC13_Pin, GPIO_PIN_RESET);
+        }
+        break;
+    case BENCH_TOGGLE:
+        for (i = 0; i < TOGGLE_CNT; i += 4u) {
+            GPIO_TOGGLE(GPIO_LED);
+            GPIO_TOGGLE(GPIO_LED);
+            GPIO_TOGGLE(GPIO_LED);
+            GPIO_TOGGLE(GPIO_LED);
+        }
+        break;
+    default:
+        for (i = 0; i < TOGGLE_CNT; i += 4u) {
+            GPIO_SET(GPIO_LED);
+            GPIO_CLR(GPIO_LED);
+            GPIO_SET(GPIO_LED);
+            GPIO_CLR(GPIO_LED);
+        }
+        break;
+    }
+    cycles = CycleCnt_get() - start;
+    Crit_exit(primask);
+    return cycles;
+}
+
+void gpio_test_run(void) {
+    uint32_t cycles;
+    uint8_t bench;
+
+    CycleCnt_init();
+    Shell_print(&serial_0, "\r\nGPIO toggle benchmark, core clock ");
+    Shell_print_u32(&serial_0, SystemCoreClock / 1000000u);
+    Shell_print(&serial_0, " MHz, ");
+    Shell_print_u32(&serial_0, TOGGLE_CNT);
+    Shell_print(&serial_0, " toggles, cycles x10 per toggle\r\n");
+
+    for (bench = 0; bench < BENCH_CNT; ++bench) {
+        cycles = bench_run((gpio_bench_t)bench);
+        Shell_print(&serial_0, bench_name[bench]);
+        Shell_print(&serial_0, ": ");
+        Shell_print_u32(&serial_0, (cycles * 10u) / TOGGLE_CNT);
+        Shell_print(&serial_0, ", toggles/s ");
+        Shell_print_u32(&serial_0, (uint32_t)(((uint64_t)SystemCoreClock * TOGGLE_CNT) / cycles));
+        Shell_print(&serial_0, "\r\n");
+    }
+    /* LED off */
+    GPIO_SET(GPIO_LED);
+}
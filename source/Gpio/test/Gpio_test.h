@@ -0,0 +1,21 @@
+/**
+ * @file Gpio_test.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief toggle rate benchmark: HAL_GPIO_TogglePin / HAL_GPIO_WritePin against
+ * GPIO_TOGGLE / GPIO_SET, GPIO_CLR (source/Gpio) on LED pin, interrupts masked.
+ * Reports core cycles per toggle and toggles per second.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef GPIO_TEST_H
+#define GPIO_TEST_H
+
+/**
+ * @brief run benchmark once and print result over serial_0. Serial must be initialized.
+ */
+void gpio_test_run(void);
+
+#endif /* GPIO_TEST_H */
@@ -0,0 +1,238 @@
+/**
+ * @file Input.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief EXTI input capture, deadline debounce and event queue
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "Input.h"
+/* dependencies */
+#include "Timebase.h"
+#include "CycleCnt.h"
+#include "assert_gorenje.h"
+
+typedef struct _input_cfg_t{
+    GPIO_TypeDef    *port;
+    uint16_t        pin;
+    uint16_t        debounce;   // us
+    uint32_t        pull;
+    const char      *name;
+}input_cfg_t;
+
+typedef struct _input_line_ctrl_t{
+    uint32_t        edge_time;  // first edge of debounce window
+    uint32_t        due;        // end of debounce window
+    uint8_t         busy_F;     // EXTI line masked, waiting for deadline
+    uint8_t         stable;
+}input_line_ctrl_t;
+
+static uint8_t              get     (input_event_t *p_event);
+static uint8_t              level   (input_line_t line);
+static const char *         name    (input_line_t line);
+static const input_stats_t *stats   (void);
+static void                 debounce_cb (void);
+
+//=========================================================
+/* create needed object  */
+#define INPUT_CFG(name, port, pin, pull, debounce)      { port, pin, debounce, pull, #name },
+static const input_cfg_t input_cfg[INPUT_CNT] = {
+    INPUT_LINES(INPUT_CFG)
+};
+#undef INPUT_CFG
+
+static input_line_ctrl_t input_line[INPUT_CNT];
+static input_stats_t input_stats;
+static uint32_t input_exti_msk;     // all lines
+static uint32_t input_armed_due;
+static uint8_t input_armed_F;
+
+/* queue: head is written only by producer (interrupts), tail only by consumer */
+static input_event_t input_queue[INPUT_QUEUE_SIZE];
+static volatile uint8_t input_head;
+static volatile uint8_t input_tail;
+
+volatile uint32_t input_isr_cycles;
+
+const Input_methods_t Input = {
+    &get,
+    &level,
+    &name,
+    &stats
+};
+//=========================================================
+
+/* constructor */
+void Input_init(void) {
+    GPIO_InitTypeDef gpio_init = {0};
+    uint8_t i;
+
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    input_exti_msk = 0;
+    for (i = 0; i < INPUT_CNT; ++i) {
+        /* one interrupt handler for EXTI 10..15, EXTI line is shared by all ports */
+        assert( (input_cfg[i].pin & 0xFC00u) == input_cfg[i].pin );
+        assert( (input_exti_msk & input_cfg[i].pin) == 0 );
+        input_exti_msk |= input_cfg[i].pin;
+
+        gpio_init.Pin = input_cfg[i].pin;
+        gpio_init.Mode = GPIO_MODE_IT_RISING_FALLING;
+        gpio_init.Pull = input_cfg[i].pull;
+        HAL_GPIO_Init(input_cfg[i].port, &gpio_init);
+        input_line[i].stable = (uint8_t)((input_cfg[i].port->IDR & input_cfg[i].pin) != 0);
+    }
+    EXTI->PR = input_exti_msk;
+
+    /* same priority as Timebase, queue producers must not preempt each other */
+    HAL_NVIC_SetPriority(EXTI15_10_IRQn, NVIC_GetPriority(TIM4_IRQn), 0);
+    HAL_NVIC_EnableIRQ(EXTI15_10_IRQn);
+}
+
+static void queue_put(uint32_t time, uint8_t line, uint8_t level) {
+    uint8_t head = input_head;
+    input_event_t *p_event;
+
+    if ((uint8_t)(head - input_tail) >= INPUT_QUEUE_SIZE) {
+        input_stats.drops++;
+        return;
+    }
+    p_event = &input_queue[head & (INPUT_QUEUE_SIZE - 1u)];
+    p_event->time = time;
+    p_event->line = line;
+    p_event->level = level;
+    /* event is written before consumer can see it */
+    __DMB();
+    input_head = (uint8_t)(head + 1u);
+    input_stats.events++;
+}
+
+/**
+ * @brief one Timebase channel serves all lines, it is armed for the earliest window end
+ */
+static void arm(uint32_t due) {
+    int32_t delay;
+
+    if ( (input_armed_F != 0) && ((int32_t)(due - input_armed_due) >= 0) ) {
+        return;
+    }
+    delay = (int32_t)(due - Timebase.now());
+    input_armed_F = 1;
+    input_armed_due = due;
+    Timebase.deadline(TIMEBASE_CH_INPUT, (delay > 0) ? (uint16_t)delay : 0, &debounce_cb);
+}
+
+void EXTI15_10_IRQHandler(void) {
+    uint32_t pending;
+    uint32_t time;
+    uint8_t i;
+
+    input_isr_cycles = CycleCnt_get();
+    time = Timebase.now();
+    pending = EXTI->PR & input_exti_msk;
+    EXTI->PR = pending;     // rc_w1
+    input_stats.irq++;
+
+    for (i = 0; i < INPUT_CNT; ++i) {
+        const input_cfg_t *p_cfg = &input_cfg[i];
+        input_line_ctrl_t *p_line = &input_line[i];
+
+        if ((pending & p_cfg->pin) == 0) {
+            continue;
+        }
+        if (p_cfg->debounce == 0) {
+            p_line->stable = (uint8_t)((p_cfg->port->IDR & p_cfg->pin) != 0);
+            queue_put(time, i, p_line->stable);
+            continue;
+        }
+        /* ignore further edges until window ends */
+        EXTI->IMR &= ~(uint32_t)p_cfg->pin;
+        p_line->edge_time = time;
+        p_line->due = time + p_cfg->debounce;
+        p_line->busy_F = 1;
+        arm(p_line->due);
+    }
+}
+
+/**
+ * @brief Timebase deadline (TIM4 interrupt), ends all expired debounce windows
+ */
+static void debounce_cb(void) {
+    uint32_t now = Timebase.now();
+    uint32_t next_due = 0;
+    uint8_t next_F = 0;
+    uint8_t lvl;
+    uint8_t i;
+
+    input_armed_F = 0;
+    for (i = 0; i < INPUT_CNT; ++i) {
+        const input_cfg_t *p_cfg = &input_cfg[i];
+        input_line_ctrl_t *p_line = &input_line[i];
+
+        if (p_line->busy_F == 0) {
+            continue;
+        }
+        if ((int32_t)(p_line->due - now) > 0) {
+            if ( (next_F == 0) || ((int32_t)(p_line->due - next_due) < 0) ) {
+                next_due = p_line->due;
+                next_F = 1;
+            }
+            continue;
+        }
+        p_line->busy_F = 0;
+        if ((EXTI->PR & p_cfg->pin) != 0) {
+            input_stats.bounces++;
+        }
+        lvl = (uint8_t)((p_cfg->port->IDR & p_cfg->pin) != 0);
+        if (lvl != p_line->stable) {
+            p_line->stable = lvl;
+            queue_put(p_line->edge_time, i, lvl);
+        } else {
+            input_stats.glitches++;
+        }
+        EXTI->PR = p_cfg->pin;
+        EXTI->IMR |= p_cfg->pin;
+        /* edge between sample and unmask was cleared above, trigger it again */
+        if ((uint8_t)((p_cfg->port->IDR & p_cfg->pin) != 0) != p_line->stable) {
+            EXTI->SWIER = p_cfg->pin;
+        }
+    }
+    if (next_F != 0) {
+        arm(next_due);
+    }
+}
+
+//=========================================================
+/* methods implementation */
+
+static uint8_t get(input_event_t *p_event) {
+    uint8_t tail = input_tail;
+
+    assert(p_event != NULL);
+
+    if (tail == input_head) {
+        return 0;
+    }
+    /* head is read before the event it publishes */
+    __DMB();
+    *p_event = input_queue[tail & (INPUT_QUEUE_SIZE - 1u)];
+    /* event is copied before producer can reuse the slot */
+    __DMB();
+    input_tail = (uint8_t)(tail + 1u);
+    return 1;
+}
+
+static uint8_t level(input_line_t line) {
+    assert(line < INPUT_CNT);
+    return input_line[line].stable;
+}
+
+static const char *name(input_line_t line) {
+    assert(line < INPUT_CNT);
+    return input_cfg[line].name;
+}
+
+static const input_stats_t *stats(void) {
+    return &input_stats;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file Input.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief buttons and trigger lines on EXTI. Edge is timestamped in EXTI interrupt with
+ * Timebase (us). Debounced line masks its EXTI line on first edge and arms a Timebase
+ * deadline; when it expires the level is sampled, and if it differs from the last stable
+ * level an event with timestamp of the first edge is queued. Raw line (debounce 0) queues
+ * every edge directly from EXTI interrupt. No polling.
+ *
+ * Events go to lock-free single producer, single consumer queue: producers are EXTI and
+ * Timebase (TIM4) interrupts on the same priority, so they never preempt each other;
+ * consumer is main loop or shell. Full queue drops new events and counts them.
+ *
+ * All lines are on pins 10..15 (EXTI15_10 interrupt), one line per pin number.
+ * Benchmarks: source/Input/test. Shell command "input" drains queue and prints stats.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stdint.h>
+
+#include "main.h"
+
+/**
+ * @brief name, port, pin, pull, debounce in us (0: raw, every edge is an event, < 65536)
+ */
+#define INPUT_LINES(X) \
+    X(BUTTON,   GPIOB,  GPIO_PIN_12,    GPIO_PULLUP,    20000u) \
+    X(TRIG,     GPIOB,  GPIO_PIN_13,    GPIO_PULLDOWN,  0u)
+
+/* events, power of 2 */
+#define INPUT_QUEUE_SIZE    32u
+
+#define INPUT_ENUM(name, port, pin, pull, debounce)     INPUT_##name,
+typedef enum _input_line_t{
+    INPUT_LINES(INPUT_ENUM)
+    INPUT_CNT
+}input_line_t;
+#undef INPUT_ENUM
+
+typedef struct _input_event_t{
+    uint32_t    time;       // Timebase us of first edge
+    uint8_t     line;       // input_line_t
+    uint8_t     level;      // new stable level
+}input_event_t;
+
+typedef struct _input_stats_t{
+    uint32_t    irq;        // EXTI interrupts
+    uint32_t    events;     // queued
+    uint32_t    bounces;    // debounce windows with more than one edge
+    uint32_t    glitches;   // debounce windows that ended on the old level
+    uint32_t    drops;      // events lost to full queue
+}input_stats_t;
+
+/**
+ * @brief struct of all available methods of this module
+ */
+typedef struct _Input_methods_t{
+    uint8_t             (*get)      (input_event_t *p_event);  // 1: event taken, 0: empty
+    uint8_t             (*level)    (input_line_t line);       // last stable level
+    const char *        (*name)     (input_line_t line);
+    const input_stats_t *(*stats)   (void);
+}Input_methods_t;
+
+extern const Input_methods_t Input;
+
+/**
+ * @brief core cycle counter at EXTI interrupt entry, for latency benchmark
+ */
+extern volatile uint32_t input_isr_cycles;
+
+/**
+ * @brief configure pins and EXTI, needs Timebase
+ */
+void Input_init(void);
+
+#endif /* INPUT_H */
@@ -0,0 +1,177 @@
+#include "Input_test.h"
+#include "Input.h"
+#include "Gpio.h"
+#include "Serial.h"
+#include "Shell.h"
+#include "CycleCnt.h"
+#include "Crit.h"
+
+#define LAT_CNT         256u
+#define WAIT_CYCLES     20000u      // no interrupt after this, edge did not arrive
+#define SETTLE_CYCLES   4000u       // after burst, last interrupt finishes
+
+#define LOOP_PIN        GPIO_PIN(GPIOB, GPIO_PIN_14)
+
+#if ( INPUT_TEST_LOOPBACK == 1 )
+    #define EDGE()      GPIO_TOGGLE(LOOP_PIN)
+#else
+    #define EDGE()      (EXTI->SWIER = GPIO_PIN_13)
+#endif
+
+/* TIM3 clock is core clock (APB1 prescaler 1), period is in core cycles */
+static const uint16_t rate_period[] = { 2000, 1000, 800, 600, 500, 400, 300, 250, 200, 150, 120, 100, 80 };
+
+static uint32_t bsrr[INPUT_QUEUE_SIZE];
+
+static uint8_t irq_wait(uint32_t irq_before) {
+    uint32_t start = CycleCnt_get();
+
+    while (Input.stats()->irq == irq_before) {
+        if ((CycleCnt_get() - start) > WAIT_CYCLES) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void drain(void) {
+    input_event_t event;
+
+    while (Input.get(&event) != 0) {
+    }
+}
+
+static void latency_run(void) {
+    crit_stats_t lat = {0};
+    uint32_t irq;
+    uint32_t start;
+    uint32_t i;
+
+    for (i = 0; i < LAT_CNT; ++i) {
+        irq = Input.stats()->irq;
+        start = CycleCnt_get();
+        EDGE();
+        if (irq_wait(irq) == 0) {
+            Shell_print(&serial_0, "no edge on PB13, check jumper PB14 -> PB13\r\n");
+            return;
+        }
+        Crit_hist_add(&lat, input_isr_cycles - start, 0);
+        drain();
+    }
+    Shell_print(&serial_0, "edge to handler: avg ");
+    Shell_print_u32(&serial_0, (uint32_t)(lat.sum / lat.cnt));
+    Shell_print(&serial_0, ", max ");
+    Shell_print_u32(&serial_0, lat.max);
+    Shell_print(&serial_0, " cycles\r\n");
+    for (i = 0; i < CRIT_HIST_CNT; ++i) {
+        if (lat.hist[i] != 0) {
+            Shell_print(&serial_0, "  < ");
+            Shell_print_u32(&serial_0, 2ul << i);
+            Shell_print(&serial_0, ": ");
+            Shell_print_u32(&serial_0, lat.hist[i]);
+            Shell_print(&serial_0, "\r\n");
+        }
+    }
+}
+
+#if ( INPUT_TEST_LOOPBACK == 1 )
+/**
+ * @brief INPUT_QUEUE_SIZE edges on PB14, one per TIM3 update, DMA1 channel 3 (TIM3_UP)
+ */
+static void burst(uint16_t period) {
+    uint32_t start;
+
+    DMA1_Channel3->CCR = 0;
+    DMA1->IFCR = DMA_IFCR_CGIF3;
+    DMA1_Channel3->CPAR = (uint32_t)&GPIOB->BSRR;
+    DMA1_Channel3->CMAR = (uint32_t)bsrr;
+    DMA1_Channel3->CNDTR = INPUT_QUEUE_SIZE;
+    DMA1_Channel3->CCR = DMA_CCR_MSIZE_1 | DMA_CCR_PSIZE_1 | DMA_CCR_MINC | DMA_CCR_DIR | DMA_CCR_EN;
+
+    TIM3->CR1 = 0;
+    TIM3->PSC = 0;
+    TIM3->ARR = (uint32_t)period - 1u;
+    TIM3->CNT = 0;
+    TIM3->SR = 0;
+    TIM3->DIER = TIM_DIER_UDE;
+    TIM3->CR1 = TIM_CR1_CEN;
+
+    while ((DMA1->ISR & DMA_ISR_TCIF3) == 0) {
+    }
+    TIM3->CR1 = 0;
+    TIM3->DIER = 0;
+    DMA1_Channel3->CCR = 0;
+
+    start = CycleCnt_get();
+    while ((CycleCnt_get() - start) < SETTLE_CYCLES) {
+    }
+}
+
+static void rate_run(void) {
+    const input_stats_t *p_stats = Input.stats();
+    uint32_t irq;
+    uint32_t drops;
+    uint32_t seen;
+    uint16_t best = 0;
+    uint8_t i;
+
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    __HAL_RCC_TIM3_CLK_ENABLE();
+    /* even count, PB14 starts and ends low */
+    for (i = 0; i < INPUT_QUEUE_SIZE; ++i) {
+        bsrr[i] = ((i & 1u) == 0) ? GPIO_PIN_14 : ((uint32_t)GPIO_PIN_14 << 16);
+    }
+
+    Shell_print(&serial_0, "burst of ");
+    Shell_print_u32(&serial_0, INPUT_QUEUE_SIZE);
+    Shell_print(&serial_0, " edges\r\n");
+    for (i = 0; i < (sizeof(rate_period) / sizeof(rate_period[0])); ++i) {
+        drain();
+        irq = p_stats->irq;
+        drops = p_stats->drops;
+        burst(rate_period[i]);
+        seen = p_stats->irq - irq;
+
+        Shell_print(&serial_0, "period ");
+        Shell_print_u32(&serial_0, rate_period[i]);
+        Shell_print(&serial_0, " cycles, edges/s ");
+        Shell_print_u32(&serial_0, SystemCoreClock / rate_period[i]);
+        Shell_print(&serial_0, ": seen ");
+        Shell_print_u32(&serial_0, seen);
+        Shell_print(&serial_0, ", queue drops ");
+        Shell_print_u32(&serial_0, p_stats->drops - drops);
+        Shell_print(&serial_0, "\r\n");
+        if ( (seen == INPUT_QUEUE_SIZE) && (p_stats->drops == drops) ) {
+            best = rate_period[i];
+        }
+    }
+    drain();
+    Shell_print(&serial_0, "max edge rate without loss: ");
+    Shell_print_u32(&serial_0, (best != 0) ? (SystemCoreClock / best) : 0);
+    Shell_print(&serial_0, " edges/s\r\n");
+}
+#endif
+
+void input_test_run(void) {
+#if ( INPUT_TEST_LOOPBACK == 1 )
+    GPIO_InitTypeDef gpio_init = {0};
+
+    GPIO_CLR(LOOP_PIN);
+    gpio_init.Pin = GPIO_PIN_14;
+    gpio_init.Mode = GPIO_MODE_OUTPUT_PP;
+    gpio_init.Speed = GPIO_SPEED_FREQ_HIGH;
+    HAL_GPIO_Init(GPIOB, &gpio_init);
+#endif
+
+    CycleCnt_init();
+    Shell_print(&serial_0, "\r\nEXTI input benchmark, core clock ");
+    Shell_print_u32(&serial_0, SystemCoreClock / 1000000u);
+    Shell_print(&serial_0, " MHz\r\n");
+
+    latency_run();
+#if ( INPUT_TEST_LOOPBACK == 1 )
+    rate_run();
+#else
+    Shell_print(&serial_0, "edge rate needs jumper PB14 -> PB13 and INPUT_TEST_LOOPBACK 1\r\n");
+#endif
+}
@@ -0,0 +1,31 @@
+/**
+ * @file Input_test.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief EXTI input benchmarks on raw line INPUT_TRIG (PB13):
+ *  - edge to handler latency: core cycles from edge to first instruction of EXTI handler
+ *    body (input_isr_cycles), includes exception entry and handler prologue
+ *  - maximum edge rate: bursts of INPUT_QUEUE_SIZE edges from DMA (TIM3 update -> GPIOB
+ *    BSRR, PB14) with shrinking period, edges lost when handler is slower than edge period
+ *    (EXTI pending bit holds one edge). Edge generation does not use the CPU.
+ *
+ * With INPUT_TEST_LOOPBACK 1 a jumper PB14 -> PB13 is needed, latency edges come from
+ * the pin. Without it latency uses EXTI software trigger (no input synchronizer, about
+ * 2 cycles less) and rate benchmark is skipped.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef INPUT_TEST_H
+#define INPUT_TEST_H
+
+#define INPUT_TEST_LOOPBACK     1
+
+/**
+ * @brief run benchmarks once and print result over serial_0. Serial and Input must be
+ * initialized, TIM3 and DMA1 channel 3 must be free.
+ */
+void input_test_run(void);
+
+#endif /* INPUT_TEST_H */
@@ -0,0 +1,681 @@
+/**
+ * @file KVstore.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief key-value configuration store in flash
+ *
+ * page layout (half words):
+ *  0 magic, 1 seq, 2-3 erase count, 4 active flag, 5 obsolete flag, then records
+ * record:
+ *  key, len, data (padded to half word), crc16 of key, len and data
+ * Header fields and flags are programmed once after erase (flags to 0x0000). Magic is
+ * programmed last, so a page with valid magic has valid header.
+ * Record with len 0 is delete marker.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "KVstore.h"
+/* dependencies */
+#include "assert_gorenje.h"
+#include "Startup.h"
+
+#include <string.h>
+
+#define PAGE_MAGIC      0x4B56u
+#define FLAG_SET        0x0000u
+#define HW_ERASED       0xFFFFu
+
+#define HDR_MAGIC       0u
+#define HDR_SEQ         2u
+#define HDR_ERASE_LO    4u
+#define HDR_ERASE_HI    6u
+#define HDR_ACTIVE      8u
+#define HDR_OBSOLETE    10u
+#define HDR_SIZE        12u
+
+#define REC_HDR_SIZE    4u      // key + len
+#define REC_SIZE(len)   (REC_HDR_SIZE + (((len) + 1u) & ~1u) + 2u)
+#define PAGE_CAPACITY   (KV_PAGE_SIZE - HDR_SIZE)
+
+/* RAM index, open addressing with linear probing */
+#define IDX_BITS        6u
+#define IDX_SIZE        (1u << IDX_BITS)
+#define IDX_EMPTY       0xFFFFu
+#define IDX_DELETED     0xFFFEu
+
+#if (IDX_SIZE < (2 * KV_MAX_KEYS))
+    #error "KVstore: increase IDX_BITS, index must have at least 2x KV_MAX_KEYS entries"
+#endif
+
+#if (KV_PAGE_CNT < 3)
+    #error "KVstore: interrupted compaction is restarted on a third page, KV_PAGE_CNT >= 3"
+#endif
+
+#if (REC_SIZE(KV_VALUE_MAX) > PAGE_CAPACITY)
+    #error "KVstore: KV_VALUE_MAX does not fit into page"
+#endif
+
+typedef enum _kv_compact_t{
+    COMPACT_IDLE = 0,
+    COMPACT_COPY,
+}kv_compact_t;
+
+typedef struct _kv_index_t{
+    uint16_t    key;
+    uint16_t    off;    // record offset from store base
+}kv_index_t;
+
+static int16_t              read   (uint16_t key, void *pDest, uint8_t size);
+static kv_status_t          write  (uint16_t key, const void *pSrc, uint8_t len);
+static kv_status_t          remove_key (uint16_t key);
+static void                 exe    (void);
+static const kv_stats_t *   stats  (void);
+
+//=========================================================
+/* create needed object  */
+/* filled with IDX_EMPTY by KVstore_init() */
+NOINIT static kv_index_t kv_idx[IDX_SIZE];
+
+static struct {
+    uintptr_t               base;
+    const kv_flash_port_t   *p_port;
+    uint8_t                 active;     // page with live data
+    uint8_t                 wr_page;    // page for new records: active or compaction target
+    uint16_t                wr_off;     // write offset in wr_page
+    uint16_t                seq;        // seq of active page
+    kv_compact_t            compact;
+    uint16_t                copy_idx;   // next index entry to copy
+    uint16_t                pending;    // live bytes not in wr_page yet while compacting
+    kv_stats_t              stats;
+}kv;
+
+KVstore_methods_t KVstore = {
+    &read,
+    &write,
+    &remove_key,
+    &exe,
+    &stats
+};
+//=========================================================
+
+//=========================================================
+/* flash access */
+
+static uintptr_t page_addr(uint8_t page) {
+    return kv.base + ((uint32_t)page * KV_PAGE_SIZE);
+}
+
+static uint16_t rd16(uint32_t off) {
+    return *(const volatile uint16_t *)(kv.base + off);
+}
+
+static uint16_t hdr_rd(uint8_t page, uint32_t field) {
+    return rd16(((uint32_t)page * KV_PAGE_SIZE) + field);
+}
+
+static uint8_t prog(uint32_t off, uint16_t val) {
+    return kv.p_port->program(kv.base + off, val);
+}
+
+static void port_acquire(void) {
+    if (kv.p_port->acquire != NULL) {
+        kv.p_port->acquire();
+    }
+}
+
+static void port_release(void) {
+    if (kv.p_port->release != NULL) {
+        kv.p_port->release();
+    }
+}
+
+static uint8_t hdr_valid(uint8_t page) {
+    return hdr_rd(page, HDR_MAGIC) == PAGE_MAGIC;
+}
+
+static uint8_t page_of(uint16_t off) {
+    return (uint8_t)(off / KV_PAGE_SIZE);
+}
+
+/* CRC-16/CCITT (0x1021), config records are short, no table needed */
+static uint16_t crc16_upd(uint16_t crc, const uint8_t *pData, uint16_t len) {
+    uint8_t i;
+
+    while (len--) {
+        crc ^= (uint16_t)(*pData++) << 8;
+        for (i = 0; i < 8; ++i) {
+            crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint16_t rec_crc(uint16_t key, uint16_t len, const uint8_t *pData) {
+    uint8_t hdr[REC_HDR_SIZE];
+
+    hdr[0] = (uint8_t)key;
+    hdr[1] = (uint8_t)(key >> 8);
+    hdr[2] = (uint8_t)len;
+    hdr[3] = (uint8_t)(len >> 8);
+    return crc16_upd(crc16_upd(0xFFFFu, hdr, REC_HDR_SIZE), pData, len);
+}
+
+//=========================================================
+/* RAM index */
+
+static uint16_t idx_hash(uint16_t key) {
+    return (uint16_t)(key * 40503u) >> (16u - IDX_BITS);
+}
+
+static kv_index_t *idx_find(uint16_t key) {
+    uint16_t i = idx_hash(key);
+    uint16_t n;
+
+    for (n = 0; n < IDX_SIZE; ++n) {
+        if (kv_idx[i].key == key) {
+            return &kv_idx[i];
+        }
+        if (kv_idx[i].key == IDX_EMPTY) {
+            break;
+        }
+        i = (i + 1u) & (IDX_SIZE - 1u);
+    }
+    return NULL;
+}
+
+static uint16_t rec_size_at(uint16_t off) {
+    return REC_SIZE(rd16(off + 2u));
+}
+
+/* record at off is not live any more */
+static void live_drop(uint16_t off) {
+    uint16_t size = rec_size_at(off);
+
+    kv.stats.live_bytes -= size;
+    if ( (kv.compact != COMPACT_IDLE) && (page_of(off) != kv.wr_page) ) {
+        kv.pending -= size;
+    }
+}
+
+/* live bytes outside of wr_page, still to be copied by compaction */
+static uint16_t pending_bytes(void) {
+    uint16_t pending = 0;
+    uint16_t i;
+
+    for (i = 0; i < IDX_SIZE; ++i) {
+        if ( (kv_idx[i].key < IDX_DELETED) && (page_of(kv_idx[i].off) != kv.wr_page) ) {
+            pending += rec_size_at(kv_idx[i].off);
+        }
+    }
+    return pending;
+}
+
+static uint8_t page_has_live(uint8_t page) {
+    uint16_t i;
+
+    for (i = 0; i < IDX_SIZE; ++i) {
+        if ( (kv_idx[i].key < IDX_DELETED) && (page_of(kv_idx[i].off) == page) ) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static kv_status_t idx_put(uint16_t key, uint16_t off) {
+    kv_index_t *p_entry = idx_find(key);
+    uint16_t i;
+
+    if (p_entry != NULL) {
+        live_drop(p_entry->off);
+    } else {
+        if (kv.stats.keys >= KV_MAX_KEYS) {
+            return KV_ERR_FULL;
+        }
+        /* first free slot, deleted entries are reused */
+        i = idx_hash(key);
+        while ( (kv_idx[i].key != IDX_EMPTY) && (kv_idx[i].key != IDX_DELETED) ) {
+            i = (i + 1u) & (IDX_SIZE - 1u);
+        }
+        p_entry = &kv_idx[i];
+        p_entry->key = key;
+        kv.stats.keys++;
+    }
+    p_entry->off = off;
+    kv.stats.live_bytes += rec_size_at(off);
+    return KV_OK;
+}
+
+static void idx_del(kv_index_t *p_entry) {
+    live_drop(p_entry->off);
+    p_entry->key = IDX_DELETED;
+    kv.stats.keys--;
+}
+
+//=========================================================
+/* flash log */
+
+/**
+ * @brief add records of page to index
+ * @return offset of free space in page, KV_PAGE_SIZE if page can not be appended
+ */
+static uint16_t page_scan(uint8_t page) {
+    uint16_t base = (uint16_t)(page * KV_PAGE_SIZE);
+    uint16_t off = HDR_SIZE;
+    uint16_t key;
+    uint16_t len;
+    kv_index_t *p_entry;
+
+    while ((off + REC_HDR_SIZE) <= KV_PAGE_SIZE) {
+        key = rd16(base + off);
+        if (key == HW_ERASED) {
+            return off;
+        }
+        len = rd16(base + off + 2u);
+        if ( (len > KV_VALUE_MAX) || ((off + REC_SIZE(len)) > KV_PAGE_SIZE) ) {
+            /* interrupted record header, length unknown: no more appends to this page */
+            return KV_PAGE_SIZE;
+        }
+        /* record without valid crc was interrupted, previous value stays */
+        if (rd16(base + off + REC_SIZE(len) - 2u) ==
+                rec_crc(key, len, (const uint8_t *)(kv.base + base + off + REC_HDR_SIZE))) {
+            if (len == 0) {
+                p_entry = idx_find(key);
+                if (p_entry != NULL) {
+                    idx_del(p_entry);
+                }
+            } else {
+                (void)idx_put(key, base + off);
+            }
+        }
+        off += REC_SIZE(len);
+    }
+    return off;
+}
+
+/**
+ * @brief append record to wr_page. Space is consumed also when programming fails.
+ */
+static kv_status_t rec_append(uint16_t key, const uint8_t *pData, uint16_t len, uint16_t *pOff) {
+    uint16_t off = (uint16_t)(kv.wr_page * KV_PAGE_SIZE) + kv.wr_off;
+    uint16_t i;
+    uint16_t hw;
+    uint8_t err;
+
+    kv.wr_off += REC_SIZE(len);
+
+    /* crc last: record is valid only when completely written */
+    err = prog(off, key);
+    err |= prog(off + 2u, len);
+    for (i = 0; (err == 0) && (i < len); i += 2u) {
+        hw = pData[i];
+        hw |= (i + 1u < len) ? ((uint32_t)pData[i + 1u] << 8) : 0xFF00u;
+        err |= prog(off + REC_HDR_SIZE + i, hw);
+    }
+    if (err == 0) {
+        err = prog(off + REC_SIZE(len) - 2u, rec_crc(key, len, pData));
+    }
+    *pOff = off;
+    return (err == 0) ? KV_OK : KV_ERR_FLASH;
+}
+
+/* copy valid record as it is, crc included */
+static kv_status_t rec_copy(kv_index_t *p_entry) {
+    uint16_t src = p_entry->off;
+    uint16_t dst = (uint16_t)(kv.wr_page * KV_PAGE_SIZE) + kv.wr_off;
+    uint16_t size = rec_size_at(src);
+    uint16_t i;
+
+    kv.wr_off += size;
+    for (i = 0; i < size; i += 2u) {
+        if (prog(dst + i, rd16(src + i)) != 0) {
+            return KV_ERR_FLASH;
+        }
+    }
+    kv.pending -= size;
+    p_entry->off = dst;
+    return KV_OK;
+}
+
+/**
+ * @brief erase page and write header, magic last
+ */
+static kv_status_t page_format(uint8_t page, uint16_t seq) {
+    uint16_t base = (uint16_t)(page * KV_PAGE_SIZE);
+    uint32_t erase_cnt = kv.stats.erase_cnt[page] + 1u;
+    uint8_t err;
+
+    if (kv.p_port->erase(page_addr(page)) != 0) {
+        return KV_ERR_FLASH;
+    }
+    kv.stats.erase_cnt[page] = erase_cnt;
+    err = prog(base + HDR_SEQ, seq);
+    err |= prog(base + HDR_ERASE_LO, (uint16_t)erase_cnt);
+    err |= prog(base + HDR_ERASE_HI, (uint16_t)(erase_cnt >> 16));
+    if (err == 0) {
+        err = prog(base + HDR_MAGIC, PAGE_MAGIC);
+    }
+    return (err == 0) ? KV_OK : KV_ERR_FLASH;
+}
+
+/**
+ * @brief format next page without live records and start copying into it. Normally
+ * wr_page is the active page, after an interrupted compaction that could not be resumed
+ * it is the page that received records, which are copied along.
+ */
+static kv_status_t compact_start(void) {
+    uint8_t target = kv.wr_page;
+    uint8_t n;
+    kv_status_t status;
+
+    for (n = 0; n < KV_PAGE_CNT; ++n) {
+        target = (uint8_t)((target + 1u) % KV_PAGE_CNT);
+        if ( (target != kv.active) && (target != kv.wr_page) && !page_has_live(target) ) {
+            break;
+        }
+    }
+    if (n == KV_PAGE_CNT) {
+        /* only after repeated power loss in compaction, all data is still readable */
+        return KV_ERR_FULL;
+    }
+    /* newer than every page that holds records */
+    status = page_format(target, (uint16_t)(hdr_rd(kv.wr_page, HDR_SEQ) + 1u));
+    if (status != KV_OK) {
+        return status;
+    }
+    kv.wr_page = target;
+    kv.wr_off = HDR_SIZE;
+    kv.copy_idx = 0;
+    kv.pending = pending_bytes();
+    kv.compact = COMPACT_COPY;
+    return KV_OK;
+}
+
+/**
+ * @brief copy up to step index entries, switch pages when all are copied
+ */
+static kv_status_t compact_step(uint16_t step) {
+    kv_index_t *p_entry;
+    uint8_t err;
+
+    while ( (step-- > 0) && (kv.copy_idx < IDX_SIZE) ) {
+        p_entry = &kv_idx[kv.copy_idx];
+        if ( (p_entry->key < IDX_DELETED) && (page_of(p_entry->off) != kv.wr_page) ) {
+            if (rec_copy(p_entry) != KV_OK) {
+                return KV_ERR_FLASH;
+            }
+        }
+        kv.copy_idx++;
+    }
+    if (kv.copy_idx < IDX_SIZE) {
+        return KV_OK;
+    }
+
+    /* new page is active before old one is obsolete, mount handles both being active */
+    err = prog((uint16_t)(kv.wr_page * KV_PAGE_SIZE) + HDR_ACTIVE, FLAG_SET);
+    err |= prog((uint16_t)(kv.active * KV_PAGE_SIZE) + HDR_OBSOLETE, FLAG_SET);
+    kv.active = kv.wr_page;
+    kv.seq = hdr_rd(kv.active, HDR_SEQ);
+    kv.compact = COMPACT_IDLE;
+    kv.stats.compactions++;
+    return (err == 0) ? KV_OK : KV_ERR_FLASH;
+}
+
+static kv_status_t compact_finish(void) {
+    kv_status_t status = KV_OK;
+
+    while ( (kv.compact != COMPACT_IDLE) && (status == KV_OK) ) {
+        status = compact_step(IDX_SIZE);
+    }
+    return status;
+}
+
+/**
+ * @brief make room for record of size in wr_page, compact in foreground if needed
+ */
+static kv_status_t reserve(uint16_t size) {
+    kv_status_t status;
+
+    /* while compacting, space for live records not yet copied is reserved */
+    if ( (kv.compact != COMPACT_IDLE) && ((kv.wr_off + size + kv.pending) > KV_PAGE_SIZE) ) {
+        status = compact_finish();
+        if (status != KV_OK) {
+            return status;
+        }
+    }
+    if ((kv.wr_off + size) > KV_PAGE_SIZE) {
+        status = compact_start();
+        if (status == KV_OK) {
+            status = compact_finish();
+        }
+        if (status != KV_OK) {
+            return status;
+        }
+    }
+    return ((kv.wr_off + size) <= KV_PAGE_SIZE) ? KV_OK : KV_ERR_FULL;
+}
+
+/* signed compare, seq wraps */
+static uint8_t seq_newer(uint16_t a, uint16_t b) {
+    return (int16_t)(a - b) > 0;
+}
+
+/**
+ * @brief build index from flash, see KVstore_init()
+ */
+static kv_status_t mount(void) {
+    uint8_t page;
+    int8_t active = -1;
+    int8_t older = -1;
+    int8_t receiving;
+    uint16_t seq;
+    uint32_t erase_max = 0;
+    kv_status_t status = KV_OK;
+
+    /* erase counters, page without header gets highest known count */
+    for (page = 0; page < KV_PAGE_CNT; ++page) {
+        if (hdr_valid(page)) {
+            kv.stats.erase_cnt[page] = hdr_rd(page, HDR_ERASE_LO) |
+                                       ((uint32_t)hdr_rd(page, HDR_ERASE_HI) << 16);
+            if (kv.stats.erase_cnt[page] > erase_max) {
+                erase_max = kv.stats.erase_cnt[page];
+            }
+        }
+    }
+    /* newest active page */
+    for (page = 0; page < KV_PAGE_CNT; ++page) {
+        if (!hdr_valid(page)) {
+            kv.stats.erase_cnt[page] = erase_max;
+        } else if ( (hdr_rd(page, HDR_ACTIVE) == FLAG_SET) && (hdr_rd(page, HDR_OBSOLETE) != FLAG_SET) ) {
+            if ( (active < 0) || seq_newer(hdr_rd(page, HDR_SEQ), hdr_rd((uint8_t)active, HDR_SEQ)) ) {
+                active = (int8_t)page;
+            }
+        }
+    }
+
+    if (active < 0) {
+        /* empty (or never completed first format) */
+        status = page_format(0, 0);
+        if (status == KV_OK) {
+            status = (prog(HDR_ACTIVE, FLAG_SET) == 0) ? KV_OK : KV_ERR_FLASH;
+        }
+        kv.active = 0;
+        kv.wr_page = 0;
+        kv.wr_off = HDR_SIZE;
+        return status;
+    }
+
+    seq = hdr_rd((uint8_t)active, HDR_SEQ);
+    for (page = 0; page < KV_PAGE_CNT; ++page) {
+        if ( hdr_valid(page) && (page != (uint8_t)active) && (hdr_rd(page, HDR_ACTIVE) == FLAG_SET) &&
+             (hdr_rd(page, HDR_OBSOLETE) != FLAG_SET) ) {
+            /* compaction was interrupted after new page got active */
+            older = (int8_t)page;
+        }
+    }
+
+    kv.active = (uint8_t)active;
+    kv.seq = seq;
+    if (older >= 0) {
+        (void)page_scan((uint8_t)older);
+    }
+    kv.wr_page = kv.active;
+    kv.wr_off = page_scan(kv.active);
+    if (older >= 0) {
+        status = (prog((uint16_t)(older * KV_PAGE_SIZE) + HDR_OBSOLETE, FLAG_SET) == 0) ? KV_OK : KV_ERR_FLASH;
+    }
+
+    /* compaction was interrupted while copying. Pages newer than active received records,
+       more than one if restarted compaction was interrupted again. Scan them oldest first,
+       after active, so values written during compaction win */
+    do {
+        receiving = -1;
+        for (page = 0; page < KV_PAGE_CNT; ++page) {
+            if ( hdr_valid(page) && (hdr_rd(page, HDR_ACTIVE) == HW_ERASED) &&
+                 (hdr_rd(page, HDR_OBSOLETE) != FLAG_SET) && seq_newer(hdr_rd(page, HDR_SEQ), seq) &&
+                 ( (receiving < 0) || seq_newer(hdr_rd((uint8_t)receiving, HDR_SEQ), hdr_rd(page, HDR_SEQ)) ) ) {
+                receiving = (int8_t)page;
+            }
+        }
+        if (receiving >= 0) {
+            kv.wr_page = (uint8_t)receiving;
+            kv.wr_off = page_scan(kv.wr_page);
+            seq = hdr_rd(kv.wr_page, HDR_SEQ);
+        }
+    } while (receiving >= 0);
+
+    if (kv.wr_page != kv.active) {
+        /* continue where it stopped, only records outside of wr_page are copied */
+        kv.compact = COMPACT_COPY;
+        kv.copy_idx = 0;
+        kv.pending = pending_bytes();
+        if ((kv.wr_off + kv.pending) > KV_PAGE_SIZE) {
+            /* interrupted record left no room for the rest: start over on a free page and
+               copy records of all pages along, none of them is erased before that is done */
+            kv.compact = COMPACT_IDLE;
+            kv.wr_off = KV_PAGE_SIZE;
+            if (status == KV_OK) {
+                status = compact_start();
+            }
+        }
+    }
+    return status;
+}
+
+/* constructor */
+kv_status_t KVstore_init(uintptr_t base_addr, const kv_flash_port_t *p_port) {
+    kv_status_t status;
+
+    assert(p_port != NULL);
+
+    memset(&kv, 0, sizeof(kv));
+    memset(kv_idx, 0xFF, sizeof(kv_idx));
+    kv.base = base_addr;
+    kv.p_port = p_port;
+
+    port_acquire();
+    status = mount();
+    port_release();
+    return status;
+}
+
+//=========================================================
+/* methods implementation */
+
+static int16_t read(uint16_t key, void *pDest, uint8_t size) {
+    kv_index_t *p_entry = idx_find(key);
+    uint16_t len;
+
+    assert(pDest != NULL);
+
+    if ( (key > KV_KEY_MAX) || (p_entry == NULL) ) {
+        return KV_ERR_NOT_FOUND;
+    }
+    len = rd16(p_entry->off + 2u);
+    if (len > size) {
+        return KV_ERR_SIZE;
+    }
+    memcpy(pDest, (const void *)(kv.base + p_entry->off + REC_HDR_SIZE), len);
+    return (int16_t)len;
+}
+
+static kv_status_t write(uint16_t key, const void *pSrc, uint8_t len) {
+    kv_index_t *p_entry = idx_find(key);
+    uint16_t size = REC_SIZE(len);
+    uint16_t off;
+    kv_status_t status;
+
+    assert(pSrc != NULL);
+
+    if ( (key > KV_KEY_MAX) || (len == 0) || (len > KV_VALUE_MAX) ) {
+        return KV_ERR_SIZE;
+    }
+    /* old record is live until new one is written, both must fit into one page */
+    if ( ((kv.stats.live_bytes + size) > PAGE_CAPACITY) ||
+         ((p_entry == NULL) && (kv.stats.keys >= KV_MAX_KEYS)) ) {
+        return KV_ERR_FULL;
+    }
+    if ( (p_entry != NULL) && (rd16(p_entry->off + 2u) == len) &&
+         (memcmp((const void *)(kv.base + p_entry->off + REC_HDR_SIZE), pSrc, len) == 0) ) {
+        /* same value, save the flash */
+        return KV_OK;
+    }
+    port_acquire();
+    status = reserve(size);
+    if (status == KV_OK) {
+        status = rec_append(key, (const uint8_t *)pSrc, len, &off);
+    }
+    port_release();
+    if (status != KV_OK) {
+        return status;
+    }
+    return idx_put(key, off);
+}
+
+static kv_status_t remove_key(uint16_t key) {
+    kv_index_t *p_entry = idx_find(key);
+    uint16_t off;
+    kv_status_t status;
+
+    if ( (key > KV_KEY_MAX) || (p_entry == NULL) ) {
+        return KV_ERR_NOT_FOUND;
+    }
+    port_acquire();
+    status = reserve(REC_SIZE(0));
+    if (status == KV_OK) {
+        status = rec_append(key, (const uint8_t *)"", 0, &off);
+    }
+    port_release();
+    if (status != KV_OK) {
+        return status;
+    }
+    /* after reserve(), compaction could move the record */
+    idx_del(idx_find(key));
+    return KV_OK;
+}
+
+static void exe(void) {
+    uint16_t used;
+
+    if (kv.compact != COMPACT_IDLE) {
+        port_acquire();
+        (void)compact_step(KV_COMPACT_STEP);
+        port_release();
+        return;
+    }
+    /* start early, so writes rarely wait for compaction. Only when there is enough
+       old records to reclaim, else pages would be erased over and over */
+    used = kv.wr_off - HDR_SIZE;
+    if ( (used > (PAGE_CAPACITY * KV_COMPACT_LEVEL) / 100u) &&
+         ((uint16_t)(used - kv.stats.live_bytes) > (PAGE_CAPACITY / 4u)) ) {
+        port_acquire();
+        (void)compact_start();
+        port_release();
+    }
+}
+
+static const kv_stats_t *stats(void) {
+    kv.stats.used_bytes = kv.wr_off;
+    return &kv.stats;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file KVstore.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief key-value configuration store in flash (KVSTORE region in STM32F103C8_FLASH.ld).
+ *
+ * Records are appended to the active page as a log. RAM hash index holds flash location
+ * of every live key, so read never scans flash. When active page fills up, live records
+ * are copied to next page (compaction) step by step from KVstore.exe(), writes continue
+ * meanwhile. Pages are used round robin, so erases are spread evenly over all pages.
+ * Record is valid only when its crc is written last, so a write interrupted by power loss
+ * leaves previous value of the key in place.
+ *
+ * Live data (all keys with their values) must fit into one page. Compaction interrupted by
+ * power loss is resumed at mount; when the receiving page has no room left for the rest,
+ * it starts over on a third page and takes records of both pages along.
+ *
+ * KVstore.c has no target dependencies, flash HAL port is in KVstore_hal.c. Test on
+ * simulated flash (source/KVstore/test) also builds on host, tools/kvstore.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+
+#ifndef KV_STORE_H
+#define KV_STORE_H
+
+#include <stdint.h>
+
+//=======================================================================================
+#define KV_PAGE_SIZE        1024    // STM32F103C8 flash page
+#define KV_PAGE_CNT         4       // at least 3
+/**
+ * @brief max number of different keys. RAM index has 2x this entries
+ */
+#define KV_MAX_KEYS         32
+#define KV_VALUE_MAX        64
+/**
+ * @brief start compaction in background when active page is filled above this (%)
+ */
+#define KV_COMPACT_LEVEL    75
+/**
+ * @brief number of index entries processed by one KVstore.exe() call during compaction
+ */
+#define KV_COMPACT_STEP     4
+//=======================================================================================
+
+/* keys 0xFFFE and 0xFFFF are reserved */
+#define KV_KEY_MAX          0xFFFDu
+
+typedef enum _kv_status_t{
+    KV_OK = 0,
+    KV_ERR_NOT_FOUND = -1,
+    KV_ERR_FULL = -2,       // no more keys or live data does not fit into page
+    KV_ERR_SIZE = -3,       // value too long or bad key
+    KV_ERR_FLASH = -4,      // program or erase failed
+}kv_status_t;
+
+/**
+ * @brief flash access. Reading is done directly through memory pointer.
+ * Return 0 on success. acquire/release (optional, can be NULL) are called around every
+ * group of flash operations, so other flash users can be held.
+ */
+typedef struct _kv_flash_port_t{
+    uint8_t (*program)  (uintptr_t addr, uint16_t val); // program one half word
+    uint8_t (*erase)    (uintptr_t addr);               // erase page that start on addr
+    void    (*acquire)  (void);
+    void    (*release)  (void);
+}kv_flash_port_t;
+
+/**
+ * @brief port to internal flash through HAL (HAL_FLASH_Program, HAL_FLASHEx_Erase),
+ * FlashLog is suspended meanwhile
+ */
+extern const kv_flash_port_t kv_flash_hal;
+
+/**
+ * @brief store region, defined in STM32F103C8_FLASH.ld
+ */
+extern uint8_t __kvstore_start[];
+extern uint8_t __kvstore_end[];
+
+typedef struct _kv_stats_t{
+    uint16_t    keys;                       // live keys
+    uint16_t    live_bytes;                 // size of live records
+    uint16_t    used_bytes;                 // active page fill
+    uint32_t    erase_cnt[KV_PAGE_CNT];     // erase cycles per page
+    uint32_t    compactions;
+}kv_stats_t;
+
+/**
+ * @brief struct of all available methods of this module
+ */
+typedef struct _KVstore_methods_t{
+    int16_t             (*read)   (uint16_t key, void *pDest, uint8_t size); // returns value length or kv_status_t
+    kv_status_t         (*write)  (uint16_t key, const void *pSrc, uint8_t len);
+    kv_status_t         (*remove) (uint16_t key);
+    void                (*exe)    (void);   // background compaction, call from main loop
+    const kv_stats_t *  (*stats)  (void);
+}KVstore_methods_t;
+
+extern KVstore_methods_t KVstore;
+
+/**
+ * @brief mount store: build RAM index from flash, finish interrupted compaction,
+ * format if flash is empty
+ * @param base_addr : address of first page (__kvstore_start on target)
+ * @param p_port    : flash access
+ * @return kv_status_t
+ */
+kv_status_t KVstore_init(uintptr_t base_addr, const kv_flash_port_t *p_port);
+
+#endif /* KV_STORE_H */
@@ -0,0 +1,64 @@
+/**
+ * @file KVstore_hal.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief KVstore port to internal flash through HAL
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "KVstore.h"
+/* dependencies */
+#include "FlashLog.h"
+/* HAL dependencies */
+#include "stm32f1xx_hal.h"
+
+static uint8_t hal_program(uintptr_t addr, uint16_t val);
+static uint8_t hal_erase(uintptr_t addr);
+static void hal_acquire(void);
+static void hal_release(void);
+
+//=========================================================
+/* create needed object  */
+const kv_flash_port_t kv_flash_hal = {
+    &hal_program,
+    &hal_erase,
+    &hal_acquire,
+    &hal_release
+};
+//=========================================================
+
+static uint8_t hal_program(uintptr_t addr, uint16_t val) {
+    HAL_StatusTypeDef status;
+
+    HAL_FLASH_Unlock();
+    status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, addr, val);
+    HAL_FLASH_Lock();
+    return (status == HAL_OK) ? 0 : 1;
+}
+
+static uint8_t hal_erase(uintptr_t addr) {
+    FLASH_EraseInitTypeDef erase;
+    uint32_t page_err;
+    HAL_StatusTypeDef status;
+
+    erase.TypeErase = FLASH_TYPEERASE_PAGES;
+    erase.Banks = FLASH_BANK_1;
+    erase.PageAddress = addr;
+    erase.NbPages = 1;
+
+    HAL_FLASH_Unlock();
+    status = HAL_FLASHEx_Erase(&erase, &page_err);
+    HAL_FLASH_Lock();
+    return (status == HAL_OK) ? 0 : 1;
+}
+
+/* flash interrupt operations of FlashLog would collide with blocking HAL calls */
+static void hal_acquire(void) {
+    FlashLog.suspend();
+}
+
+static void hal_release(void) {
+    FlashLog.resume();
+}
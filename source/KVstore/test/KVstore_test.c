@@ -0,0 +1,396 @@
+#include "KVstore_test.h"
+#include "KVstore.h"
+#include "Serial.h"
+#include "Shell.h"
+
+#include <string.h>
+
+#define SIM_SIZE        (KV_PAGE_CNT * KV_PAGE_SIZE)
+#define SIM_NO_CUT      0xFFFFFFFFu
+
+#define WEAR_UPDATES    3000u
+#define PL_KEYS         6u
+#define PL_SETUP_WRITES 90u
+#define PL_WRITES       60u
+#define PL_KEY_REMOVED  PL_KEYS     // key removed in the middle of the sequence
+
+/* live data close to page capacity: 12 records of 70 bytes, compaction every 2nd write */
+#define BIG_KEYS        12u
+#define BIG_LEN         KV_VALUE_MAX
+#define BIG_WRITES      24u
+#define BIG_RECUT_SPAN  500u        // second cut during recovery, up to this many operations
+#define BIG_EXE_CALLS   32u
+
+//=========================================================
+/* simulated flash */
+static uint16_t sim_mem[SIM_SIZE / 2];
+
+static struct {
+    uint32_t    ops;            // program + erase operations since power on
+    uint32_t    cut_at;         // power is lost on this operation
+    uint8_t     power_off;
+    uint32_t    pgerr;          // program of not erased half word
+    uint32_t    erase_cnt[KV_PAGE_CNT];
+}sim;
+
+static uint8_t sim_power_check(void) {
+    if (sim.power_off) {
+        return 1;
+    }
+    if (++sim.ops == sim.cut_at) {
+        sim.power_off = 1;
+        return 1;
+    }
+    return 0;
+}
+
+static uint8_t sim_program(uintptr_t addr, uint16_t val) {
+    uint16_t *p_hw = (uint16_t *)addr;
+
+    if (sim_power_check()) {
+        return 1;
+    }
+    /* STM32F1: only erased half word can be programmed, except to 0x0000 */
+    if ( (*p_hw != 0xFFFFu) && (val != 0x0000u) ) {
+        sim.pgerr++;
+        return 1;
+    }
+    *p_hw = val;
+    return 0;
+}
+
+static uint8_t sim_erase(uintptr_t addr) {
+    uint32_t page = (uint32_t)((addr - (uintptr_t)sim_mem) / KV_PAGE_SIZE);
+
+    if (sim_power_check()) {
+        /* interrupted erase: only part of the page is erased */
+        if (sim.ops == sim.cut_at) {
+            memset((void *)addr, 0xFF, KV_PAGE_SIZE / 2);
+        }
+        return 1;
+    }
+    memset((void *)addr, 0xFF, KV_PAGE_SIZE);
+    sim.erase_cnt[page]++;
+    return 0;
+}
+
+static const kv_flash_port_t sim_port = {
+    &sim_program,
+    &sim_erase,
+    NULL,
+    NULL
+};
+
+static void sim_blank(void) {
+    memset(sim_mem, 0xFF, sizeof(sim_mem));
+    memset(&sim, 0, sizeof(sim));
+    sim.cut_at = SIM_NO_CUT;
+}
+
+static kv_status_t sim_power_on(uint32_t cut_at) {
+    sim.ops = 0;
+    sim.power_off = 0;
+    sim.cut_at = cut_at;
+    return KVstore_init((uintptr_t)sim_mem, &sim_port);
+}
+//=========================================================
+
+static uint32_t fails;
+
+static void check(const char *p_name, uint8_t ok) {
+    if (!ok) {
+        fails++;
+        Shell_print(&serial_0, "FAIL: ");
+        Shell_print(&serial_0, p_name);
+        Shell_print(&serial_0, "\r\n");
+    }
+}
+
+static uint32_t val_of(uint16_t key, uint32_t step) {
+    return ((uint32_t)key << 16) | step;
+}
+
+static uint8_t key_is(uint16_t key, uint32_t val) {
+    uint32_t rd = 0;
+
+    return (KVstore.read(key, &rd, sizeof(rd)) == sizeof(rd)) && (rd == val);
+}
+
+static void test_basic(void) {
+    char str[KV_VALUE_MAX];
+    uint16_t key;
+    uint32_t val;
+
+    sim_blank();
+    check("format", sim_power_on(SIM_NO_CUT) == KV_OK);
+    for (key = 0; key < 10; ++key) {
+        val = val_of(key, 0);
+        check("write", KVstore.write(key, &val, sizeof(val)) == KV_OK);
+    }
+    val = val_of(3, 1);
+    check("overwrite", KVstore.write(3, &val, sizeof(val)) == KV_OK);
+    check("remove", KVstore.remove(5) == KV_OK);
+    check("remove missing", KVstore.remove(5) == KV_ERR_NOT_FOUND);
+    check("string", KVstore.write(100, "115200 8N1", 10) == KV_OK);
+    check("too long", KVstore.write(101, str, KV_VALUE_MAX + 1) == KV_ERR_SIZE);
+    check("reserved key", KVstore.write(0xFFFF, &val, sizeof(val)) == KV_ERR_SIZE);
+
+    /* remount builds index from flash */
+    check("remount", sim_power_on(SIM_NO_CUT) == KV_OK);
+    for (key = 0; key < 10; ++key) {
+        if (key == 3) {
+            check("read overwritten", key_is(key, val_of(key, 1)));
+        } else if (key == 5) {
+            check("read removed", KVstore.read(key, &val, sizeof(val)) == KV_ERR_NOT_FOUND);
+        } else {
+            check("read", key_is(key, val_of(key, 0)));
+        }
+    }
+    check("read string", (KVstore.read(100, str, sizeof(str)) == 10) && (memcmp(str, "115200 8N1", 10) == 0));
+    check("dest too small", KVstore.read(100, &val, 2) == KV_ERR_SIZE);
+    check("no pgerr", sim.pgerr == 0);
+}
+
+static void test_wear(void) {
+    const kv_stats_t *p_stats;
+    uint32_t i;
+    uint32_t val;
+    uint32_t erase_min = 0xFFFFFFFFu;
+    uint32_t erase_max = 0;
+    uint8_t page;
+    uint16_t key;
+
+    sim_blank();
+    (void)sim_power_on(SIM_NO_CUT);
+    for (i = 0; i < WEAR_UPDATES; ++i) {
+        key = (uint16_t)(i % 8u);
+        val = val_of(key, i);
+        if (KVstore.write(key, &val, sizeof(val)) != KV_OK) {
+            check("wear write", 0);
+            break;
+        }
+        KVstore.exe();
+    }
+    for (key = 0; key < 8; ++key) {
+        check("wear read", key_is(key, val_of(key, WEAR_UPDATES - 8u + key)));
+    }
+    for (page = 0; page < KV_PAGE_CNT; ++page) {
+        if (sim.erase_cnt[page] < erase_min) {
+            erase_min = sim.erase_cnt[page];
+        }
+        if (sim.erase_cnt[page] > erase_max) {
+            erase_max = sim.erase_cnt[page];
+        }
+    }
+    p_stats = KVstore.stats();
+    check("wear spread", (erase_max - erase_min) <= 1u);
+    check("erase count in header", p_stats->erase_cnt[0] == sim.erase_cnt[0]);
+    check("no pgerr", sim.pgerr == 0);
+
+    Shell_print(&serial_0, "wear: updates ");
+    Shell_print_u32(&serial_0, WEAR_UPDATES);
+    Shell_print(&serial_0, ", compactions ");
+    Shell_print_u32(&serial_0, p_stats->compactions);
+    Shell_print(&serial_0, ", erases per page");
+    for (page = 0; page < KV_PAGE_CNT; ++page) {
+        Shell_print(&serial_0, " ");
+        Shell_print_u32(&serial_0, sim.erase_cnt[page]);
+    }
+    Shell_print(&serial_0, "\r\n");
+}
+
+/**
+ * @brief same write sequence is run with power cut on each flash operation.
+ * After remount every key must hold last confirmed value, interrupted write can hold either.
+ * @return 1 when sequence completed without reaching the cut
+ */
+static uint8_t power_loss_run(uint32_t cut_at) {
+    uint32_t model[PL_KEYS + 1];
+    uint8_t present[PL_KEYS + 1];
+    uint16_t key;
+    uint16_t wr_key = 0xFFFF;
+    uint32_t wr_val = 0;
+    uint32_t val;
+    uint32_t i;
+    uint8_t completed = 1;
+
+    /* same history before each cut, page close to compaction */
+    sim_blank();
+    (void)sim_power_on(SIM_NO_CUT);
+    for (i = 0; i < PL_SETUP_WRITES; ++i) {
+        key = (uint16_t)(i % (PL_KEYS + 1u));
+        model[key] = val_of(key, i);
+        present[key] = 1;
+        (void)KVstore.write(key, &model[key], sizeof(uint32_t));
+    }
+
+    sim.ops = 0;
+    sim.cut_at = cut_at;
+    for (i = 0; i < PL_WRITES; ++i) {
+        if (i == (PL_WRITES / 2u)) {
+            wr_key = PL_KEY_REMOVED;
+            if (KVstore.remove(wr_key) != KV_OK) {
+                completed = 0;
+                break;
+            }
+            present[wr_key] = 0;
+        }
+        wr_key = (uint16_t)(i % PL_KEYS);
+        wr_val = val_of(wr_key, PL_SETUP_WRITES + i);
+        if (KVstore.write(wr_key, &wr_val, sizeof(wr_val)) != KV_OK) {
+            completed = 0;
+            break;
+        }
+        model[wr_key] = wr_val;
+        KVstore.exe();
+        if (sim.power_off) {
+            completed = 0;
+            break;
+        }
+    }
+
+    /* reboot */
+    check("power loss remount", sim_power_on(SIM_NO_CUT) == KV_OK);
+    for (key = 0; key <= PL_KEYS; ++key) {
+        if (key == wr_key) {
+            if (key == PL_KEY_REMOVED) {
+                /* interrupted remove */
+                check("power loss remove", key_is(key, model[key]) ||
+                      (KVstore.read(key, &val, sizeof(val)) == KV_ERR_NOT_FOUND));
+            } else {
+                check("power loss interrupted key", key_is(key, model[key]) || key_is(key, wr_val));
+            }
+        } else if (present[key]) {
+            check("power loss key", key_is(key, model[key]));
+        } else {
+            check("power loss removed key", KVstore.read(key, &val, sizeof(val)) == KV_ERR_NOT_FOUND);
+        }
+    }
+    /* store must stay usable */
+    val = 0x12345678u;
+    check("power loss write after", (KVstore.write(0, &val, sizeof(val)) == KV_OK) && key_is(0, val));
+    check("power loss no pgerr", sim.pgerr == 0);
+    return completed;
+}
+
+static void test_power_loss(void) {
+    uint32_t cut_at = 1;
+
+    while (power_loss_run(cut_at) == 0) {
+        cut_at++;
+    }
+    Shell_print(&serial_0, "power loss: cut points tested ");
+    Shell_print_u32(&serial_0, cut_at - 1u);
+    Shell_print(&serial_0, "\r\n");
+}
+
+static void big_val(uint16_t key, uint32_t step, uint8_t *p_val) {
+    uint8_t i;
+
+    for (i = 0; i < BIG_LEN; ++i) {
+        p_val[i] = (uint8_t)((key * 31u) + step + i);
+    }
+}
+
+static uint8_t big_is(uint16_t key, uint32_t step) {
+    uint8_t rd[BIG_LEN];
+    uint8_t val[BIG_LEN];
+
+    big_val(key, step, val);
+    return (KVstore.read(key, rd, sizeof(rd)) == BIG_LEN) && (memcmp(rd, val, BIG_LEN) == 0);
+}
+
+/**
+ * @brief like power_loss_run(), but live data close to page capacity, so compaction runs
+ * on almost every write and interrupted record in the receiving page leaves no room to
+ * resume there. Recovery (resumed or restarted compaction) is cut once more.
+ * @return 1 when sequence completed without reaching the cut
+ */
+static uint8_t power_loss_big_run(uint32_t cut_at) {
+    uint32_t step[BIG_KEYS];
+    uint8_t val[BIG_LEN];
+    uint16_t key;
+    uint16_t wr_key = 0xFFFF;
+    uint32_t wr_step = 0;
+    uint32_t val32;
+    uint32_t i;
+    uint8_t completed = 1;
+
+    sim_blank();
+    (void)sim_power_on(SIM_NO_CUT);
+    for (key = 0; key < BIG_KEYS; ++key) {
+        step[key] = 0;
+        big_val(key, 0, val);
+        (void)KVstore.write(key, val, BIG_LEN);
+    }
+
+    sim.ops = 0;
+    sim.cut_at = cut_at;
+    for (i = 1; i <= BIG_WRITES; ++i) {
+        wr_key = (uint16_t)(i % BIG_KEYS);
+        wr_step = i;
+        big_val(wr_key, wr_step, val);
+        if (KVstore.write(wr_key, val, BIG_LEN) != KV_OK) {
+            completed = 0;
+            break;
+        }
+        step[wr_key] = wr_step;
+        KVstore.exe();
+        if (sim.power_off) {
+            completed = 0;
+            break;
+        }
+    }
+
+    /* reboot, power lost again while compaction is finished in background */
+    (void)sim_power_on(1u + ((cut_at * 7u) % BIG_RECUT_SPAN));
+    for (i = 0; (i < BIG_EXE_CALLS) && !sim.power_off; ++i) {
+        KVstore.exe();
+    }
+
+    check("big power loss remount", sim_power_on(SIM_NO_CUT) == KV_OK);
+    for (key = 0; key < BIG_KEYS; ++key) {
+        if (key == wr_key) {
+            check("big power loss interrupted key", big_is(key, step[key]) || big_is(key, wr_step));
+        } else {
+            check("big power loss key", big_is(key, step[key]));
+        }
+    }
+    /* store must stay usable, following compactions must not lose what recovery left */
+    val32 = 0x12345678u;
+    check("big power loss write after", (KVstore.write(0, &val32, sizeof(val32)) == KV_OK) && key_is(0, val32));
+    for (key = 1; key < BIG_KEYS; ++key) {
+        check("big power loss key after write", big_is(key, (key == wr_key) ? wr_step : step[key]) ||
+              ((key == wr_key) && big_is(key, step[key])));
+        big_val(key, BIG_WRITES + 1u, val);
+        check("big power loss write after", KVstore.write(key, val, BIG_LEN) == KV_OK);
+    }
+    check("big power loss remount after", sim_power_on(SIM_NO_CUT) == KV_OK);
+    for (key = 1; key < BIG_KEYS; ++key) {
+        check("big power loss key after", big_is(key, BIG_WRITES + 1u));
+    }
+    check("big power loss no pgerr", sim.pgerr == 0);
+    return completed;
+}
+
+static void test_power_loss_big(void) {
+    uint32_t cut_at = 1;
+
+    while (power_loss_big_run(cut_at) == 0) {
+        cut_at++;
+    }
+    Shell_print(&serial_0, "power loss, page nearly full: cut points tested ");
+    Shell_print_u32(&serial_0, cut_at - 1u);
+    Shell_print(&serial_0, "\r\n");
+}
+
+uint32_t kv_test_run(void) {
+    fails = 0;
+    Shell_print(&serial_0, "\r\nKVstore test\r\n");
+    test_basic();
+    test_wear();
+    test_power_loss();
+    test_power_loss_big();
+    Shell_print(&serial_0, (fails == 0) ? "KVstore test passed\r\n" : "KVstore test FAILED\r\n");
+    return fails;
+}
@@ -0,0 +1,33 @@
+/**
+ * @file KVstore_test.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief KVstore test against simulated flash in RAM. Simulated flash counts erase cycles
+ * per page, rejects programming of not erased half words (like STM32F1 PGERR) and cuts
+ * power after given number of flash operations.
+ *  - basic     : write, overwrite, remove, read back after remount
+ *  - wear      : many updates, erase cycles must be spread evenly over pages
+ *  - power loss: cut power on every flash operation of a write sequence, remount and check
+ *                each key has last confirmed value (or value of interrupted write)
+ *  - power loss with live data close to page capacity, compaction on almost every write,
+ *    recovery cut once more
+ *
+ * Also builds on host, tools/kvstore/kv_test_host.c.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef KV_STORE_TEST_H
+#define KV_STORE_TEST_H
+
+#include <stdint.h>
+
+/**
+ * @brief run all tests once and print result over serial_0. Serial must be initialized.
+ * Store is mounted on simulated flash, call KVstore_init() for real flash afterwards.
+ * @return number of failed checks
+ */
+uint32_t kv_test_run(void);
+
+#endif /* KV_STORE_TEST_H */
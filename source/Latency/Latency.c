@@ -0,0 +1,137 @@
+/**
+ * @file Latency.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief interrupt latency harness
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "Latency.h"
+/* dependencies */
+#include "stm32f1xx_hal.h"
+#include "TimOwner.h"
+#include "assert_gorenje.h"
+
+static uint8_t              start   (uint8_t prio);
+static void                 stop    (void);
+static const crit_stats_t   *stats  (void);
+
+void latency_sample(const uint32_t *p_frame, uint32_t cnt) __attribute__((used));
+
+//=========================================================
+/* create needed object  */
+static crit_stats_t latency_stats;
+static uint32_t latency_lfsr;
+static uint8_t latency_run_F;
+static const char latency_owner[] = "lat";
+
+const Latency_methods_t Latency = {
+    &start,
+    &stop,
+    &stats
+};
+//=========================================================
+
+/* constructor */
+void Latency_init(void) {
+    stop();
+    latency_lfsr = 0xACE1u;
+}
+
+/**
+ * @brief pass stacked frame to latency_sample(), lr keeps EXC_RETURN. CNT is read first
+ */
+__attribute__((naked)) void TIM2_IRQHandler(void) {
+    __asm volatile (
+        "movw   r1, #0x0024     \n"     // TIM2->CNT
+        "movt   r1, #0x4000     \n"
+        "ldr    r1, [r1]        \n"
+        "tst    lr, #4          \n"
+        "ite    eq              \n"
+        "mrseq  r0, msp         \n"
+        "mrsne  r0, psp         \n"
+        "b      latency_sample  \n"
+    );
+}
+
+void latency_sample(const uint32_t *p_frame, uint32_t cnt) {
+    const uint16_t ccr = (uint16_t)LATENCY_TIM->CCR1;
+
+    LATENCY_TIM->SR = ~TIM_SR_CC1IF;
+#if ( LATENCY_GPIO == 1 )
+    GPIOA->ODR ^= GPIO_PIN_1;
+#endif
+    Crit_hist_add(&latency_stats, (uint16_t)(cnt - ccr), p_frame[6]);
+
+    latency_lfsr = (latency_lfsr >> 1) ^ (-(latency_lfsr & 1u) & 0xB400u);
+    LATENCY_TIM->CCR1 = (uint16_t)(ccr + LATENCY_PERIOD + (latency_lfsr & (LATENCY_DITHER - 1u)));
+}
+
+//=========================================================
+/* methods implementation */
+
+static uint8_t start(uint8_t prio) {
+    uint32_t tim_clk;
+
+    stop();
+    if (TimOwner_claim(LATENCY_TIM, latency_owner) == 0) {
+        return 0;
+    }
+    latency_stats = (crit_stats_t){ 0 };
+
+    /* one timer tick per core cycle: timer clock is 2x PCLK1 when APB1 is divided */
+    tim_clk = HAL_RCC_GetPCLK1Freq();
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+        tim_clk *= 2u;
+    }
+    assert(tim_clk == SystemCoreClock);
+    __HAL_RCC_TIM2_CLK_ENABLE();
+    LATENCY_TIM->CR1 = 0;
+    LATENCY_TIM->PSC = (tim_clk / SystemCoreClock) - 1u;
+    LATENCY_TIM->ARR = 0xFFFFu;
+    LATENCY_TIM->CCR1 = LATENCY_PERIOD;
+#if ( LATENCY_GPIO == 1 )
+    {
+        GPIO_InitTypeDef gpio = { 0 };
+
+        __HAL_RCC_GPIOA_CLK_ENABLE();
+        gpio.Pin = GPIO_PIN_0;
+        gpio.Mode = GPIO_MODE_AF_PP;
+        gpio.Speed = GPIO_SPEED_FREQ_HIGH;
+        HAL_GPIO_Init(GPIOA, &gpio);
+        gpio.Pin = GPIO_PIN_1;
+        gpio.Mode = GPIO_MODE_OUTPUT_PP;
+        HAL_GPIO_Init(GPIOA, &gpio);
+        /* CH1 toggle on match */
+        LATENCY_TIM->CCMR1 = TIM_CCMR1_OC1M_0 | TIM_CCMR1_OC1M_1;
+        LATENCY_TIM->CCER = TIM_CCER_CC1E;
+    }
+#endif
+    LATENCY_TIM->EGR = TIM_EGR_UG;
+    LATENCY_TIM->SR = 0;
+    LATENCY_TIM->DIER = TIM_DIER_CC1IE;
+    NVIC_SetPriority(LATENCY_IRQn, prio);
+    NVIC_ClearPendingIRQ(LATENCY_IRQn);
+    NVIC_EnableIRQ(LATENCY_IRQn);
+    latency_run_F = 1;
+    LATENCY_TIM->CR1 = TIM_CR1_CEN;
+    return 1;
+}
+
+static void stop(void) {
+    /* TIM2 may be running for source/Logic */
+    if (latency_run_F == 0) {
+        return;
+    }
+    LATENCY_TIM->CR1 = 0;
+    LATENCY_TIM->DIER = 0;
+    NVIC_DisableIRQ(LATENCY_IRQn);
+    latency_run_F = 0;
+    TimOwner_release(LATENCY_TIM, latency_owner);
+}
+
+static const crit_stats_t *stats(void) {
+    return &latency_stats;
+}
@@ -0,0 +1,54 @@
+/**
+ * @file Latency.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief interrupt latency harness. TIM2 runs at core clock and fires compare events at
+ * dithered intervals, TIM2 interrupt reads CNT on entry, so CNT - CCR1 is the latency in
+ * core cycles from hardware event to first handler instruction. Longest one is stored with
+ * the interrupted PC, which points right after the code that held it off.
+ *
+ * Interrupt priority is set at start, so latency seen at any level can be measured against
+ * current priority plan (USART1, SysTick 0, TIM4 1, FLASH 3). Minimum is the baseline
+ * (exception entry and handler stub), the rest comes from masking (source/Crit) and
+ * higher or equal priority interrupts.
+ *
+ * With LATENCY_GPIO compare also toggles PA0 (TIM2_CH1) in hardware and handler toggles
+ * PA1, latency can be checked with a scope. Shell command "lat" reports all histograms.
+ * TIM2 is shared with source/Logic (source/TimOwner), start() refuses while analyzer runs.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stdint.h>
+
+#include "Crit.h"
+
+#define LATENCY_TIM             TIM2
+#define LATENCY_IRQn            TIM2_IRQn
+#define LATENCY_PRIO_DEFAULT    1u
+#define LATENCY_PERIOD          4000u   // core cycles between events, 2 kHz at 8 MHz
+#define LATENCY_DITHER          256u    // added to period, power of 2
+#define LATENCY_GPIO            0
+
+/**
+ * @brief struct of all available methods of this module
+ */
+typedef struct _Latency_methods_t{
+    /* clears statistics, returns 0 when TIM2 is held by source/Logic */
+    uint8_t             (*start)    (uint8_t prio);
+    void                (*stop)     (void);
+    const crit_stats_t  *(*stats)   (void);             // max_pc: interrupted PC
+}Latency_methods_t;
+
+extern const Latency_methods_t Latency;
+
+/**
+ * @brief harness stopped
+ */
+void Latency_init(void);
+
+#endif /* LATENCY_H */
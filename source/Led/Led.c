@@ -0,0 +1,156 @@
+/**
+ * @file Led.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief status LED pattern engine
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "Led.h"
+/* dependencies */
+#include "Timebase.h"
+#include "Gpio.h"
+#include "Crit.h"
+#include "assert_gorenje.h"
+
+#define LED_TICK_US         (LED_TICK_MS * 1000u)
+#define LED_CODE_ON         5u      // ticks
+#define LED_CODE_OFF        5u
+#define LED_CODE_PAUSE      30u
+
+/* open drain, LED to Vcc */
+#define LED_ON()            GPIO_CLR(GPIO_LED)
+#define LED_OFF()           GPIO_SET(GPIO_LED)
+
+typedef enum _led_mode_t{
+    LED_MODE_OFF = 0,
+    LED_MODE_PATTERN,
+    LED_MODE_ACTIVITY
+}led_mode_t;
+
+typedef struct _led_ctrl_t{
+    const uint8_t   *p_steps;
+    uint8_t         cnt;
+    uint8_t         idx;        // current step, even: on
+    uint8_t         left;       // ticks left in current step
+    uint8_t         on_F;
+    led_mode_t      mode;
+}led_ctrl_t;
+
+static void play        (const led_pattern_t *p_pattern);
+static void code        (uint8_t code);
+static void activity    (void);
+static void off         (void);
+static void tick        (void);
+
+//=========================================================
+/* create needed object  */
+static const uint8_t heartbeat_steps[] = { 2, 3, 2, 13 };
+const led_pattern_t LED_HEARTBEAT = { heartbeat_steps, sizeof(heartbeat_steps) };
+
+volatile uint8_t led_activity_F;
+
+static uint8_t led_code_steps[2u * LED_CODE_MAX];
+static led_ctrl_t led;
+
+const Led_methods_t Led = {
+    &play,
+    &code,
+    &activity,
+    &off
+};
+//=========================================================
+
+/* constructor */
+void Led_init(void) {
+    LED_OFF();
+    play(&LED_HEARTBEAT);
+    Timebase.deadline(TIMEBASE_CH_LED, LED_TICK_US, &tick);
+}
+
+/**
+ * @brief Timebase callback (TIM4 interrupt), re-arms itself
+ */
+static void tick(void) {
+    Timebase.deadline(TIMEBASE_CH_LED, LED_TICK_US, &tick);
+
+    switch (led.mode) {
+    case LED_MODE_PATTERN:
+        if (led.left == 0) {
+            led.idx = (uint8_t)((led.idx + 1u) % led.cnt);
+            led.left = led.p_steps[led.idx];
+            if ((led.idx & 1u) == 0) {
+                LED_ON();
+            } else {
+                LED_OFF();
+            }
+        }
+        led.left--;
+        break;
+    case LED_MODE_ACTIVITY:
+        /* pulse needs an off tick after it, traffic in the meantime is kept */
+        if ( (led.on_F == 0) && (led_activity_F != 0) ) {
+            led_activity_F = 0;
+            led.on_F = 1;
+            LED_ON();
+        } else {
+            led.on_F = 0;
+            LED_OFF();
+        }
+        break;
+    default:
+        LED_OFF();
+        break;
+    }
+}
+
+//=========================================================
+/* methods implementation */
+
+static void play(const led_pattern_t *p_pattern) {
+    crit_state_t primask;
+
+    assert(p_pattern != NULL);
+    assert( (p_pattern->cnt != 0) && ((p_pattern->cnt & 1u) == 0) );
+
+    primask = Crit_enter();
+    led.p_steps = p_pattern->p_steps;
+    led.cnt = p_pattern->cnt;
+    /* start with first step on next tick */
+    led.idx = (uint8_t)(led.cnt - 1u);
+    led.left = 0;
+    led.mode = LED_MODE_PATTERN;
+    Crit_exit(primask);
+}
+
+static void code(uint8_t code) {
+    static led_pattern_t pattern;
+    uint8_t i;
+
+    assert( (code != 0) && (code <= LED_CODE_MAX) );
+    if ( (code == 0) || (code > LED_CODE_MAX) ) {
+        return;
+    }
+    /* engine may still play previous code from the same buffer */
+    off();
+    for (i = 0; i < code; ++i) {
+        led_code_steps[2u * i] = LED_CODE_ON;
+        led_code_steps[(2u * i) + 1u] = LED_CODE_OFF;
+    }
+    led_code_steps[(2u * code) - 1u] = LED_CODE_PAUSE;
+    pattern.p_steps = led_code_steps;
+    pattern.cnt = (uint8_t)(2u * code);
+    play(&pattern);
+}
+
+static void activity(void) {
+    led_activity_F = 0;
+    led.on_F = 0;
+    led.mode = LED_MODE_ACTIVITY;
+}
+
+static void off(void) {
+    led.mode = LED_MODE_OFF;
+}
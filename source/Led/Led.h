@@ -0,0 +1,65 @@
+/**
+ * @file Led.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief status LED (PC13) pattern engine. Runs entirely from Timebase deadline callback
+ * (TIM4 interrupt) every LED_TICK_MS, no main loop cost. Modes:
+ *  - pattern  : repeat on/off durations, i.e. heartbeat
+ *  - code     : error code, n blinks and a pause, repeated
+ *  - activity : pulse on Serial Rx/Tx (Led_activity() from Serial callbacks), one tick on
+ *               and one off, so continuous traffic blinks at 1 / (2 * LED_TICK_MS), idle is off
+ *  - off
+ * Shell command "led" switches modes.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef LED_H
+#define LED_H
+
+#include <stdint.h>
+
+#define LED_TICK_MS         50u
+#define LED_CODE_MAX        15u
+
+/* error codes */
+#define LED_CODE_FAULT      3u      // crash dump was reported at boot (source/Fault)
+
+/**
+ * @brief repeating pattern: on, off, on, off ... durations in ticks, cnt is even
+ */
+typedef struct _led_pattern_t{
+    const uint8_t   *p_steps;
+    uint8_t         cnt;
+}led_pattern_t;
+
+extern const led_pattern_t LED_HEARTBEAT;
+
+/**
+ * @brief struct of all available methods of this module
+ */
+typedef struct _Led_methods_t{
+    void    (*play)     (const led_pattern_t *p_pattern);
+    void    (*code)     (uint8_t code);     // 1 .. LED_CODE_MAX blinks
+    void    (*activity) (void);             // pulse on serial traffic
+    void    (*off)      (void);
+}Led_methods_t;
+
+extern const Led_methods_t Led;
+
+extern volatile uint8_t led_activity_F;
+
+/**
+ * @brief mark serial activity, one store, safe from any interrupt
+ */
+static inline void Led_activity(void) {
+    led_activity_F = 1;
+}
+
+/**
+ * @brief start engine with heartbeat, needs Timebase
+ */
+void Led_init(void);
+
+#endif /* LED_H */
@@ -0,0 +1,89 @@
+/**
+ * @file Log.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief deferred logging
+ *
+ * frame : LOG_FRAME_START | uint8 len | varint fmt_id | varint arg * n
+ * varint: 7 bits per byte, LSB group first, bit 7 set if more bytes follow
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "Log.h"
+/* dependencies */
+#include "Crit.h"
+#include "stm32f1xx.h"
+#include "assert_gorenje.h"
+
+/* start + len + (id + args) * max varint size */
+#define LOG_FRAME_MAX       (2 + ((LOG_MAX_ARGS + 1) * 5))
+
+static void     write   (uint32_t fmt_id, const uint32_t *p_args, uint8_t nArgs);
+static uint32_t dropped (void);
+
+//=========================================================
+/* create needed object  */
+static serial_ctrl_desc_t *p_log_serial;
+static uint32_t log_dropped;
+
+Log_methods_t Log = {
+    &write,
+    &dropped
+};
+//=========================================================
+
+/* constructor */
+void Log_init(serial_ctrl_desc_t *p_serial) {
+    assert(p_serial != NULL);
+
+    p_log_serial = p_serial;
+    log_dropped = 0;
+}
+
+//=========================================================
+/* methods implementation */
+
+static inline uint8_t varint_put(uint8_t *pDest, uint32_t val) {
+    uint8_t n = 0;
+
+    while (val >= 0x80u) {
+        pDest[n++] = (uint8_t)(val | 0x80u);
+        val >>= 7;
+    }
+    pDest[n++] = (uint8_t)val;
+    return n;
+}
+
+static void write(uint32_t fmt_id, const uint32_t *p_args, uint8_t nArgs) {
+    uint8_t frame[LOG_FRAME_MAX];
+    uint8_t len = 2;
+    uint8_t i;
+    crit_state_t primask;
+
+    if (p_log_serial == NULL) {
+        return;
+    }
+
+    len += varint_put(&frame[len], fmt_id);
+    for (i = 0; i < nArgs; ++i) {
+        len += varint_put(&frame[len], p_args[i]);
+    }
+    frame[0] = LOG_FRAME_START;
+    frame[1] = len - 2;
+
+    /* whole frame or nothing. Messages from interrupts must not split a frame */
+    primask = Crit_enter();
+    if (Serial.Tx_free(p_log_serial) >= len) {
+        Serial.write(p_log_serial, frame, len);
+    } else {
+        log_dropped++;
+    }
+    Crit_exit(primask);
+}
+
+static uint32_t dropped(void) {
+    return log_dropped;
+}
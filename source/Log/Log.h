@@ -0,0 +1,101 @@
+/**
+ * @file Log.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief deferred logging. Format strings are placed in not loaded ELF section (.log_fmt),
+ * so they cost no flash. Device send only string id (its address in .log_fmt) and raw
+ * arguments as varints. Text is formatted on PC by tools/log/log_decode.py using the .elf
+ *
+ * Only integer arguments are supported (%d %i %u %x %X %c and their l/h variants). Every
+ * argument is sent as 32 bit value.
+ *
+ * usage: LOG_INF("adc ch%u = %d mV", ch, mv);
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdint.h>
+
+#include "Serial.h"
+
+//=======================================================================================
+/**
+ * @brief messages with level above this are removed at compile time
+ */
+#define LOG_LEVEL           LOG_LEVEL_DBG
+
+/**
+ * @brief max number of arguments per message
+ */
+#define LOG_MAX_ARGS        8
+//=======================================================================================
+
+#define LOG_LEVEL_NONE      0
+#define LOG_LEVEL_ERR       1
+#define LOG_LEVEL_WRN       2
+#define LOG_LEVEL_INF       3
+#define LOG_LEVEL_DBG       4
+
+/**
+ * @brief first byte of every log frame. Not used in text, so PC can tell frames from
+ * other serial output
+ */
+#define LOG_FRAME_START     0x1Eu
+
+/**
+ * @brief struct of all available methods of this module
+ */
+typedef struct _Log_methods_t{
+    void     (*write)     (uint32_t fmt_id, const uint32_t *p_args, uint8_t nArgs);
+    uint32_t (*dropped)   (void); // number of messages dropped because Tx buffer was full
+}Log_methods_t;
+
+extern Log_methods_t Log;
+
+/**
+ * @brief set serial port used for log output
+ * @param p_serial  : pointer to serial descriptor
+ */
+void Log_init(serial_ctrl_desc_t *p_serial);
+
+/* place format string into .log_fmt section and send its address. Level is stored as
+   first character of the string. */
+#define LOG_(lvl, fmt, ...) do {                                                        \
+        static const char _log_fmt[] __attribute__((section(".log_fmt"), used)) = lvl fmt; \
+        const uint32_t _log_args[] = { 0, ##__VA_ARGS__ };                              \
+        _Static_assert( (sizeof(_log_args) / sizeof(uint32_t)) <= (LOG_MAX_ARGS + 1),   \
+            "too many log arguments");                                                  \
+        Log.write((uint32_t)_log_fmt, &_log_args[1],                                     \
+            (uint8_t)((sizeof(_log_args) / sizeof(uint32_t)) - 1));                     \
+    } while (0)
+
+#if ( LOG_LEVEL >= LOG_LEVEL_ERR )
+    #define LOG_ERR(fmt, ...)   LOG_("E", fmt, ##__VA_ARGS__)
+#else
+    #define LOG_ERR(fmt, ...)
+#endif
+
+#if ( LOG_LEVEL >= LOG_LEVEL_WRN )
+    #define LOG_WRN(fmt, ...)   LOG_("W", fmt, ##__VA_ARGS__)
+#else
+    #define LOG_WRN(fmt, ...)
+#endif
+
+#if ( LOG_LEVEL >= LOG_LEVEL_INF )
+    #define LOG_INF(fmt, ...)   LOG_("I", fmt, ##__VA_ARGS__)
+#else
+    #define LOG_INF(fmt, ...)
+#endif
+
+#if ( LOG_LEVEL >= LOG_LEVEL_DBG )
+    #define LOG_DBG(fmt, ...)   LOG_("D", fmt, ##__VA_ARGS__)
+#else
+    #define LOG_DBG(fmt, ...)
+#endif
+
+#endif /* LOG_H */
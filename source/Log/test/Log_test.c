@@ -0,0 +1,81 @@
+#include "Log_test.h"
+#include "Log.h"
+#include "Serial.h"
+#include "CycleCnt.h"
+/* HAL dependencies */
+#include "stm32f1xx_hal.h"
+
+#include <string.h>
+#include "num_str_convert.h"
+
+#define TEST_MSG_CNT    32
+/* uart 8N1 -> 10 bits per byte */
+#define LINE_BYTES_PER_S(baud)  ((baud) / 10)
+
+static void wait_tx_idle(void) {
+    /* flag is changed from uart interrupt */
+    while (*(volatile uint8_t *)&serial_0.Tx_active_F != 0) {
+        /* wait */
+    }
+}
+
+static void print_result(const char *p_name, uint32_t cycles, uint32_t bytes) {
+    uint8_t num_str[12];
+
+    Serial.print(&serial_0, p_name);
+    Serial.print(&serial_0, ": cycles/msg ");
+    num2str(cycles / TEST_MSG_CNT, num_str);
+    Serial.print(&serial_0, num_str);
+    Serial.print(&serial_0, ", bytes/msg ");
+    num2str(bytes / TEST_MSG_CNT, num_str);
+    Serial.print(&serial_0, num_str);
+    Serial.print(&serial_0, ", msg/s ");
+    num2str((LINE_BYTES_PER_S(115200) * TEST_MSG_CNT) / bytes, num_str);
+    Serial.println(&serial_0, num_str);
+    wait_tx_idle();
+}
+
+void log_test_run(void) {
+    static uint8_t serial_msg[40];
+    static uint8_t num_str[12];
+    uint32_t i;
+    uint32_t start;
+    uint32_t txt_cycles = 0, txt_bytes = 0;
+    uint32_t log_cycles = 0, log_bytes = 0;
+    uint16_t free_before;
+
+    CycleCnt_init();
+    Log_init(&serial_0);
+
+    for (i = 0; i < TEST_MSG_CNT; ++i) {
+        /* text logging, same as Serial_test upTime task */
+        wait_tx_idle();
+        free_before = Serial.Tx_free(&serial_0);
+        start = CycleCnt_get();
+        strcpy(serial_msg, "upTime: ");
+        num2str(i * 1000u, num_str);
+        strcat(serial_msg, num_str);
+        strcat(serial_msg, " ms, state ");
+        num2str(i & 7u, num_str);
+        strcat(serial_msg, num_str);
+        strcat(serial_msg, "\r\n");
+        Serial.write(&serial_0, serial_msg, strlen(serial_msg));
+        txt_cycles += CycleCnt_get() - start;
+        /* first byte is already moved to uart by the write */
+        txt_bytes += free_before - Serial.Tx_free(&serial_0) + 1;
+    }
+
+    for (i = 0; i < TEST_MSG_CNT; ++i) {
+        wait_tx_idle();
+        free_before = Serial.Tx_free(&serial_0);
+        start = CycleCnt_get();
+        LOG_INF("upTime: %u ms, state %u", i * 1000u, i & 7u);
+        log_cycles += CycleCnt_get() - start;
+        log_bytes += free_before - Serial.Tx_free(&serial_0) + 1;
+    }
+
+    wait_tx_idle();
+    Serial.print(&serial_0, "\r\n");
+    print_result("text", txt_cycles, txt_bytes);
+    print_result("log ", log_cycles, log_bytes);
+}
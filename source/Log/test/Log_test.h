@@ -0,0 +1,22 @@
+/**
+ * @file Log_test.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief compare deferred logging against text logging (num2str + Serial.write).
+ * Report CPU cycles and bytes on the line per message. Line rate is what limits
+ * message throughput, so msg/s is calculated from bytes per message.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef LOG_TEST_H
+#define LOG_TEST_H
+
+/**
+ * @brief run benchmark once and print result over serial_0. Serial must be initialized.
+ * Log frames in the output are decoded by tools/log/log_decode.py, text is passed through.
+ */
+void log_test_run(void);
+
+#endif /* LOG_TEST_H */
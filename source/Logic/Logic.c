@@ -0,0 +1,361 @@
+/**
+ * @file Logic.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief logic analyzer: timer triggered DMA port sampling, run-length stream
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "Logic.h"
+/* dependencies */
+#include "main.h"
+#include "CycleCnt.h"
+#include "Startup.h"
+#include "TimOwner.h"
+#include "assert_gorenje.h"
+
+#define BUF_LEN         (2u * LOGIC_SEG)
+#define FRAME_HDR       4u
+#define RECORD_MAX      13u         // gap (1 + 5) and value record (5 + 2)
+
+typedef struct _logic_hdr_t{
+    uint32_t    tim_clk;
+    uint32_t    ticks;
+    uint8_t     port;
+    uint8_t     reserved;
+    uint16_t    mask;
+}logic_hdr_t;
+
+typedef struct _logic_ctrl_t{
+    serial_ctrl_desc_t  *p_serial;
+    uint32_t            limit;      // samples, 0: until stop
+    uint32_t            run;        // length of current run
+    uint32_t            gap;        // lost samples not reported yet
+    uint32_t            start_cycles;
+    uint16_t            rd;         // next sample in ping-pong buffer
+    uint16_t            value;      // of current run
+    uint16_t            mask;
+    uint8_t             run_F;
+    uint8_t             hdr_F;      // header frame pending
+    uint8_t             end_F;      // end frame pending
+    uint8_t             seq;
+}logic_ctrl_t;
+
+static uint8_t              start   (serial_ctrl_desc_t *p_serial, uint32_t rate, char port,
+                                     uint16_t mask, uint32_t samples);
+static void                 stop    (void);
+static const logic_stats_t  *stats  (void);
+static uint8_t              exe     (void);
+
+//=========================================================
+/* create needed object  */
+static uint16_t logic_buf[BUF_LEN];
+/* only bytes between tail and head are ever read */
+NOINIT static uint8_t logic_out[LOGIC_OUT_SIZE];
+static volatile uint16_t logic_head;    // written by DMA interrupt only
+static volatile uint16_t logic_tail;    // written by main loop only
+
+static logic_ctrl_t logic;
+static logic_stats_t logic_stats;
+static logic_hdr_t logic_hdr;
+static const char logic_owner[] = "la";
+
+const Logic_methods_t Logic = {
+    &start,
+    &stop,
+    &stats,
+    &exe
+};
+//=========================================================
+
+/* constructor */
+void Logic_init(void) {
+    CycleCnt_init();
+    logic.p_serial = NULL;
+    logic.run_F = 0;
+}
+
+static uint8_t varint(uint8_t *p_dst, uint32_t value) {
+    uint8_t n = 0;
+
+    while (value >= 0x80u) {
+        p_dst[n++] = (uint8_t)(value | 0x80u);
+        value >>= 7;
+    }
+    p_dst[n++] = (uint8_t)value;
+    return n;
+}
+
+/**
+ * @brief queue one run, pending gap goes first. Full ring turns the run into a gap
+ */
+static void emit(uint32_t run, uint16_t value) {
+    uint8_t rec[RECORD_MAX];
+    uint16_t head = logic_head;
+    uint8_t n = 0;
+    uint8_t i;
+
+    if (logic.gap != 0) {
+        rec[n++] = 0;
+        n += varint(&rec[n], logic.gap);
+    }
+    if (run != 0) {
+        n += varint(&rec[n], run);
+        rec[n++] = (uint8_t)value;
+        rec[n++] = (uint8_t)(value >> 8);
+    }
+    if (logic.p_serial != NULL) {
+        if ((uint16_t)(LOGIC_OUT_SIZE - (uint16_t)(head - logic_tail)) < n) {
+            logic.gap += run;
+            logic_stats.lost += run;
+            return;
+        }
+        for (i = 0; i < n; ++i) {
+            logic_out[(uint16_t)(head + i) & (LOGIC_OUT_SIZE - 1u)] = rec[i];
+        }
+        /* bytes are written before consumer can see them */
+        __DMB();
+        logic_head = (uint16_t)(head + n);
+    }
+    logic_stats.bytes += n;
+    logic.gap = 0;
+}
+
+static void halt(void) {
+    LOGIC_TIM->CR1 = 0;
+    LOGIC_TIM->DIER = 0;
+    LOGIC_DMA->CCR = 0;
+    NVIC_DisableIRQ(LOGIC_IRQn);
+
+    emit(logic.run, logic.value);
+    logic.run = 0;
+    logic_stats.elapsed = CycleCnt_get() - logic.start_cycles;
+    logic.run_F = 0;
+    logic.end_F = (uint8_t)(logic.p_serial != NULL);
+    TimOwner_release(LOGIC_TIM, logic_owner);
+}
+
+static void compress(const uint16_t *p_sample, uint16_t cnt) {
+    uint16_t value;
+    uint16_t i;
+
+    if ( (logic.limit != 0) && (cnt > (logic.limit - logic_stats.samples)) ) {
+        cnt = (uint16_t)(logic.limit - logic_stats.samples);
+    }
+    for (i = 0; i < cnt; ++i) {
+        value = p_sample[i] & logic.mask;
+        if (value == logic.value) {
+            logic.run++;
+            continue;
+        }
+        if (logic.run != 0) {
+            emit(logic.run, logic.value);
+        }
+        logic.value = value;
+        logic.run = 1;
+    }
+    logic_stats.samples += cnt;
+}
+
+/**
+ * @brief compress everything DMA wrote since last call
+ */
+static void service(void) {
+    uint32_t start_cycles = CycleCnt_get();
+    uint32_t isr = DMA1->ISR & (DMA_ISR_HTIF7 | DMA_ISR_TCIF7);
+    uint16_t pos;
+
+    DMA1->IFCR = DMA_IFCR_CGIF7;
+    if (isr == (DMA_ISR_HTIF7 | DMA_ISR_TCIF7)) {
+        /* more than half a buffer late, some samples were overwritten before compressed */
+        logic_stats.lost += LOGIC_SEG;
+    }
+    pos = (uint16_t)(BUF_LEN - LOGIC_DMA->CNDTR);
+    if (pos < logic.rd) {
+        compress(&logic_buf[logic.rd], (uint16_t)(BUF_LEN - logic.rd));
+        logic.rd = 0;
+    }
+    compress(&logic_buf[logic.rd], (uint16_t)(pos - logic.rd));
+    logic.rd = pos;
+
+    logic_stats.busy += (CycleCnt_get() - start_cycles) + LOGIC_ISR_OVERHEAD;
+    if ( (logic.limit != 0) && (logic_stats.samples >= logic.limit) ) {
+        halt();
+    }
+}
+
+void DMA1_Channel7_IRQHandler(void) {
+    service();
+}
+
+/**
+ * @brief frame header and payload, without payload when p_data is NULL (caller writes it)
+ */
+static void frame_write(uint8_t type, const uint8_t *p_data, uint8_t len) {
+    uint8_t hdr[FRAME_HDR] = { 'L', type, len, logic.seq++ };
+
+    Serial.write(logic.p_serial, hdr, FRAME_HDR);
+    if (p_data != NULL) {
+        Serial.write(logic.p_serial, (uint8_t *)p_data, len);
+    }
+}
+
+//=========================================================
+/* methods implementation */
+
+static uint8_t start(serial_ctrl_desc_t *p_serial, uint32_t rate, char port, uint16_t mask,
+                     uint32_t samples) {
+    GPIO_TypeDef *p_port = ((port == 'B') || (port == 'b')) ? GPIOB : GPIOA;
+    uint32_t tim_clk;
+    uint32_t ticks;
+
+    assert(rate != 0);
+
+    stop();
+    if (logic.end_F != 0) {
+        /* previous end frame is not sent yet */
+        return 0;
+    }
+    if (TimOwner_claim(LOGIC_TIM, logic_owner) == 0) {
+        return 0;
+    }
+
+    /* timer clock is 2x PCLK1 when APB1 is divided */
+    tim_clk = HAL_RCC_GetPCLK1Freq();
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+        tim_clk *= 2u;
+    }
+    ticks = tim_clk / rate;
+    assert( (ticks >= 2u) && (ticks <= 0x10000u) );
+    if (ticks < 2u) {
+        ticks = 2u;
+    } else if (ticks > 0x10000u) {
+        ticks = 0x10000u;
+    }
+    if (mask == 0) {
+        mask = (p_port == GPIOB) ? LOGIC_MASK_B : LOGIC_MASK_A;
+    }
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_TIM2_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    logic_stats = (logic_stats_t){ 0 };
+    logic.p_serial = p_serial;
+    logic.limit = samples;
+    logic.run = 0;
+    logic.gap = 0;
+    logic.rd = 0;
+    logic.mask = mask;
+    logic.seq = 0;
+    logic_head = 0;
+    logic_tail = 0;
+
+    logic_hdr.tim_clk = tim_clk;
+    logic_hdr.ticks = ticks;
+    logic_hdr.port = (p_port == GPIOB) ? 'B' : 'A';
+    logic_hdr.reserved = 0;
+    logic_hdr.mask = mask;
+    logic.hdr_F = (uint8_t)(p_serial != NULL);
+
+    LOGIC_TIM->CR1 = 0;
+    LOGIC_TIM->PSC = 0;
+    LOGIC_TIM->ARR = ticks - 1u;
+    LOGIC_TIM->CCR2 = 0;
+    LOGIC_TIM->CCMR1 = 0;       // CC2 output frozen, compare event only
+    LOGIC_TIM->EGR = TIM_EGR_UG;
+    LOGIC_TIM->SR = 0;
+
+    LOGIC_DMA->CCR = 0;
+    DMA1->IFCR = DMA_IFCR_CGIF7;
+    LOGIC_DMA->CPAR = (uint32_t)&p_port->IDR;
+    LOGIC_DMA->CMAR = (uint32_t)logic_buf;
+    LOGIC_DMA->CNDTR = BUF_LEN;
+    LOGIC_DMA->CCR = DMA_CCR_PSIZE_0 | DMA_CCR_MSIZE_0 | DMA_CCR_MINC | DMA_CCR_CIRC |
+                     DMA_CCR_HTIE | DMA_CCR_TCIE | DMA_CCR_EN;
+
+    NVIC_SetPriority(LOGIC_IRQn, LOGIC_IRQ_PRIO);
+    NVIC_ClearPendingIRQ(LOGIC_IRQn);
+    NVIC_EnableIRQ(LOGIC_IRQn);
+
+    logic.start_cycles = CycleCnt_get();
+    logic.run_F = 1;
+    LOGIC_TIM->DIER = TIM_DIER_CC2DE;
+    LOGIC_TIM->CR1 = TIM_CR1_CEN;
+    return 1;
+}
+
+static void stop(void) {
+    if (logic.run_F == 0) {
+        return;
+    }
+    NVIC_DisableIRQ(LOGIC_IRQn);
+    LOGIC_TIM->CR1 = 0;
+    /* samples of unfinished half */
+    service();
+    if (logic.run_F != 0) {
+        halt();
+    }
+}
+
+static const logic_stats_t *stats(void) {
+    if (logic.run_F != 0) {
+        logic_stats.elapsed = CycleCnt_get() - logic.start_cycles;
+    }
+    return &logic_stats;
+}
+
+static uint8_t exe(void) {
+    serial_ctrl_desc_t *p_serial = logic.p_serial;
+    uint16_t tail = logic_tail;
+    uint16_t avail;
+    uint16_t space;
+    uint16_t len;
+    uint16_t first;
+
+    if (p_serial == NULL) {
+        return 0;
+    }
+    if (logic.hdr_F != 0) {
+        if (Serial.Tx_free(p_serial) < (FRAME_HDR + sizeof(logic_hdr))) {
+            return 1;
+        }
+        frame_write('H', (const uint8_t *)&logic_hdr, sizeof(logic_hdr));
+        logic.hdr_F = 0;
+    }
+
+    avail = (uint16_t)(logic_head - tail);
+    space = Serial.Tx_free(p_serial);
+    space = (space > FRAME_HDR) ? (uint16_t)(space - FRAME_HDR) : 0u;
+    /* small frames only while link is idle, overhead grows otherwise */
+    if ( (avail != 0) && (space >= ((avail < LOGIC_FRAME_MIN) ? avail : LOGIC_FRAME_MIN)) ) {
+        len = (avail < space) ? avail : space;
+        len = (len < 0xFFu) ? len : 0xFFu;
+        frame_write('D', NULL, (uint8_t)len);
+        /* payload may wrap at the end of the ring */
+        first = (uint16_t)(LOGIC_OUT_SIZE - (tail & (LOGIC_OUT_SIZE - 1u)));
+        first = (len < first) ? len : first;
+        Serial.write(p_serial, &logic_out[tail & (LOGIC_OUT_SIZE - 1u)], first);
+        if (len > first) {
+            Serial.write(p_serial, logic_out, (size_t)(len - first));
+        }
+        /* bytes are copied before producer can reuse them */
+        __DMB();
+        logic_tail = (uint16_t)(tail + len);
+        return 1;
+    }
+
+    if ( (logic.end_F != 0) && (avail == 0) ) {
+        if (Serial.Tx_free(p_serial) < (FRAME_HDR + sizeof(logic_stats_t))) {
+            return 1;
+        }
+        frame_write('E', (const uint8_t *)&logic_stats, sizeof(logic_stats_t));
+        logic.end_F = 0;
+        logic.p_serial = NULL;
+        return 0;
+    }
+    return 1;
+}
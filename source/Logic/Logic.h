@@ -0,0 +1,81 @@
+/**
+ * @file Logic.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief logic analyzer. TIM2 compare 2 event (CCR2 = 0, once per timer period) triggers
+ * DMA1 channel 7 read of GPIOA->IDR or GPIOB->IDR into a ping-pong buffer at fixed rate,
+ * no CPU per sample. Half and full transfer interrupt run-length compresses samples
+ * written so far into an output ring, main loop streams the ring over serial in frames. Samples are masked first, so pins that
+ * are not probed (USART1 on PA9/PA10, SWD) do not break runs.
+ *
+ * Stream (little endian), every frame: 'L', type, len (uint8), seq (uint8), len bytes
+ *  - 'H' header: timer clock (uint32), ticks per sample (uint32), port ('A'/'B'), 0,
+ *    mask (uint16)
+ *  - 'D' data: records, may continue in next data frame
+ *  - 'E' end: samples, lost, bytes, busy cycles, elapsed cycles (uint32 each)
+ * Record: run as LEB128 varint then value (uint16); run 0 is a gap: varint count of
+ * samples lost to full output ring (link slower than signal activity).
+ *
+ * Sustained rate is limited by link rate over compression ratio: quiet signals compress
+ * to almost nothing, every change costs 3 .. 7 bytes. tools/logic/la_capture.py starts
+ * capture and writes VCD. TIM2 is shared with source/Latency (source/TimOwner), start()
+ * refuses while latency harness runs.
+ * Shell command "la".
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef LOGIC_H
+#define LOGIC_H
+
+#include <stdint.h>
+
+#include "Serial.h"
+
+#define LOGIC_TIM           TIM2
+#define LOGIC_DMA           DMA1_Channel7       // TIM2_CH2, TIM2_UP channel 2 is source/Capture
+#define LOGIC_IRQn          DMA1_Channel7_IRQn
+#define LOGIC_IRQ_PRIO      2u
+
+#define LOGIC_SEG           128u                // samples per half buffer
+#define LOGIC_FRAME_MIN     32u                 // smaller data frames only when link is idle
+#define LOGIC_OUT_SIZE      2048u               // output ring, power of 2
+
+/* not probed on port A: USART1 PA9/PA10, SWD PA13/PA14 */
+#define LOGIC_MASK_A        0x99FFu
+#define LOGIC_MASK_B        0xFFFFu
+
+/* exception entry and exit, not seen by cycle counter in handler */
+#define LOGIC_ISR_OVERHEAD  24u
+
+typedef struct _logic_stats_t{
+    uint32_t    samples;
+    uint32_t    lost;       // samples in gaps
+    uint32_t    bytes;      // compressed
+    uint32_t    busy;       // cycles in DMA interrupt
+    uint32_t    elapsed;    // cycles while running
+}logic_stats_t;
+
+/**
+ * @brief struct of all available methods of this module
+ */
+typedef struct _Logic_methods_t{
+    /* port 'A' or 'B', mask 0: port default, samples 0: until stop. p_serial NULL only
+       compresses and counts, for benchmarks. Returns 0 when TIM2 is held by source/Latency
+       or end frame of previous capture is not sent yet */
+    uint8_t             (*start)    (serial_ctrl_desc_t *p_serial, uint32_t rate, char port,
+                                     uint16_t mask, uint32_t samples);
+    void                (*stop)     (void);
+    const logic_stats_t *(*stats)   (void);
+    uint8_t             (*exe)      (void);     // call from main loop, returns 1 while streaming
+}Logic_methods_t;
+
+extern const Logic_methods_t Logic;
+
+/**
+ * @brief analyzer stopped
+ */
+void Logic_init(void);
+
+#endif /* LOGIC_H */
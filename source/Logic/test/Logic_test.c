@@ -0,0 +1,58 @@
+#include "Logic_test.h"
+#include "Logic.h"
+#include "Wave.h"
+#include "Serial.h"
+#include "Shell.h"
+#include "stm32f1xx_hal.h"
+
+static const uint32_t test_rate[] = { 10000, 50000, 100000, 200000, 400000, 500000, 800000, 1000000 };
+
+static void run(uint32_t rate) {
+    const logic_stats_t *p_stats;
+    uint32_t start;
+
+    Logic.start(NULL, rate, 'A', 0, 0);
+    start = HAL_GetTick();
+    while ((HAL_GetTick() - start) < LOGIC_TEST_MS) {
+    }
+    Logic.stop();
+
+    p_stats = Logic.stats();
+    Shell_print_u32(&serial_0, rate);
+    Shell_print(&serial_0, " ");
+    Shell_print_u32(&serial_0, (p_stats->elapsed != 0) ?
+                    (uint32_t)(((uint64_t)p_stats->busy * 1000u) / p_stats->elapsed) : 0);
+    Shell_print(&serial_0, " ");
+    Shell_print_u32(&serial_0, (p_stats->samples != 0) ? ((p_stats->busy * 10u) / p_stats->samples) : 0);
+    Shell_print(&serial_0, " ");
+    Shell_print_u32(&serial_0, (p_stats->samples != 0) ?
+                    (uint32_t)(((uint64_t)p_stats->bytes * 1000u) / p_stats->samples) : 0);
+    Shell_print(&serial_0, " ");
+    /* 10 bits per byte on the line */
+    Shell_print_u32(&serial_0, (p_stats->bytes != 0) ?
+                    (uint32_t)(((uint64_t)(LOGIC_TEST_BAUD / 10u) * p_stats->samples) / p_stats->bytes) : 0);
+    Shell_print(&serial_0, (p_stats->lost != 0) ? " lost\r\n" : "\r\n");
+}
+
+void logic_test_run(void) {
+    uint8_t i;
+
+    Shell_print(&serial_0, "\r\nlogic analyzer benchmark, core clock ");
+    Shell_print_u32(&serial_0, SystemCoreClock / 1000000u);
+    Shell_print(&serial_0, " MHz\r\n");
+    Shell_print(&serial_0, "rate, load permille, cycles per sample x10, bytes per sample x1000, link bound rate\r\n");
+
+    Shell_print(&serial_0, "idle port A\r\n");
+    for (i = 0; i < (sizeof(test_rate) / sizeof(test_rate[0])); ++i) {
+        run(test_rate[i]);
+    }
+
+    /* PA8 high one of 3 core cycles */
+    Wave.ramp(1, 1);
+    Wave.start(3, 0);
+    Shell_print(&serial_0, "PA8 at core clock / 3\r\n");
+    for (i = 0; i < (sizeof(test_rate) / sizeof(test_rate[0])); ++i) {
+        run(test_rate[i]);
+    }
+    Wave.stop();
+}
@@ -0,0 +1,26 @@
+/**
+ * @file Logic_test.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief CPU cost of source/Logic compression, output discarded (no link). Port A is
+ * sampled at rising rates, once idle and once with PA8 toggling at core clock / 3
+ * (source/Wave, changes on 2 of 3 samples). Reports CPU load, cycles and compressed
+ * bytes per sample, and the rate the serial link could sustain at that compression.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef LOGIC_TEST_H
+#define LOGIC_TEST_H
+
+#define LOGIC_TEST_MS       100u
+#define LOGIC_TEST_BAUD     115200u
+
+/**
+ * @brief run benchmark once and print result over serial_0. Serial must be initialized,
+ * TIM1 (profiler) and TIM2 (latency harness) stopped.
+ */
+void logic_test_run(void);
+
+#endif /* LOGIC_TEST_H */
@@ -0,0 +1,343 @@
+/**
+ * @file Modbus.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief Modbus RTU slave
+ *
+ * Rx interrupt stores bytes into frame buffer and (re)starts t1.5 deadline. When t1.5
+ * expires t3.5 deadline is started. Byte received between t1.5 and t3.5 marks frame as
+ * broken. On t3.5 complete frame is passed to main loop (Modbus.exe).
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "Modbus.h"
+/* dependencies */
+#include "Timebase.h"
+#include "assert_gorenje.h"
+
+/* above 19200 baud spec use fixed times, below 1.5 and 3.5 character times (11 bit) */
+#if ( MODBUS_BAUD > 19200 )
+    #define MODBUS_T15_US   750u
+    #define MODBUS_T35_US   1750u
+#else
+    #define MODBUS_T15_US   ((15u * 11u * 1000000u) / (10u * MODBUS_BAUD))
+    #define MODBUS_T35_US   ((35u * 11u * 1000000u) / (10u * MODBUS_BAUD))
+#endif
+
+#define FC_READ_HOLDING     0x03u
+#define FC_READ_INPUT       0x04u
+#define FC_WRITE_SINGLE     0x06u
+#define FC_WRITE_MULTIPLE   0x10u
+
+#define READ_QTY_MAX        125u
+#define WRITE_QTY_MAX       123u
+
+typedef struct _modbus_ctrl_t{
+    serial_ctrl_desc_t  *p_serial;
+    /* Rx frame, written by interrupts until ready_F is set */
+    uint8_t             frame[MODBUS_FRAME_MAX];
+    volatile uint16_t   len;
+    volatile uint8_t    t15_F;      // t1.5 expired since last byte
+    volatile uint8_t    err_F;      // frame is broken
+    volatile uint8_t    ready_F;    // frame complete, wait for main loop
+    uint32_t            end_tm;     // time of frame end (t3.5), us
+    /* response */
+    uint8_t             resp[MODBUS_FRAME_MAX];
+    uint16_t            resp_len;
+    modbus_stats_t      stats;
+}modbus_ctrl_t;
+
+static void                 start   (serial_ctrl_desc_t *p_serial);
+static void                 exe     (void);
+static const modbus_stats_t *stats  (void);
+static uint8_t              Rx_isr  (serial_ctrl_desc_t *p_serial, uint8_t byte);
+
+//=========================================================
+/* create needed object  */
+static modbus_ctrl_t mb;
+
+Modbus_methods_t Modbus = {
+    &start,
+    &exe,
+    &stats
+};
+
+/* CRC16 poly 0xA001 (reflected 0x8005), init 0xFFFF */
+static const uint16_t crc16_tab[256] = {
+    0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+    0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+    0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+    0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+    0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+    0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+    0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+    0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+    0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+    0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+    0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+    0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+    0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+    0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+    0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+    0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+    0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+    0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+    0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+    0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+    0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+    0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+    0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+    0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+    0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+    0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+    0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+    0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+    0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+    0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+    0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+    0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040,
+};
+//=========================================================
+
+static uint16_t crc16(const uint8_t *p_data, uint16_t len) {
+    uint16_t crc = 0xFFFFu;
+
+    while (len-- > 0) {
+        crc = (crc >> 8) ^ crc16_tab[(crc ^ *p_data++) & 0xFFu];
+    }
+    return crc;
+}
+
+static inline uint16_t get_be16(const uint8_t *p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static inline void put_be16(uint8_t *p, uint16_t val) {
+    p[0] = (uint8_t)(val >> 8);
+    p[1] = (uint8_t)val;
+}
+
+/* binary search for first register, then check that whole range is defined */
+static const modbus_reg_t *reg_find(uint16_t addr, uint16_t qty, uint8_t type) {
+    int_fast16_t lo = 0;
+    int_fast16_t hi = (int_fast16_t)modbus_regs_cnt - 1;
+    uint16_t i;
+
+    while (lo <= hi) {
+        int_fast16_t mid = (lo + hi) / 2;
+
+        if (modbus_regs[mid].addr == addr) {
+            if ((mid + qty) > modbus_regs_cnt) {
+                return NULL;
+            }
+            for (i = 0; i < qty; ++i) {
+                if ( (modbus_regs[mid + i].addr != (uint16_t)(addr + i)) || ((modbus_regs[mid + i].type & type) == 0) ) {
+                    return NULL;
+                }
+            }
+            return &modbus_regs[mid];
+        } else if (modbus_regs[mid].addr < addr) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return NULL;
+}
+
+/* t3.5 deadline, timer interrupt */
+static void t35_cb(void) {
+    if ( (mb.err_F != 0) || (mb.len == 0) ) {
+        mb.stats.frame_err += mb.err_F;
+        mb.len = 0;
+        mb.err_F = 0;
+    } else {
+        mb.end_tm = Timebase.now();
+        mb.ready_F = 1;
+    }
+    mb.t15_F = 0;
+}
+
+/* t1.5 deadline, timer interrupt */
+static void t15_cb(void) {
+    mb.t15_F = 1;
+    Timebase.deadline(TIMEBASE_CH_MODBUS, MODBUS_T35_US - MODBUS_T15_US, &t35_cb);
+}
+
+/* called from uart Rx interrupt */
+static uint8_t Rx_isr(serial_ctrl_desc_t *p_serial, uint8_t byte) {
+    (void)p_serial;
+
+    if (mb.ready_F != 0) {
+        mb.stats.overrun++;
+        return 0;
+    }
+    if (mb.t15_F != 0) {
+        /* silence longer than 1.5 character inside frame */
+        mb.err_F = 1;
+        mb.t15_F = 0;
+    }
+    if (mb.len < MODBUS_FRAME_MAX) {
+        mb.frame[mb.len++] = byte;
+    } else {
+        mb.err_F = 1;
+    }
+    Timebase.deadline(TIMEBASE_CH_MODBUS, MODBUS_T15_US, &t15_cb);
+    return 0;
+}
+
+//=========================================================
+/* methods implementation */
+
+static void start(serial_ctrl_desc_t *p_serial) {
+    uint16_t i;
+
+    assert(p_serial != NULL);
+    for (i = 1; i < modbus_regs_cnt; ++i) {
+        assert(modbus_regs[i - 1].addr < modbus_regs[i].addr);
+    }
+
+    mb.len = 0;
+    mb.t15_F = 0;
+    mb.err_F = 0;
+    mb.ready_F = 0;
+    mb.p_serial = p_serial;
+    p_serial->Rx_hook = &Rx_isr;
+}
+
+static const modbus_stats_t *stats(void) {
+    return &mb.stats;
+}
+
+static uint16_t exception(uint8_t *p_resp, uint8_t code) {
+    p_resp[1] |= 0x80u;
+    p_resp[2] = code;
+    return 3;
+}
+
+/* process request in mb.frame (without crc), build response, return its length without crc */
+static uint16_t process(uint16_t len) {
+    const uint8_t *p_req = mb.frame;
+    uint8_t *p_resp = mb.resp;
+    const modbus_reg_t *p_reg;
+    uint16_t addr;
+    uint16_t qty;
+    uint16_t i;
+
+    p_resp[0] = p_req[0];
+    p_resp[1] = p_req[1];
+    addr = get_be16(&p_req[2]);
+    qty = get_be16(&p_req[4]);
+
+    switch (p_req[1]) {
+    case FC_READ_HOLDING:
+    case FC_READ_INPUT:
+        if ( (len != 6) || (qty == 0) || (qty > READ_QTY_MAX) ) {
+            return exception(p_resp, MODBUS_EXC_VALUE);
+        }
+        p_reg = reg_find(addr, qty, (p_req[1] == FC_READ_INPUT) ? MODBUS_REG_INPUT : MODBUS_REG_HOLDING);
+        if (p_reg == NULL) {
+            return exception(p_resp, MODBUS_EXC_ADDRESS);
+        }
+        p_resp[2] = (uint8_t)(qty * 2);
+        for (i = 0; i < qty; ++i) {
+            put_be16(&p_resp[3 + (i * 2)], *p_reg[i].p_val);
+        }
+        return 3 + (qty * 2);
+
+    case FC_WRITE_SINGLE:
+        if (len != 6) {
+            return exception(p_resp, MODBUS_EXC_VALUE);
+        }
+        p_reg = reg_find(addr, 1, MODBUS_REG_HOLDING);
+        if (p_reg == NULL) {
+            return exception(p_resp, MODBUS_EXC_ADDRESS);
+        }
+        /* qty field is the value here */
+        if ( (p_reg->on_write != NULL) && (p_reg->on_write(qty) == 0) ) {
+            return exception(p_resp, MODBUS_EXC_VALUE);
+        }
+        *p_reg->p_val = qty;
+        put_be16(&p_resp[2], addr);
+        put_be16(&p_resp[4], qty);
+        return 6;
+
+    case FC_WRITE_MULTIPLE:
+        if ( (len < 7) || (qty == 0) || (qty > WRITE_QTY_MAX) || (p_req[6] != (qty * 2)) || (len != (7 + (qty * 2))) ) {
+            return exception(p_resp, MODBUS_EXC_VALUE);
+        }
+        p_reg = reg_find(addr, qty, MODBUS_REG_HOLDING);
+        if (p_reg == NULL) {
+            return exception(p_resp, MODBUS_EXC_ADDRESS);
+        }
+        /* validate all first, request is applied whole or not at all */
+        for (i = 0; i < qty; ++i) {
+            if ( (p_reg[i].on_write != NULL) && (p_reg[i].on_write(get_be16(&p_req[7 + (i * 2)])) == 0) ) {
+                return exception(p_resp, MODBUS_EXC_VALUE);
+            }
+        }
+        for (i = 0; i < qty; ++i) {
+            *p_reg[i].p_val = get_be16(&p_req[7 + (i * 2)]);
+        }
+        put_be16(&p_resp[2], addr);
+        put_be16(&p_resp[4], qty);
+        return 6;
+
+    default:
+        return exception(p_resp, MODBUS_EXC_FUNCTION);
+    }
+}
+
+static void exe(void) {
+    uint16_t len = mb.len;
+    uint16_t resp_len = 0;
+    uint16_t crc;
+    uint16_t sent;
+    uint16_t chunk;
+    uint32_t turnaround;
+    uint8_t broadcast;
+
+    if (mb.ready_F == 0) {
+        return;
+    }
+
+    broadcast = (mb.frame[0] == 0);
+    if ( (len < 4) || (crc16(mb.frame, len) != 0) ) {
+        /* crc over data + crc is 0 for valid frame */
+        mb.stats.crc_err++;
+    } else if ( (mb.frame[0] == MODBUS_SLAVE_ADDR) || (broadcast != 0) ) {
+        mb.stats.frames++;
+        Modbus_regs_update();
+        resp_len = process(len - 2);
+    }
+
+    /* release Rx buffer */
+    mb.len = 0;
+    mb.ready_F = 0;
+
+    if ( (resp_len == 0) || (broadcast != 0) ) {
+        return;
+    }
+
+    crc = crc16(mb.resp, resp_len);
+    mb.resp[resp_len++] = (uint8_t)crc;
+    mb.resp[resp_len++] = (uint8_t)(crc >> 8);
+
+    turnaround = Timebase.now() - mb.end_tm;
+    if (turnaround > mb.stats.turnaround_max) {
+        mb.stats.turnaround_max = (turnaround > 0xFFFFu) ? 0xFFFFu : (uint16_t)turnaround;
+    }
+
+    /* whole frame is pushed without pause, gap > t1.5 would break it */
+    for (sent = 0; sent < resp_len; sent += chunk) {
+        chunk = Serial.Tx_free(mb.p_serial);
+        if (chunk > (resp_len - sent)) {
+            chunk = resp_len - sent;
+        }
+        if (chunk > 0) {
+            Serial.write(mb.p_serial, &mb.resp[sent], chunk);
+        }
+    }
+}
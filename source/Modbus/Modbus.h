@@ -0,0 +1,80 @@
+/**
+ * @file Modbus.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief Modbus RTU slave on top of Serial module. Frame end (t3.5) and inter character
+ * gap (t1.5) are detected with timer deadlines (Timebase), not with main loop polling.
+ *
+ * Supported functions: 0x03 read holding, 0x04 read input, 0x06 write single register,
+ * 0x10 write multiple registers. Registers are defined in sorted table modbus_regs[]
+ * (Modbus_regs.c). Input and holding registers share one address space.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+
+#ifndef MODBUS_H
+#define MODBUS_H
+
+#include <stdint.h>
+
+#include "Serial.h"
+
+//=======================================================================================
+#define MODBUS_SLAVE_ADDR   1
+#define MODBUS_BAUD         115200
+
+/**
+ * @brief RTU frame: address + function + 252 data + crc
+ */
+#define MODBUS_FRAME_MAX    256
+//=======================================================================================
+
+/* register type */
+#define MODBUS_REG_INPUT    0x01u   // read only, function 0x04
+#define MODBUS_REG_HOLDING  0x02u   // read/write, functions 0x03, 0x06, 0x10
+
+/* exception codes */
+#define MODBUS_EXC_FUNCTION 0x01u
+#define MODBUS_EXC_ADDRESS  0x02u
+#define MODBUS_EXC_VALUE    0x03u
+
+typedef struct _modbus_reg_t{
+    uint16_t    addr;
+    uint8_t     type;
+    uint16_t    *p_val;
+    uint8_t     (*on_write)(uint16_t val);  // optional, return 0 to reject the value
+}modbus_reg_t;
+
+/**
+ * @brief register map, sorted by address (Modbus_regs.c)
+ */
+extern const modbus_reg_t modbus_regs[];
+extern const uint16_t modbus_regs_cnt;
+
+typedef struct _modbus_stats_t{
+    uint32_t    frames;         // valid frames for this slave
+    uint32_t    crc_err;
+    uint32_t    frame_err;      // gap > t1.5 inside frame or frame too long
+    uint32_t    overrun;        // bytes received while previous frame was processed
+    uint16_t    turnaround_max; // frame end (t3.5) to response start, us
+}modbus_stats_t;
+
+/**
+ * @brief struct of all available methods of this module
+ */
+typedef struct _Modbus_methods_t{
+    void                    (*start)  (serial_ctrl_desc_t *p_serial); // take over serial port
+    void                    (*exe)    (void);                         // call from main loop
+    const modbus_stats_t *  (*stats)  (void);
+}Modbus_methods_t;
+
+extern Modbus_methods_t Modbus;
+
+/**
+ * @brief refresh dynamic register values, called before request is processed (Modbus_regs.c)
+ */
+void Modbus_regs_update(void);
+
+#endif /* MODBUS_H */
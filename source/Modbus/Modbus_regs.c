@@ -0,0 +1,64 @@
+/**
+ * @file Modbus_regs.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief Modbus register map. Table must be sorted by address (checked in Modbus.start)
+ *
+ *  input   0x0000 : uptime [s] low word
+ *          0x0001 : uptime [s] high word
+ *          0x0002 : valid frames (low word)
+ *          0x0003 : crc errors (low word)
+ *          0x0004 : max turnaround [us]
+ *  holding 0x0100 : LED PC13 (0 off, 1 on)
+ *          0x0101 - 0x0104 : scratch registers
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "Modbus.h"
+/* dependencies */
+#include "main.h"
+
+static uint8_t led_write(uint16_t val);
+
+//=========================================================
+/* create needed object  */
+static uint16_t reg_input[5];
+static uint16_t reg_led;
+static uint16_t reg_scratch[4];
+
+const modbus_reg_t modbus_regs[] = {
+    { 0x0000, MODBUS_REG_INPUT,   &reg_input[0],   NULL },
+    { 0x0001, MODBUS_REG_INPUT,   &reg_input[1],   NULL },
+    { 0x0002, MODBUS_REG_INPUT,   &reg_input[2],   NULL },
+    { 0x0003, MODBUS_REG_INPUT,   &reg_input[3],   NULL },
+    { 0x0004, MODBUS_REG_INPUT,   &reg_input[4],   NULL },
+    { 0x0100, MODBUS_REG_HOLDING, &reg_led,        &led_write },
+    { 0x0101, MODBUS_REG_HOLDING, &reg_scratch[0], NULL },
+    { 0x0102, MODBUS_REG_HOLDING, &reg_scratch[1], NULL },
+    { 0x0103, MODBUS_REG_HOLDING, &reg_scratch[2], NULL },
+    { 0x0104, MODBUS_REG_HOLDING, &reg_scratch[3], NULL },
+};
+const uint16_t modbus_regs_cnt = sizeof(modbus_regs) / sizeof(modbus_regs[0]);
+//=========================================================
+
+void Modbus_regs_update(void) {
+    uint32_t uptime = HAL_GetTick() / 1000;
+    const modbus_stats_t *p_stats = Modbus.stats();
+
+    reg_input[0] = (uint16_t)uptime;
+    reg_input[1] = (uint16_t)(uptime >> 16);
+    reg_input[2] = (uint16_t)p_stats->frames;
+    reg_input[3] = (uint16_t)p_stats->crc_err;
+    reg_input[4] = p_stats->turnaround_max;
+}
+
+static uint8_t led_write(uint16_t val) {
+    if (val > 1) {
+        return 0;
+    }
+    /* LED on PC13 is active low */
+    HAL_GPIO_WritePin(LED_PC13_GPIO_Port, LED_PC13_Pin, (val != 0) ? GPIO_PIN_RESET : GPIO_PIN_SET);
+    return 1;
+}
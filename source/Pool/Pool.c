@@ -0,0 +1,141 @@
+/**
+ * @file Pool.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief fixed block memory pools
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "Pool.h"
+/* dependencies */
+#include "Crit.h"
+#include "assert_gorenje.h"
+
+typedef struct _pool_block_t{
+    struct _pool_block_t    *p_next;
+}pool_block_t;
+
+typedef struct _pool_cfg_t{
+    uint8_t     *p_start;
+    uint8_t     *p_end;
+    uint16_t    size;
+    uint16_t    cnt;
+}pool_cfg_t;
+
+/* storage, one section per class */
+#define POOL_MEM(name, size, cnt) \
+    typedef char pool_size_check_##name[(((size) % 4u) == 0u) && ((size) >= 4u) ? 1 : -1]; \
+    static uint32_t pool_mem_##name[((size) / 4u) * (cnt)] __attribute__((section(".pool." #name), used));
+POOL_CLASSES(POOL_MEM)
+#undef POOL_MEM
+
+#define POOL_CFG(name, size, cnt) \
+    { (uint8_t *)pool_mem_##name, (uint8_t *)pool_mem_##name + sizeof(pool_mem_##name), (size), (cnt) },
+static const pool_cfg_t pool_cfg[POOL_CNT] = {
+    POOL_CLASSES(POOL_CFG)
+};
+#undef POOL_CFG
+
+static pool_block_t *pool_free_head[POOL_CNT];
+static pool_stats_t pool_stats[POOL_CNT];
+
+/* methods declarations */
+static void                 *alloc_block(size_t size);
+static void                 free_block (void *p_block);
+static const pool_stats_t   *stats      (pool_id_t id);
+
+const Pool_methods_t Pool = {
+    &alloc_block,
+    &free_block,
+    &stats
+};
+
+void Pool_init(void) {
+    const pool_cfg_t *p_cfg;
+    uint8_t *p_block;
+    uint8_t id;
+
+    for (id = 0; id < POOL_CNT; ++id) {
+        p_cfg = &pool_cfg[id];
+        /* classes must be sorted, alloc takes first one that fits */
+        assert((id == 0) || (p_cfg->size > pool_cfg[id - 1u].size));
+
+        pool_free_head[id] = NULL;
+        for (p_block = p_cfg->p_end; p_block > p_cfg->p_start; ) {
+            p_block -= p_cfg->size;
+            ((pool_block_t *)p_block)->p_next = pool_free_head[id];
+            pool_free_head[id] = (pool_block_t *)p_block;
+        }
+        pool_stats[id] = (pool_stats_t){ p_cfg->size, p_cfg->cnt, 0, 0, 0, 0, 0 };
+    }
+}
+
+static void *alloc_block(size_t size) {
+    pool_block_t *p_block = NULL;
+    crit_state_t primask;
+    uint8_t first = POOL_CNT;
+    uint8_t id;
+
+    primask = Crit_enter();
+    for (id = 0; id < POOL_CNT; ++id) {
+        if (size > pool_cfg[id].size) {
+            continue;
+        }
+        if (first == POOL_CNT) {
+            first = id;
+        }
+        p_block = pool_free_head[id];
+        if (p_block != NULL) {
+            pool_free_head[id] = p_block->p_next;
+            pool_stats[id].allocs++;
+            if (++pool_stats[id].used > pool_stats[id].used_max) {
+                pool_stats[id].used_max = pool_stats[id].used;
+            }
+            if (id != first) {
+                pool_stats[id].fallbacks++;
+            }
+            break;
+        }
+    }
+    if ((p_block == NULL) && (first != POOL_CNT)) {
+        pool_stats[first].fails++;
+    }
+    Crit_exit(primask);
+    return p_block;
+}
+
+static void free_block(void *p_block) {
+    const pool_cfg_t *p_cfg;
+    crit_state_t primask;
+    uint8_t id;
+
+    if (p_block == NULL) {
+        return;
+    }
+    for (id = 0; id < POOL_CNT; ++id) {
+        p_cfg = &pool_cfg[id];
+        if (((uint8_t *)p_block >= p_cfg->p_start) && ((uint8_t *)p_block < p_cfg->p_end)) {
+            break;
+        }
+    }
+    /* not a pool block, or pointer into the middle of a block */
+    assert(id < POOL_CNT);
+    if (id >= POOL_CNT) {
+        return;
+    }
+    assert((((uint8_t *)p_block - pool_cfg[id].p_start) % pool_cfg[id].size) == 0);
+
+    primask = Crit_enter();
+    assert(pool_stats[id].used > 0);
+    ((pool_block_t *)p_block)->p_next = pool_free_head[id];
+    pool_free_head[id] = (pool_block_t *)p_block;
+    pool_stats[id].used--;
+    Crit_exit(primask);
+}
+
+static const pool_stats_t *stats(pool_id_t id) {
+    assert(id < POOL_CNT);
+    return &pool_stats[id];
+}
@@ -0,0 +1,71 @@
+/**
+ * @file Pool.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief fixed block memory pools, replacement for newlib heap (_sbrk is disabled).
+ * Block classes are set at compile time in POOL_CLASSES. Pool.alloc() takes a block from
+ * the smallest class that fits and has a free block, Pool.free() returns it. Both are
+ * O(1) (free list per class, constant number of classes) and safe to call from interrupts.
+ *
+ * Each class has its own linker section .pool.<name>, so RAM reserved by each pool is
+ * visible in map file (tools/pool/pool_map.py).
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef POOL_H
+#define POOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+//=======================================================================================
+/**
+ * @brief block classes, ascending block size. Block size must be multiple of 4.
+ *  X(name, block size, block count)
+ */
+#define POOL_CLASSES(X)         \
+    X(SMALL,    16,     16)     \
+    X(MEDIUM,   64,     8)      \
+    X(LARGE,    256,    4)
+//=======================================================================================
+
+#define POOL_ENUM(name, size, cnt)  POOL_ID_##name,
+typedef enum _pool_id_t{
+    POOL_CLASSES(POOL_ENUM)
+    POOL_CNT
+}pool_id_t;
+#undef POOL_ENUM
+
+typedef struct _pool_stats_t{
+    uint16_t    block_size;
+    uint16_t    block_cnt;
+    uint16_t    used;
+    uint16_t    used_max;       // high water mark
+    uint32_t    allocs;
+    uint32_t    fallbacks;      // taken from this class because smaller one was full
+    uint32_t    fails;          // requests of this class size that found no block
+}pool_stats_t;
+
+typedef struct _Pool_methods_t{
+    /**
+     * @brief take block of at least size bytes
+     * @return block or NULL when size is too big or all fitting classes are empty
+     */
+    void                *(*alloc)  (size_t size);
+    /**
+     * @brief return block taken by alloc. NULL is ignored.
+     */
+    void                (*free)    (void *p_block);
+    const pool_stats_t  *(*stats)  (pool_id_t id);
+}Pool_methods_t;
+
+extern const Pool_methods_t Pool;
+
+/**
+ * @brief build free lists, call before first alloc
+ */
+void Pool_init(void);
+
+#endif /* POOL_H */
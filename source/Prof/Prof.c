@@ -0,0 +1,281 @@
+/**
+ * @file Prof.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief statistical sampling profiler
+ *
+ * dump format (little endian):
+ *  header : 'P','R','F','2' | uint32 base | uint16 bin_size | uint16 bin_cnt | uint32 core_clk
+ *           | prof_stats_t (2 x uint64, 5 x uint32, 4 bytes padding)
+ *  data   : bin_cnt * { uint16 bin index, uint16 samples }, non empty bins only
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "Prof.h"
+/* dependencies */
+#include "stm32f1xx_hal.h"
+#include "assert_gorenje.h"
+#include "CycleCnt.h"
+#include "TimOwner.h"
+#include "Startup.h"
+
+#define PROF_RAM_START      0x20000000u
+#define PROF_RAM_SIZE       (20u * 1024u)
+/* exception entry and exit (12 + 12) and handler stub, not seen by CycleCnt in prof_sample */
+#define PROF_ENTRY_CYCLES   30u
+/* sample period dither, timer ticks of 1 us: +-(PROF_DITHER / 2) */
+#define PROF_DITHER         16u
+
+typedef struct __attribute__((packed)) _prof_dump_hdr_t{
+    uint8_t         magic[4];
+    uint32_t        base;
+    uint16_t        bin_size;
+    uint16_t        bin_cnt;
+    uint32_t        core_clk;
+    prof_stats_t    stats;
+}prof_dump_hdr_t;
+
+typedef struct _prof_bin_t{
+    uint16_t    idx;
+    uint16_t    cnt;
+}prof_bin_t;
+
+typedef struct _prof_ctrl_t{
+    prof_stats_t        stats;
+    uint32_t            last;       // cycle count at previous sample
+    uint32_t            period;     // timer ticks
+    uint32_t            lfsr;
+    uint8_t             run_F;
+}prof_ctrl_t;
+
+typedef struct _prof_dump_t{
+    serial_ctrl_desc_t  *p_serial;
+    uint16_t            idx;        // next bin to look at
+    uint8_t             hdr_F;      // header is still to be sent
+    uint8_t             resume_F;   // profiler was running before dump
+}prof_dump_t;
+
+static uint8_t              start       (uint32_t rate);
+static void                 stop        (void);
+static const prof_stats_t   *stats      (void);
+static void                 dump_start  (serial_ctrl_desc_t *p_serial);
+static uint8_t              dump_exe    (void);
+
+void prof_sample(const uint32_t *p_frame) __attribute__((used));
+
+//=========================================================
+/* create needed object  */
+/* cleared by start() */
+NOINIT static uint16_t prof_bins[PROF_BIN_CNT];
+
+static prof_ctrl_t prof;
+static prof_dump_t prof_dump;
+static prof_dump_hdr_t prof_hdr;
+static const char prof_owner[] = "prof";
+
+const Prof_methods_t Prof = {
+    &start,
+    &stop,
+    &stats,
+    &dump_start,
+    &dump_exe
+};
+//=========================================================
+
+/* constructor */
+void Prof_init(void) {
+    CycleCnt_init();
+    stop();
+    prof.stats = (prof_stats_t){ 0 };
+    prof.lfsr = 0xACE1u;
+    prof_dump.p_serial = NULL;
+}
+
+/**
+ * @brief pass stacked frame (MSP or PSP, by EXC_RETURN bit 2), lr keeps EXC_RETURN so
+ * prof_sample() returns from the exception
+ */
+__attribute__((naked)) void TIM1_UP_IRQHandler(void) {
+    __asm volatile (
+        "tst    lr, #4          \n"
+        "ite    eq              \n"
+        "mrseq  r0, msp         \n"
+        "mrsne  r0, psp         \n"
+        "b      prof_sample     \n"
+    );
+}
+
+void prof_sample(const uint32_t *p_frame) {
+    const uint32_t enter = CycleCnt_get();
+    const uint32_t pc = p_frame[6];
+    uint32_t idx;
+
+    PROF_TIM->SR = ~TIM_SR_UIF;
+
+    prof.stats.elapsed += enter - prof.last;
+    prof.last = enter;
+    prof.stats.samples++;
+    if ((pc - PROF_BASE) < PROF_SPAN) {
+        idx = (pc - PROF_BASE) >> PROF_BIN_SHIFT;
+        if (prof_bins[idx] != UINT16_MAX) {
+            prof_bins[idx]++;
+        } else {
+            prof.stats.saturated++;
+        }
+    } else if ((pc - PROF_RAM_START) < PROF_RAM_SIZE) {
+        prof.stats.ram++;
+    } else {
+        prof.stats.other++;
+    }
+
+    /* next period, ARR is preloaded */
+    prof.lfsr = (prof.lfsr >> 1) ^ (-(prof.lfsr & 1u) & 0xB400u);
+    PROF_TIM->ARR = prof.period - 1u - (PROF_DITHER / 2u) + (prof.lfsr % PROF_DITHER);
+
+    prof.stats.isr_cycles += (CycleCnt_get() - enter) + PROF_ENTRY_CYCLES;
+}
+
+//=========================================================
+/* methods implementation */
+
+static uint8_t start(uint32_t rate) {
+    uint32_t tim_clk;
+    uint32_t i;
+
+    stop();
+    if (TimOwner_claim(PROF_TIM, prof_owner) == 0) {
+        return 0;
+    }
+    if (rate == 0) {
+        rate = PROF_RATE_DEFAULT;
+    }
+    assert((rate >= PROF_RATE_MIN) && (rate <= PROF_RATE_MAX));
+    if (rate > PROF_RATE_MAX) {
+        rate = PROF_RATE_MAX;
+    } else if (rate < PROF_RATE_MIN) {
+        rate = PROF_RATE_MIN;
+    }
+    for (i = 0; i < PROF_BIN_CNT; ++i) {
+        prof_bins[i] = 0;
+    }
+    prof.stats = (prof_stats_t){ 0 };
+    prof.stats.rate = rate;
+    prof.period = 1000000u / rate;
+
+    /* timer clock is 2x PCLK2 when APB2 is divided */
+    tim_clk = HAL_RCC_GetPCLK2Freq();
+    if ((RCC->CFGR & RCC_CFGR_PPRE2) != RCC_CFGR_PPRE2_DIV1) {
+        tim_clk *= 2u;
+    }
+    __HAL_RCC_TIM1_CLK_ENABLE();
+    PROF_TIM->CR1 = TIM_CR1_ARPE;
+    PROF_TIM->PSC = (tim_clk / 1000000u) - 1u;
+    PROF_TIM->ARR = prof.period - 1u;
+    PROF_TIM->EGR = TIM_EGR_UG;
+    PROF_TIM->SR = 0;
+    PROF_TIM->DIER = TIM_DIER_UIE;
+    NVIC_SetPriority(PROF_IRQn, PROF_IRQ_PRIO);
+    NVIC_ClearPendingIRQ(PROF_IRQn);
+    NVIC_EnableIRQ(PROF_IRQn);
+
+    prof.last = CycleCnt_get();
+    prof.run_F = 1;
+    PROF_TIM->CR1 |= TIM_CR1_CEN;
+    return 1;
+}
+
+static void stop(void) {
+    /* TIM1 may be running for source/Wave */
+    if (prof.run_F == 0) {
+        return;
+    }
+    PROF_TIM->CR1 &= ~TIM_CR1_CEN;
+    PROF_TIM->DIER = 0;
+    NVIC_DisableIRQ(PROF_IRQn);
+    /* dump in progress must not restart it */
+    prof_dump.resume_F = 0;
+    prof.run_F = 0;
+    TimOwner_release(PROF_TIM, prof_owner);
+}
+
+static const prof_stats_t *stats(void) {
+    return &prof.stats;
+}
+
+static void dump_start(serial_ctrl_desc_t *p_serial) {
+    uint16_t cnt = 0;
+    uint32_t i;
+
+    assert(p_serial != NULL);
+
+    if (prof_dump.p_serial != NULL) {
+        /* dump already in progress */
+        return;
+    }
+    /* histogram must not change while it is sent */
+    prof_dump.resume_F = prof.run_F;
+    if (prof.run_F != 0) {
+        PROF_TIM->CR1 &= ~TIM_CR1_CEN;
+        NVIC_DisableIRQ(PROF_IRQn);
+    }
+
+    for (i = 0; i < PROF_BIN_CNT; ++i) {
+        cnt += (prof_bins[i] != 0) ? 1u : 0u;
+    }
+    prof_hdr.magic[0] = 'P';
+    prof_hdr.magic[1] = 'R';
+    prof_hdr.magic[2] = 'F';
+    prof_hdr.magic[3] = '2';
+    prof_hdr.base     = PROF_BASE;
+    prof_hdr.bin_size = PROF_BIN_SIZE;
+    prof_hdr.bin_cnt  = cnt;
+    prof_hdr.core_clk = SystemCoreClock;
+    prof_hdr.stats    = prof.stats;
+
+    prof_dump.idx = 0;
+    prof_dump.hdr_F = 1;
+    prof_dump.p_serial = p_serial;
+}
+
+static uint8_t dump_exe(void) {
+    serial_ctrl_desc_t *p_serial = prof_dump.p_serial;
+    prof_bin_t bin;
+
+    if (p_serial == NULL) {
+        return 0;
+    }
+
+    if (prof_dump.hdr_F != 0) {
+        if (Serial.Tx_free(p_serial) < sizeof(prof_hdr)) {
+            return 1;
+        }
+        Serial.write(p_serial, (uint8_t *)&prof_hdr, sizeof(prof_hdr));
+        prof_dump.hdr_F = 0;
+    }
+
+    /* fill Tx buffer with as many non empty bins as it fits */
+    while ( (prof_dump.idx < PROF_BIN_CNT) && (Serial.Tx_free(p_serial) >= sizeof(bin)) ) {
+        if (prof_bins[prof_dump.idx] != 0) {
+            bin.idx = prof_dump.idx;
+            bin.cnt = prof_bins[prof_dump.idx];
+            Serial.write(p_serial, (uint8_t *)&bin, sizeof(bin));
+        }
+        prof_dump.idx++;
+    }
+
+    if (prof_dump.idx < PROF_BIN_CNT) {
+        return 1;
+    }
+
+    /* done, continue sampling into the same histogram */
+    prof_dump.p_serial = NULL;
+    if (prof_dump.resume_F != 0) {
+        prof.last = CycleCnt_get();
+        NVIC_EnableIRQ(PROF_IRQn);
+        PROF_TIM->CR1 |= TIM_CR1_CEN;
+    }
+    return 0;
+}
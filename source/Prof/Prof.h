@@ -0,0 +1,74 @@
+/**
+ * @file Prof.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief statistical sampling profiler. TIM1 update interrupt (highest priority) takes the
+ * interrupted PC from the exception stack frame and counts it in a histogram of
+ * PROF_BIN_SIZE byte bins over the application flash. Sample period is dithered, so loops
+ * with a period that divides sample period do not alias.
+ *
+ * Only code that runs below profiler priority is seen, USART1 and SysTick ISRs (same
+ * priority) are attributed to the code they interrupted. Samples in SRAM (.ramfunc) and
+ * elsewhere are counted but not binned. Time spent in the profiler ISR, including
+ * exception entry and exit, is reported as overhead.
+ *
+ * Histogram is streamed in binary from main loop (like source/Trace), shell command
+ * "prof dump"; tools/prof/prof_report.py maps bins to functions with .map or .elf.
+ * TIM1 is shared with source/Wave (source/TimOwner), start() refuses while Wave runs.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef PROF_H
+#define PROF_H
+
+#include <stdint.h>
+
+#include "Serial.h"
+
+#define PROF_TIM            TIM1
+#define PROF_IRQn           TIM1_UP_IRQn
+#define PROF_IRQ_PRIO       0u
+#define PROF_RATE_DEFAULT   1000u           // samples per second
+#define PROF_RATE_MIN       16u             // period of 1 us ticks must fit 16 bit ARR
+#define PROF_RATE_MAX       20000u
+
+/* binned region: application flash (STM32F103C8_FLASH.ld) */
+#define PROF_BASE           0x08002000u
+#define PROF_SPAN           (32u * 1024u)
+#define PROF_BIN_SHIFT      5u
+#define PROF_BIN_SIZE       (1u << PROF_BIN_SHIFT)
+#define PROF_BIN_CNT        (PROF_SPAN >> PROF_BIN_SHIFT)
+
+typedef struct _prof_stats_t{
+    uint64_t    isr_cycles; // spent in profiler
+    uint64_t    elapsed;    // cycles while running, 32 bit would wrap after 59 s at 72 MHz
+    uint32_t    samples;
+    uint32_t    ram;        // PC in SRAM (.ramfunc)
+    uint32_t    other;      // PC outside application and SRAM
+    uint32_t    saturated;  // samples lost to a full bin
+    uint32_t    rate;       // samples per second
+}prof_stats_t;
+
+/**
+ * @brief struct of all available methods of this module
+ */
+typedef struct _Prof_methods_t{
+    /* clears histogram, 0: default rate, PROF_RATE_MIN .. PROF_RATE_MAX. Returns 0 when
+       TIM1 is held by source/Wave */
+    uint8_t             (*start)        (uint32_t rate);
+    void                (*stop)         (void);
+    const prof_stats_t  *(*stats)       (void);
+    void                (*dump_start)   (serial_ctrl_desc_t *p_serial); // pause sampling and start dump
+    uint8_t             (*dump_exe)     (void); // call from main loop, returns 1 while dump is in progress
+}Prof_methods_t;
+
+extern const Prof_methods_t Prof;
+
+/**
+ * @brief profiler stopped, histogram empty
+ */
+void Prof_init(void);
+
+#endif /* PROF_H */
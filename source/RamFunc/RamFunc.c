@@ -0,0 +1,61 @@
+/**
+ * @file RamFunc.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief code execution from SRAM, vector table relocation
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "RamFunc.h"
+/* dependencies */
+#include "Crit.h"
+#include "assert_gorenje.h"
+
+/* 16 core exceptions + device interrupts */
+#define VECT_CNT        (16u + (uint32_t)USBWakeUp_IRQn + 1u)
+
+/* VTOR needs table aligned to its size rounded up to power of 2 (64 words) */
+static uint32_t ram_vectors[VECT_CNT] __attribute__((aligned(256)));
+static uint32_t flash_vtor;
+
+void RamFunc_init(void) {
+    #if ( RAMFUNC_SRAM_VECTORS == 1 )
+        RamFunc_vectors_to_sram();
+    #endif
+}
+
+void RamFunc_vectors_to_sram(void) {
+    const uint32_t *p_src = (const uint32_t *)SCB->VTOR;
+    crit_state_t primask;
+    uint32_t i;
+
+    if (SCB->VTOR == (uint32_t)ram_vectors) {
+        return;
+    }
+    primask = Crit_enter();
+    flash_vtor = SCB->VTOR;
+    for (i = 0; i < VECT_CNT; ++i) {
+        ram_vectors[i] = p_src[i];
+    }
+    __DSB();
+    SCB->VTOR = (uint32_t)ram_vectors;
+    __DSB();
+    Crit_exit(primask);
+}
+
+void RamFunc_vectors_to_flash(void) {
+    if (SCB->VTOR == (uint32_t)ram_vectors) {
+        SCB->VTOR = flash_vtor;
+        __DSB();
+    }
+}
+
+void RamFunc_vector_set(IRQn_Type irq, void (*handler)(void)) {
+    assert(SCB->VTOR == (uint32_t)ram_vectors);
+    assert((irq >= 0) && ((uint32_t)irq <= (uint32_t)USBWakeUp_IRQn));
+
+    ram_vectors[16 + irq] = (uint32_t)handler;
+    __DSB();
+}
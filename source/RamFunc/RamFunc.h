@@ -0,0 +1,61 @@
+/**
+ * @file RamFunc.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief code execution from SRAM. Functions tagged with RAMFUNC go to .ramfunc section,
+ * which Reset_Handler copies from flash to SRAM before .data. ISR path functions we do
+ * not own (HAL, CubeMX generated handlers) are listed by name in .ramfunc section of
+ * STM32F103C8_FLASH.ld instead.
+ *
+ * Vector table can be moved to SRAM as well (RAMFUNC_SRAM_VECTORS), then vector fetch
+ * does not go through flash and single vectors can be replaced at run time.
+ *
+ * Gain depends on flash wait states: on 8 MHz HSI (FLASH_LATENCY_0) flash fetch has no
+ * wait states, code in SRAM is fetched over system bus and competes with data accesses.
+ * Check with RamFunc_test before enabling on new clock setup.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef RAM_FUNC_H
+#define RAM_FUNC_H
+
+#include <stdint.h>
+
+#include "stm32f1xx.h"
+
+/**
+ * @brief copy vector table to SRAM in RamFunc_init()
+ */
+#define RAMFUNC_SRAM_VECTORS    0
+
+/**
+ * @brief place function into SRAM. long_call: SRAM is out of BL range from flash
+ */
+#define RAMFUNC     __attribute__((section(".ramfunc"), noinline, long_call))
+
+/**
+ * @brief move vector table to SRAM when RAMFUNC_SRAM_VECTORS is set. Call once, before
+ * interrupts are enabled by drivers.
+ */
+void RamFunc_init(void);
+
+/**
+ * @brief copy active vector table to SRAM and point VTOR to it
+ */
+void RamFunc_vectors_to_sram(void);
+
+/**
+ * @brief point VTOR back to vector table in flash
+ */
+void RamFunc_vectors_to_flash(void);
+
+/**
+ * @brief replace interrupt handler, vector table must be in SRAM
+ * @param irq           : device interrupt number (not core exception)
+ * @param handler       : new handler
+ */
+void RamFunc_vector_set(IRQn_Type irq, void (*handler)(void));
+
+#endif /* RAM_FUNC_H */
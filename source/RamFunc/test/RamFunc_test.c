@@ -0,0 +1,166 @@
+#include "RamFunc_test.h"
+#include "RamFunc.h"
+#include "Serial.h"
+#include "Shell.h"
+#include "CycleCnt.h"
+
+#define BENCH_CNT       200u
+#define RING_SIZE       64u
+
+typedef struct _bench_t{
+    uint32_t    min;
+    uint32_t    max;
+    uint32_t    sum;
+}bench_t;
+
+static struct {
+    uint8_t     data[RING_SIZE];
+    uint8_t     head;
+    uint8_t     tail;
+    uint32_t    last_tm;
+}ring;
+
+static volatile uint32_t isr_stamp;
+static volatile uint8_t isr_byte;
+
+/**
+ * @brief work of Serial Rx interrupt: store byte, drop oldest when full, time stamp
+ */
+static inline __attribute__((always_inline)) void rx_work(uint8_t byte) {
+    uint8_t next = (uint8_t)((ring.head + 1u) % RING_SIZE);
+
+    if (next == ring.tail) {
+        ring.tail = (uint8_t)((ring.tail + 1u) % RING_SIZE);
+    }
+    ring.data[ring.head] = byte;
+    ring.head = next;
+    ring.last_tm = CycleCnt_get();
+}
+
+static void __attribute__((noinline)) rx_flash(uint8_t byte) {
+    rx_work(byte);
+}
+
+static RAMFUNC void rx_ram(uint8_t byte) {
+    rx_work(byte);
+}
+
+/* flash vector table entry */
+void TAMPER_IRQHandler(void) {
+    isr_stamp = CycleCnt_get();
+    rx_flash(isr_byte);
+}
+
+static RAMFUNC void tamper_isr_ram(void) {
+    isr_stamp = CycleCnt_get();
+    rx_ram(isr_byte);
+}
+
+//=========================================================
+
+static void bench_clear(bench_t *p_bench) {
+    p_bench->min = 0xFFFFFFFFu;
+    p_bench->max = 0;
+    p_bench->sum = 0;
+}
+
+static void bench_add(bench_t *p_bench, uint32_t cycles) {
+    if (cycles < p_bench->min) {
+        p_bench->min = cycles;
+    }
+    if (cycles > p_bench->max) {
+        p_bench->max = cycles;
+    }
+    p_bench->sum += cycles;
+}
+
+static void bench_print(const char *p_name, const bench_t *p_bench) {
+    Shell_print(&serial_0, p_name);
+    Shell_print(&serial_0, ": cycles min ");
+    Shell_print_u32(&serial_0, p_bench->min);
+    Shell_print(&serial_0, ", avg ");
+    Shell_print_u32(&serial_0, p_bench->sum / BENCH_CNT);
+    Shell_print(&serial_0, ", max ");
+    Shell_print_u32(&serial_0, p_bench->max);
+    Shell_print(&serial_0, "\r\n");
+}
+
+static void bench_call(bench_t *p_bench, void (*p_fn)(uint8_t)) {
+    uint32_t i;
+    uint32_t start;
+
+    bench_clear(p_bench);
+    for (i = 0; i < BENCH_CNT; ++i) {
+        __disable_irq();
+        start = CycleCnt_get();
+        p_fn((uint8_t)i);
+        bench_add(p_bench, CycleCnt_get() - start);
+        __enable_irq();
+    }
+}
+
+/**
+ * @brief BASEPRI masks interrupts of priority 1 and lower. USART1 and SysTick share
+ * priority 0 with TAMPER and can add to max, min is the clean figure.
+ */
+static void bench_isr(bench_t *p_latency, bench_t *p_total) {
+    uint32_t i;
+    uint32_t start;
+    uint32_t end;
+
+    bench_clear(p_latency);
+    bench_clear(p_total);
+    __set_BASEPRI(1u << (8u - __NVIC_PRIO_BITS));
+    for (i = 0; i < BENCH_CNT; ++i) {
+        isr_byte = (uint8_t)i;
+        start = CycleCnt_get();
+        NVIC->STIR = TAMPER_IRQn;
+        __DSB();
+        __ISB();
+        end = CycleCnt_get();
+        bench_add(p_latency, isr_stamp - start);
+        bench_add(p_total, end - start);
+    }
+    __set_BASEPRI(0);
+}
+
+void ramfunc_test_run(void) {
+    bench_t latency;
+    bench_t total;
+
+    CycleCnt_init();
+    Shell_print(&serial_0, "\r\nRamFunc benchmark, core clock ");
+    Shell_print_u32(&serial_0, SystemCoreClock / 1000000u);
+    Shell_print(&serial_0, " MHz, flash latency ");
+    Shell_print_u32(&serial_0, FLASH->ACR & FLASH_ACR_LATENCY);
+    Shell_print(&serial_0, "\r\n");
+
+    bench_call(&total, &rx_flash);
+    bench_print("rx work, flash      ", &total);
+    bench_call(&total, &rx_ram);
+    bench_print("rx work, sram       ", &total);
+
+    NVIC_SetPriority(TAMPER_IRQn, 0);
+    NVIC_EnableIRQ(TAMPER_IRQn);
+
+    RamFunc_vectors_to_flash();
+    bench_isr(&latency, &total);
+    bench_print("vect flash, isr flash latency", &latency);
+    bench_print("vect flash, isr flash total  ", &total);
+
+    RamFunc_vectors_to_sram();
+    bench_isr(&latency, &total);
+    bench_print("vect sram, isr flash latency ", &latency);
+    bench_print("vect sram, isr flash total   ", &total);
+
+    RamFunc_vector_set(TAMPER_IRQn, &tamper_isr_ram);
+    bench_isr(&latency, &total);
+    bench_print("vect sram, isr sram latency  ", &latency);
+    bench_print("vect sram, isr sram total    ", &total);
+
+    NVIC_DisableIRQ(TAMPER_IRQn);
+    RamFunc_vector_set(TAMPER_IRQn, &TAMPER_IRQHandler);
+    #if ( RAMFUNC_SRAM_VECTORS == 0 )
+        RamFunc_vectors_to_flash();
+    #endif
+}
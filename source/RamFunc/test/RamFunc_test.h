@@ -0,0 +1,24 @@
+/**
+ * @file RamFunc_test.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief flash vs SRAM execution benchmark. Same Serial Rx like work (byte into ring,
+ * time stamp) is compiled twice, once RAMFUNC. Interrupt is pended by software on
+ * otherwise unused TAMPER_IRQn:
+ *  - latency: pend to first instruction of handler
+ *  - total  : pend to return into thread, with work in the handler
+ * for vector table in flash / SRAM and handler in flash / SRAM.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef RAM_FUNC_TEST_H
+#define RAM_FUNC_TEST_H
+
+/**
+ * @brief run benchmark once and print result over serial_0. Serial must be initialized.
+ */
+void ramfunc_test_run(void);
+
+#endif /* RAM_FUNC_TEST_H */
@@ -0,0 +1,307 @@
+/**
+ * @file Rpc.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief pipelined binary RPC over serial
+ *
+ * Request frames are parsed in uart Rx interrupt directly into a free slot. Complete
+ * requests are queued to main loop (rx fifo), handlers run from Rpc.exe(). Finished
+ * requests are queued for sending in completion order (tx fifo). Exit request gives the
+ * port back only when no request is pending anymore.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "Rpc.h"
+/* dependencies */
+#include "Crit.h"
+#include "stm32f1xx_hal.h"
+#include "assert_gorenje.h"
+
+#if ( (RPC_MAX_INFLIGHT & (RPC_MAX_INFLIGHT - 1)) != 0 ) || ( RPC_MAX_INFLIGHT > 32 )
+    #error "RPC_MAX_INFLIGHT must be power of 2, max 32"
+#endif
+
+#define RPC_OP_EXIT         0x00u
+#define RPC_FIFO_MSK        (RPC_MAX_INFLIGHT - 1)
+#define RPC_FRAME_OVERHEAD  5   // sof, len, id, op/status, crc
+
+typedef enum _rpc_rx_state_t{
+    RX_SOF = 0,
+    RX_LEN,
+    RX_ID,
+    RX_OP,
+    RX_DATA,
+    RX_CRC,
+}rpc_rx_state_t;
+
+typedef uint8_t (*rpc_hook_t)(serial_ctrl_desc_t *p_ctrl_desc, uint8_t byte);
+
+typedef struct _rpc_ctrl_t{
+    serial_ctrl_desc_t  *p_serial;
+    rpc_hook_t          prev_hook;      // shell hook, restored on stop
+    volatile uint32_t   free_msk;       // bit set = slot free
+    volatile uint32_t   pending_msk;    // bit set = handler returned RPC_PENDING
+    /* parser, Rx interrupt only */
+    rpc_rx_state_t      rx_state;
+    uint8_t             rx_idx;
+    uint8_t             rx_crc;
+    uint8_t             rx_drop_F;      // no free slot, frame is parsed into rx_scratch
+    rpc_slot_t          *p_rx;          // slot being received, NULL before length byte
+    uint32_t            rx_tm;
+    /* requests received, Rx interrupt -> main loop */
+    uint8_t             rx_fifo[RPC_MAX_INFLIGHT];
+    volatile uint8_t    rx_head;
+    volatile uint8_t    rx_tail;
+    /* requests completed, handler or interrupt -> main loop */
+    uint8_t             tx_fifo[RPC_MAX_INFLIGHT];
+    volatile uint8_t    tx_head;
+    volatile uint8_t    tx_tail;
+    /* response to a dropped request */
+    volatile uint8_t    busy_F;
+    volatile uint8_t    busy_id;
+    uint8_t             stop_F;
+}rpc_ctrl_t;
+
+static void    start   (serial_ctrl_desc_t *p_serial);
+static void    stop    (void);
+static void    exe     (void);
+static uint8_t Rx_isr  (serial_ctrl_desc_t *p_serial, uint8_t byte);
+
+//=========================================================
+/* create needed object  */
+static rpc_ctrl_t rpc;
+static rpc_slot_t rpc_slots[RPC_MAX_INFLIGHT];
+static rpc_slot_t rx_scratch;
+
+Rpc_methods_t Rpc = {
+    &start,
+    &stop,
+    &exe
+};
+//=========================================================
+
+static uint8_t crc8(uint8_t crc, uint8_t byte) {
+    uint_fast8_t i;
+
+    crc ^= byte;
+    for (i = 0; i < 8; ++i) {
+        crc = (crc & 0x80u) ? (uint8_t)((crc << 1) ^ 0x07u) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+static void slot_free(uint8_t idx) {
+    crit_state_t primask = Crit_enter();
+    rpc.free_msk |= (1UL << idx);
+    Crit_exit(primask);
+}
+
+static void slot_pending(uint8_t idx) {
+    crit_state_t primask = Crit_enter();
+    rpc.pending_msk |= (1UL << idx);
+    Crit_exit(primask);
+}
+
+//=========================================================
+/* methods implementation */
+
+static void start(serial_ctrl_desc_t *p_serial) {
+    assert(p_serial != NULL);
+
+    /* nothing of previous session may complete into the new one */
+    Rpc_ops_reset();
+    rpc.free_msk = (RPC_MAX_INFLIGHT == 32) ? 0xFFFFFFFFUL : ((1UL << RPC_MAX_INFLIGHT) - 1);
+    rpc.pending_msk = 0;
+    rpc.rx_state = RX_SOF;
+    rpc.p_rx = NULL;
+    rpc.rx_head = rpc.rx_tail = 0;
+    rpc.tx_head = rpc.tx_tail = 0;
+    rpc.busy_F = 0;
+    rpc.stop_F = 0;
+    rpc.prev_hook = p_serial->Rx_hook;
+    rpc.p_serial = p_serial;
+    p_serial->Rx_hook = &Rx_isr;
+}
+
+static void stop(void) {
+    if (rpc.p_serial != NULL) {
+        rpc.p_serial->Rx_hook = rpc.prev_hook;
+        rpc.p_serial = NULL;
+    }
+}
+
+void Rpc_complete(rpc_slot_t *p_slot) {
+    const uint8_t idx = (uint8_t)(p_slot - rpc_slots);
+    crit_state_t primask = Crit_enter();
+    rpc.tx_fifo[rpc.tx_head & RPC_FIFO_MSK] = idx;
+    rpc.tx_head++;
+    rpc.pending_msk &= ~(1UL << idx);
+    Crit_exit(primask);
+}
+
+static void send_frame(uint8_t id, uint8_t status, const uint8_t *p_data, uint8_t len) {
+    uint8_t frame[RPC_PAYLOAD_MAX + RPC_FRAME_OVERHEAD];
+    uint8_t crc;
+    uint8_t i;
+
+    frame[0] = RPC_SOF;
+    frame[1] = len;
+    frame[2] = id;
+    frame[3] = status;
+    crc = crc8(crc8(crc8(0, len), id), status);
+    for (i = 0; i < len; ++i) {
+        frame[4 + i] = p_data[i];
+        crc = crc8(crc, p_data[i]);
+    }
+    frame[4 + len] = crc;
+    Serial.write(rpc.p_serial, frame, len + RPC_FRAME_OVERHEAD);
+}
+
+static void exe(void) {
+    rpc_slot_t *p_slot;
+    uint8_t idx;
+
+    if (rpc.p_serial == NULL) {
+        return;
+    }
+
+    /* run handlers of new requests */
+    while (rpc.rx_tail != rpc.rx_head) {
+        idx = rpc.rx_fifo[rpc.rx_tail & RPC_FIFO_MSK];
+        rpc.rx_tail++;
+        p_slot = &rpc_slots[idx];
+
+        if (p_slot->op == RPC_OP_EXIT) {
+            /* answer and give port back when all responses are out */
+            p_slot->op = RPC_OK;
+            p_slot->len = 0;
+            rpc.stop_F = 1;
+            Rpc_complete(p_slot);
+        } else if (p_slot->op >= rpc_ops_cnt) {
+            p_slot->op = RPC_ERR_OP;
+            p_slot->len = 0;
+            Rpc_complete(p_slot);
+        } else {
+            /* set before handler, it may complete from interrupt before it returns */
+            slot_pending(idx);
+            if (rpc_ops[p_slot->op](p_slot) == RPC_DONE) {
+                Rpc_complete(p_slot);
+            }
+        }
+    }
+
+    Rpc_ops_exe();
+
+    /* send responses in completion order */
+    if ( (rpc.busy_F != 0) && (Serial.Tx_free(rpc.p_serial) >= RPC_FRAME_OVERHEAD) ) {
+        send_frame(rpc.busy_id, RPC_ERR_BUSY, NULL, 0);
+        rpc.busy_F = 0;
+    }
+    while (rpc.tx_tail != rpc.tx_head) {
+        idx = rpc.tx_fifo[rpc.tx_tail & RPC_FIFO_MSK];
+        p_slot = &rpc_slots[idx];
+        if (Serial.Tx_free(rpc.p_serial) < (p_slot->len + RPC_FRAME_OVERHEAD)) {
+            break;
+        }
+        send_frame(p_slot->id, p_slot->op, p_slot->data, p_slot->len);
+        rpc.tx_tail++;
+        slot_free(idx);
+    }
+
+    /* pending requests would complete into slots of next session */
+    if ( (rpc.stop_F != 0) && (rpc.tx_tail == rpc.tx_head) && (rpc.pending_msk == 0) ) {
+        stop();
+    }
+}
+
+/* frame in slot is given up, Rx interrupt only */
+static void rx_release(void) {
+    if ( (rpc.p_rx != NULL) && (rpc.rx_drop_F == 0) ) {
+        rpc.free_msk |= (1UL << (rpc.p_rx - rpc_slots));
+    }
+    rpc.p_rx = NULL;
+}
+
+/* called from uart Rx interrupt */
+static uint8_t Rx_isr(serial_ctrl_desc_t *p_serial, uint8_t byte) {
+    uint32_t now = HAL_GetTick();
+    uint8_t idx;
+
+    (void)p_serial;
+
+    if ( (rpc.rx_state != RX_SOF) && ((now - rpc.rx_tm) > RPC_RX_TIMEOUT) ) {
+        /* broken frame, slot is claimed only once length is received */
+        rx_release();
+        rpc.rx_state = RX_SOF;
+    }
+    rpc.rx_tm = now;
+
+    switch (rpc.rx_state) {
+    case RX_SOF:
+        if (byte == RPC_SOF) {
+            rpc.rx_state = RX_LEN;
+        }
+        return 0;
+
+    case RX_LEN:
+        if (byte > RPC_PAYLOAD_MAX) {
+            rpc.rx_state = RX_SOF;
+            return 0;
+        }
+        if (rpc.free_msk != 0) {
+            idx = (uint8_t)__builtin_ctz(rpc.free_msk);
+            rpc.free_msk &= ~(1UL << idx);
+            rpc.p_rx = &rpc_slots[idx];
+            rpc.rx_drop_F = 0;
+        } else {
+            rpc.p_rx = &rx_scratch;
+            rpc.rx_drop_F = 1;
+        }
+        rpc.p_rx->len = byte;
+        rpc.rx_crc = crc8(0, byte);
+        rpc.rx_state = RX_ID;
+        return 0;
+
+    case RX_ID:
+        rpc.p_rx->id = byte;
+        rpc.rx_crc = crc8(rpc.rx_crc, byte);
+        rpc.rx_state = RX_OP;
+        return 0;
+
+    case RX_OP:
+        rpc.p_rx->op = byte;
+        rpc.rx_crc = crc8(rpc.rx_crc, byte);
+        rpc.rx_idx = 0;
+        rpc.rx_state = (rpc.p_rx->len > 0) ? RX_DATA : RX_CRC;
+        return 0;
+
+    case RX_DATA:
+        rpc.p_rx->data[rpc.rx_idx++] = byte;
+        rpc.rx_crc = crc8(rpc.rx_crc, byte);
+        if (rpc.rx_idx == rpc.p_rx->len) {
+            rpc.rx_state = RX_CRC;
+        }
+        return 0;
+
+    case RX_CRC:
+    default:
+        rpc.rx_state = RX_SOF;
+        if (rpc.rx_drop_F != 0) {
+            if (byte == rpc.rx_crc) {
+                rpc.busy_id = rpc.p_rx->id;
+                rpc.busy_F = 1;
+            }
+        } else if (byte == rpc.rx_crc) {
+            rpc.rx_fifo[rpc.rx_head & RPC_FIFO_MSK] = (uint8_t)(rpc.p_rx - rpc_slots);
+            rpc.rx_head++;
+        } else {
+            /* crc error, host will time out */
+            rx_release();
+        }
+        /* slot belongs to main loop now */
+        rpc.p_rx = NULL;
+        return 0;
+    }
+}
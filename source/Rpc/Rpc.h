@@ -0,0 +1,107 @@
+/**
+ * @file Rpc.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief pipelined binary RPC over serial. Host can have up to RPC_MAX_INFLIGHT requests
+ * outstanding, each tagged with its own id. Handlers may complete later (Rpc_complete()),
+ * responses are sent in completion order, not in request order.
+ *
+ * request  : RPC_SOF | len | id | op     | payload[len] | crc8
+ * response : RPC_SOF | len | id | status | payload[len] | crc8
+ * crc8 (poly 0x07, init 0) is calculated over len .. payload
+ *
+ * RPC take over serial port from shell when started ("rpc" shell command) and return it
+ * on RPC_OP_EXIT request, once all requests received before it are answered.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+
+#ifndef RPC_H
+#define RPC_H
+
+#include <stdint.h>
+
+#include "Serial.h"
+
+//=======================================================================================
+/**
+ * @brief max number of requests being processed at once. Must be power of 2
+ */
+#define RPC_MAX_INFLIGHT    16
+
+/**
+ * @brief max payload of request or response
+ */
+#define RPC_PAYLOAD_MAX     32
+
+/**
+ * @brief partially received frame is dropped after this gap (ms)
+ */
+#define RPC_RX_TIMEOUT      20
+//=======================================================================================
+
+#define RPC_SOF             0xA5u
+
+/* response status */
+#define RPC_OK              0x00u
+#define RPC_ERR_OP          0x01u   // unknown op
+#define RPC_ERR_ARG         0x02u   // bad payload
+#define RPC_ERR_BUSY        0x03u   // too many requests in flight, request dropped
+
+/* handler return value */
+#define RPC_DONE            0u      // response is ready in slot
+#define RPC_PENDING         1u      // handler will call Rpc_complete() later
+
+/**
+ * @brief one request in flight. Response is written into the same slot
+ */
+typedef struct _rpc_slot_t{
+    uint8_t     id;
+    uint8_t     op;         // request op, replaced by response status
+    uint8_t     len;
+    uint8_t     data[RPC_PAYLOAD_MAX];
+}rpc_slot_t;
+
+/**
+ * @brief op handler, called from main loop
+ * @param p_slot    : request. Handler write response payload, len and status (op field)
+ * @return uint8_t  : RPC_DONE or RPC_PENDING
+ */
+typedef uint8_t (*rpc_op_fn_t)(rpc_slot_t *p_slot);
+
+/**
+ * @brief op table, indexed by op code (Rpc_ops.c)
+ */
+extern const rpc_op_fn_t rpc_ops[];
+extern const uint8_t rpc_ops_cnt;
+
+/**
+ * @brief struct of all available methods of this module
+ */
+typedef struct _Rpc_methods_t{
+    void     (*start)    (serial_ctrl_desc_t *p_serial);  // take over serial port
+    void     (*stop)     (void);                          // give serial port back
+    void     (*exe)      (void);                          // call from main loop
+}Rpc_methods_t;
+
+extern Rpc_methods_t Rpc;
+
+/**
+ * @brief finish pending request. Safe to call from interrupt.
+ * @param p_slot    : slot that was passed to handler that returned RPC_PENDING
+ */
+void Rpc_complete(rpc_slot_t *p_slot);
+
+/**
+ * @brief polled from Rpc.exe(), lets ops with RPC_PENDING requests complete them (Rpc_ops.c)
+ */
+void Rpc_ops_exe(void);
+
+/**
+ * @brief called from Rpc.start(), forgets requests of previous session (Rpc_ops.c)
+ */
+void Rpc_ops_reset(void);
+
+#endif /* RPC_H */
@@ -0,0 +1,103 @@
+/**
+ * @file Rpc_ops.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief RPC op handlers. Op code is index into rpc_ops[]
+ *
+ *  0x00 exit        : give serial port back to shell (handled in Rpc.c)
+ *  0x01 echo        : payload is returned as is
+ *  0x02 delay echo  : uint16 delay_ms | data, data is returned after delay (async completion)
+ *  0x03 get tick    : returns uint32 HAL tick
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "Rpc.h"
+/* dependencies */
+#include <string.h>
+#include "stm32f1xx_hal.h"
+
+typedef struct _rpc_delayed_t{
+    rpc_slot_t  *p_slot;
+    uint32_t    start_tm;
+    uint16_t    delay;
+}rpc_delayed_t;
+
+static uint8_t op_echo       (rpc_slot_t *p_slot);
+static uint8_t op_delay_echo (rpc_slot_t *p_slot);
+static uint8_t op_get_tick   (rpc_slot_t *p_slot);
+
+//=========================================================
+/* create needed object  */
+static rpc_delayed_t rpc_delayed[RPC_MAX_INFLIGHT];
+
+const rpc_op_fn_t rpc_ops[] = {
+    NULL,               // exit, handled in Rpc.c
+    &op_echo,
+    &op_delay_echo,
+    &op_get_tick,
+};
+const uint8_t rpc_ops_cnt = sizeof(rpc_ops) / sizeof(rpc_ops[0]);
+//=========================================================
+
+static uint8_t op_echo(rpc_slot_t *p_slot) {
+    p_slot->op = RPC_OK;
+    return RPC_DONE;
+}
+
+static uint8_t op_delay_echo(rpc_slot_t *p_slot) {
+    uint_fast8_t i;
+
+    if (p_slot->len < 2) {
+        p_slot->op = RPC_ERR_ARG;
+        p_slot->len = 0;
+        return RPC_DONE;
+    }
+    for (i = 0; i < RPC_MAX_INFLIGHT; ++i) {
+        if (rpc_delayed[i].p_slot == NULL) {
+            rpc_delayed[i].p_slot = p_slot;
+            rpc_delayed[i].start_tm = HAL_GetTick();
+            rpc_delayed[i].delay = (uint16_t)(p_slot->data[0] | (p_slot->data[1] << 8));
+            return RPC_PENDING;
+        }
+    }
+    /* can not happen, there is one entry per slot */
+    p_slot->op = RPC_ERR_BUSY;
+    p_slot->len = 0;
+    return RPC_DONE;
+}
+
+static uint8_t op_get_tick(rpc_slot_t *p_slot) {
+    uint32_t tick = HAL_GetTick();
+
+    memcpy(p_slot->data, &tick, sizeof(tick));
+    p_slot->len = sizeof(tick);
+    p_slot->op = RPC_OK;
+    return RPC_DONE;
+}
+
+void Rpc_ops_reset(void) {
+    uint_fast8_t i;
+
+    for (i = 0; i < RPC_MAX_INFLIGHT; ++i) {
+        rpc_delayed[i].p_slot = NULL;
+    }
+}
+
+void Rpc_ops_exe(void) {
+    uint_fast8_t i;
+    rpc_slot_t *p_slot;
+
+    for (i = 0; i < RPC_MAX_INFLIGHT; ++i) {
+        p_slot = rpc_delayed[i].p_slot;
+        if ( (p_slot != NULL) && ((HAL_GetTick() - rpc_delayed[i].start_tm) >= rpc_delayed[i].delay) ) {
+            /* drop delay field, echo the rest */
+            p_slot->len -= 2;
+            memmove(p_slot->data, &p_slot->data[2], p_slot->len);
+            p_slot->op = RPC_OK;
+            rpc_delayed[i].p_slot = NULL;
+            Rpc_complete(p_slot);
+        }
+    }
+}
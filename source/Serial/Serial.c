@@ -11,8 +11,13 @@
  */
 #include "Serial.h"
 /* dependencies */
+#include "Crit.h"
 #include "stm32f1xx_hal.h"
 #include "assert_gorenje.h"
+#include "Trace.h"
+#include "RamFunc.h"
+#include "Startup.h"
+#include "Led.h"
 
 //=========================================================
 /*Set buffer size for different HW serial channels */
@@ -100,6 +105,14 @@ void        flush       (serial_ctrl_desc_t *p_ctrl_desc);
  */
 uint32_t    Rx_lastTime (serial_ctrl_desc_t *p_ctrl_desc);
 
+/**
+ * @brief return number of bytes that can be written to transmit buffer without overwriting
+ * data that was not sent yet. Use it to push bulk data in chunks.
+ * @param p_ctrl_desc   : pointer to serial HW descriptor
+ * @return uint16_t     : free space in Tx buffer
+ */
+uint16_t    Tx_free     (serial_ctrl_desc_t *p_ctrl_desc);
+
 void not_implemented(void);
 
 static HAL_StatusTypeDef HAL_status;
@@ -111,8 +124,9 @@ static HAL_StatusTypeDef HAL_status;
     ringBuff_t xBuff_0_Tx;
     ringBuff_t xBuff_0_Rx;
 
-    ringBuff_data_t buff_0_Tx[BUFF_0_TX_SIZE]; 
-    ringBuff_data_t buff_0_Rx[BUFF_0_RX_SIZE]; 
+    /* RingBuff_init() resets indexes, data needs no zeroing */
+    NOINIT ringBuff_data_t buff_0_Tx[BUFF_0_TX_SIZE]; 
+    NOINIT ringBuff_data_t buff_0_Rx[BUFF_0_RX_SIZE]; 
 
     /* instance of control block */
     serial_ctrl_desc_t serial_0 = {
@@ -124,7 +138,10 @@ static HAL_StatusTypeDef HAL_status;
         0,
         0,
         0,
-        0
+        0,
+        NULL,
+        BUFF_0_TX_SIZE,
+        BUFF_0_RX_SIZE
     };
 #endif
 
@@ -133,8 +150,8 @@ static HAL_StatusTypeDef HAL_status;
     ringBuff_t xBuff_1_Tx;
     ringBuff_t xBuff_1_Rx;
 
-    ringBuff_data_t buff_1_Tx[BUFF_1_TX_SIZE]; 
-    ringBuff_data_t buff_1_Rx[BUFF_1_RX_SIZE]; 
+    NOINIT ringBuff_data_t buff_1_Tx[BUFF_1_TX_SIZE]; 
+    NOINIT ringBuff_data_t buff_1_Rx[BUFF_1_RX_SIZE]; 
 
     serial_ctrl_desc_t serial_1 = {
         NULL,
@@ -145,7 +162,10 @@ static HAL_StatusTypeDef HAL_status;
         0,
         0,
         0,
-        0
+        0,
+        NULL,
+        BUFF_1_TX_SIZE,
+        BUFF_1_RX_SIZE
     };
 
 #endif
@@ -155,8 +175,8 @@ static HAL_StatusTypeDef HAL_status;
     ringBuff_t xBuff_2_Tx;
     ringBuff_t xBuff_2_Rx;
 
-    ringBuff_data_t buff_2_Tx[BUFF_2_TX_SIZE]; 
-    ringBuff_data_t buff_2_Rx[BUFF_2_RX_SIZE]; 
+    NOINIT ringBuff_data_t buff_2_Tx[BUFF_2_TX_SIZE]; 
+    NOINIT ringBuff_data_t buff_2_Rx[BUFF_2_RX_SIZE]; 
     
     serial_ctrl_desc_t serial_2 = {
         NULL,
@@ -167,7 +187,10 @@ static HAL_StatusTypeDef HAL_status;
         0,
         0,
         0,
-        0
+        0,
+        NULL,
+        BUFF_2_TX_SIZE,
+        BUFF_2_RX_SIZE
     };
 
 #endif
@@ -184,7 +207,8 @@ Serial_methods_t Serial = {
     &readUntil,
     &isData,
     &flush,
-    &Rx_lastTime
+    &Rx_lastTime,
+    &Tx_free
 };
 //=========================================================
 
@@ -194,8 +218,8 @@ void Serial_init(serial_ctrl_desc_t *p_Serial_ctrl_desc, void *p_HW_handle) {
     assert(p_Serial_ctrl_desc != NULL);
     assert(p_HW_handle != NULL);
 
-    RingBuff_init(p_Serial_ctrl_desc->p_xBuff_Tx, p_Serial_ctrl_desc->p_data_Tx, BUFF_0_TX_SIZE);
-    RingBuff_init(p_Serial_ctrl_desc->p_xBuff_Rx, p_Serial_ctrl_desc->p_data_Rx, BUFF_0_RX_SIZE);
+    RingBuff_init(p_Serial_ctrl_desc->p_xBuff_Tx, p_Serial_ctrl_desc->p_data_Tx, p_Serial_ctrl_desc->Tx_size);
+    RingBuff_init(p_Serial_ctrl_desc->p_xBuff_Rx, p_Serial_ctrl_desc->p_data_Rx, p_Serial_ctrl_desc->Rx_size);
 
     p_Serial_ctrl_desc->p_uartHW = (UART_HandleTypeDef*)p_HW_handle;
 }
@@ -208,6 +232,7 @@ void print(serial_ctrl_desc_t *p_ctrl_desc, const uint8_t * const pStr){
     /* write to ring buffer and start send if not currently not active */
     uint_fast8_t i = 0;
     static uint_fast8_t byte2send;
+    crit_state_t primask;
 
     while (pStr[i] != 0x00) // const c-strings are '\0'(0x00) terminated 
     {
@@ -215,9 +240,12 @@ void print(serial_ctrl_desc_t *p_ctrl_desc, const uint8_t * const pStr){
         RingBuff.push(p_ctrl_desc->p_xBuff_Tx, pStr[i++]);
     }
         
+    /* Tx complete interrupt may clear Tx_active_F meanwhile */
+    primask = Crit_enter();
     if (p_ctrl_desc->Tx_active_F == 0)
     {
         // initiate send
+        Startup_stamp(STARTUP_SERIAL_TX);
         byte2send = RingBuff.get(p_ctrl_desc->p_xBuff_Tx);
         HAL_status = HAL_UART_Transmit_IT(p_ctrl_desc->p_uartHW, &byte2send, 1);
         if (HAL_status != HAL_OK)
@@ -226,6 +254,7 @@ void print(serial_ctrl_desc_t *p_ctrl_desc, const uint8_t * const pStr){
         }
         p_ctrl_desc->Tx_active_F = 1;
     }
+    Crit_exit(primask);
 }
 
 void println(serial_ctrl_desc_t *p_ctrl_desc, const uint8_t * const pStr){
@@ -237,6 +266,7 @@ void write(serial_ctrl_desc_t *p_ctrl_desc, uint8_t *const pSurce, size_t size){
     /* write to ring buffer and start send if not currently not active */
     uint_fast8_t i = 0;
     static uint_fast8_t byte2send;
+    crit_state_t primask;
 
     while (i < size) // const c-strings are '\0'(0x00) terminated 
     {
@@ -244,9 +274,12 @@ void write(serial_ctrl_desc_t *p_ctrl_desc, uint8_t *const pSurce, size_t size){
         RingBuff.push(p_ctrl_desc->p_xBuff_Tx, pSurce[i++]);
     }
         
+    /* Tx complete interrupt may clear Tx_active_F meanwhile */
+    primask = Crit_enter();
     if (p_ctrl_desc->Tx_active_F == 0)
     {
         // initiate send
+        Startup_stamp(STARTUP_SERIAL_TX);
         byte2send = RingBuff.get(p_ctrl_desc->p_xBuff_Tx);
         HAL_status = HAL_UART_Transmit_IT(p_ctrl_desc->p_uartHW, &byte2send, 1);
         if (HAL_status != HAL_OK)
@@ -255,6 +288,7 @@ void write(serial_ctrl_desc_t *p_ctrl_desc, uint8_t *const pSurce, size_t size){
         }
         p_ctrl_desc->Tx_active_F = 1;
     }
+    Crit_exit(primask);
 }
 
 
@@ -272,6 +306,17 @@ uint32_t Rx_lastTime(serial_ctrl_desc_t *p_ctrl_desc){
     return p_ctrl_desc->last_tm;
 }
 
+uint16_t Tx_free(serial_ctrl_desc_t *p_ctrl_desc){
+    /* one place is kept in reserve, so data is never overwritten even if ring buffer
+       implementation need it to distinguish full from empty */
+    uint_fast16_t used = RingBuff.get_nBytes(p_ctrl_desc->p_xBuff_Tx);
+
+    if (used >= (p_ctrl_desc->Tx_size - 1u)) {
+        return 0;
+    }
+    return (p_ctrl_desc->Tx_size - 1u) - used;
+}
+
 void read_enable(serial_ctrl_desc_t *p_ctrl_desc) {
     /* start read */
     if(p_ctrl_desc->Rx_active_F == 0) {
@@ -321,12 +366,15 @@ uint16_t readUntil(serial_ctrl_desc_t *p_ctrl_desc, uint8_t *pDest, uint8_t nByt
 }
 //=========================================================
 
-/* called from HAL leyer interrupt */
-void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+/* called from HAL leyer interrupt, whole Serial interrupt path runs from SRAM */
+RAMFUNC void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
     /* this callback function could run ring buffer to handle multiple messages */ 
     serial_ctrl_desc_t *p_serial;
     static uint_fast8_t byte2send;
 
+    TRACE_BEGIN(TRACE_ID_ISR_UART_TX);
+    Led_activity();
+
     if(serial_0.p_uartHW == huart) {
         p_serial = &serial_0;
     }
@@ -355,12 +403,17 @@ void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
         /* no more data to send */
         p_serial->Tx_active_F = 0;
     }
+
+    TRACE_END(TRACE_ID_ISR_UART_TX);
 }
 
 
-void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) {
+RAMFUNC void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) {
     serial_ctrl_desc_t *p_serial;
 
+    TRACE_BEGIN(TRACE_ID_ISR_UART_RX);
+    Led_activity();
+
     if(serial_0.p_uartHW == huart) {
         p_serial = &serial_0;
     }
@@ -377,12 +430,16 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) {
 
     assert(p_serial != NULL);
     /* save received byte into ringBuffer */
-    RingBuff.push(p_serial->p_xBuff_Rx, p_serial->byteTemp_Rx);
+    if ( (p_serial->Rx_hook == NULL) || (p_serial->Rx_hook(p_serial, p_serial->byteTemp_Rx) != 0) ) {
+        RingBuff.push(p_serial->p_xBuff_Rx, p_serial->byteTemp_Rx);
+    }
 
     serial_0.last_tm = HAL_GetTick();
 
     /* reenable Rx */
     HAL_UART_Receive_IT(p_serial->p_uartHW, &p_serial->byteTemp_Rx, 1);
+
+    TRACE_END(TRACE_ID_ISR_UART_RX);
 }
 
 
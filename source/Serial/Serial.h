@@ -37,6 +37,11 @@ typedef struct _serial_ctrl_desc_t{
     uint8_t             Rx_active_F; // flag that set if Rx is active or not
     uint8_t             Tx_active_F; // flag that set if Tx is active or not
     uint32_t            last_tm;     // last time that character was received
+    /* optional, called from Rx interrupt for every received byte. Return 0 if byte was
+       consumed by the hook, 1 if it should be stored into Rx buffer as usual */
+    uint8_t             (*Rx_hook)(struct _serial_ctrl_desc_t *p_ctrl_desc, uint8_t byte);
+    uint16_t            Tx_size;     // size of data buffer Tx
+    uint16_t            Rx_size;     // size of data buffer Rx
 }serial_ctrl_desc_t;
 
 /**
@@ -53,6 +58,7 @@ typedef struct _Serial_methods_t{
     uint16_t (*isData)       (serial_ctrl_desc_t *p_ctrl_desc);
     void     (*flush)        (serial_ctrl_desc_t *p_ctrl_desc);
     uint32_t (*Rx_lastTime)  (serial_ctrl_desc_t *p_ctrl_desc);
+    uint16_t (*Tx_free)      (serial_ctrl_desc_t *p_ctrl_desc); // free space in Tx buffer
 
 }Serial_methods_t;
 
@@ -0,0 +1,278 @@
+/**
+ * @file Shell.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief command line shell over serial
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "Shell.h"
+/* dependencies */
+#include <string.h>
+#include "Crit.h"
+#include "assert_gorenje.h"
+#include "num_str_convert.h"
+
+#define CHR_BS      0x08
+#define CHR_DEL     0x7F
+
+typedef struct _shell_ctrl_t{
+    serial_ctrl_desc_t  *p_serial;
+    char                line[SHELL_LINE_SIZE];
+    volatile uint8_t    len;        // written by Rx interrupt
+    volatile uint8_t    keep;       // echo is valid up to here, lowered by backspace
+    volatile uint8_t    ready_F;    // line complete, wait for main loop. Rx input is ignored
+    uint8_t             echo;       // characters echoed, main loop only
+    uint8_t             last_chr;   // to skip '\n' of "\r\n"
+}shell_ctrl_t;
+
+static void     exe         (void);
+static uint16_t cmd_cnt     (void);
+static uint32_t ram_size    (void);
+static uint8_t  Rx_isr      (serial_ctrl_desc_t *p_serial, uint8_t byte);
+static void     cmd_help    (serial_ctrl_desc_t *p_serial, uint8_t argc, char *argv[]);
+
+/* command table, created by linker */
+extern const shell_cmd_t __shell_cmd_start[];
+extern const shell_cmd_t __shell_cmd_end[];
+
+//=========================================================
+/* create needed object  */
+static shell_ctrl_t shell;
+
+Shell_methods_t Shell = {
+    &exe,
+    &cmd_cnt,
+    &ram_size
+};
+
+SHELL_CMD(help, cmd_help, "list commands");
+//=========================================================
+
+/* constructor */
+void Shell_init(serial_ctrl_desc_t *p_serial) {
+    uint16_t i;
+
+    assert(p_serial != NULL);
+
+    /* linker should sort the table, binary search depends on it */
+    for (i = 1; i < cmd_cnt(); ++i) {
+        assert(strcmp(__shell_cmd_start[i - 1].name, __shell_cmd_start[i].name) < 0);
+    }
+
+    shell.p_serial = p_serial;
+    shell.len = 0;
+    shell.keep = 0;
+    shell.echo = 0;
+    shell.ready_F = 0;
+    shell.last_chr = 0;
+    p_serial->Rx_hook = &Rx_isr;
+
+    Shell_print(p_serial, "\r\nshell: ");
+    Shell_print_u32(p_serial, cmd_cnt());
+    Shell_print(p_serial, " commands, RAM ");
+    Shell_print_u32(p_serial, ram_size());
+    Shell_print(p_serial, " bytes\r\n" SHELL_PROMPT);
+}
+
+static void print_n(serial_ctrl_desc_t *p_serial, const char *pStr, size_t len) {
+    size_t chunk;
+
+    while (len > 0) {
+        chunk = Serial.Tx_free(p_serial);
+        if (chunk > len) {
+            chunk = len;
+        }
+        if (chunk > 0) {
+            Serial.write(p_serial, (uint8_t *)pStr, chunk);
+            pStr += chunk;
+            len -= chunk;
+        }
+    }
+}
+
+void Shell_print(serial_ctrl_desc_t *p_serial, const char *pStr) {
+    print_n(p_serial, pStr, strlen(pStr));
+}
+
+void Shell_print_u32(serial_ctrl_desc_t *p_serial, uint32_t num) {
+    uint8_t num_str[12];
+
+    num2str(num, num_str);
+    Shell_print(p_serial, (const char *)num_str);
+}
+
+void Shell_print_hex(serial_ctrl_desc_t *p_serial, uint32_t num) {
+    static const char digits[] = "0123456789abcdef";
+    char hex_str[9];
+    int8_t i;
+
+    for (i = 7; i >= 0; --i) {
+        hex_str[i] = digits[num & 0x0Fu];
+        num >>= 4;
+    }
+    hex_str[8] = '\0';
+    Shell_print(p_serial, hex_str);
+}
+
+//=========================================================
+/* methods implementation */
+
+static uint16_t cmd_cnt(void) {
+    return (uint16_t)(__shell_cmd_end - __shell_cmd_start);
+}
+
+static uint32_t ram_size(void) {
+    return sizeof(shell);
+}
+
+static const shell_cmd_t *cmd_find(const char *p_name) {
+    int_fast16_t lo = 0;
+    int_fast16_t hi = (int_fast16_t)cmd_cnt() - 1;
+
+    while (lo <= hi) {
+        int_fast16_t mid = (lo + hi) / 2;
+        int cmp = strcmp(p_name, __shell_cmd_start[mid].name);
+
+        if (cmp == 0) {
+            return &__shell_cmd_start[mid];
+        } else if (cmp < 0) {
+            hi = mid - 1;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return NULL;
+}
+
+static uint8_t tokenize(char *p_line, char *argv[]) {
+    uint8_t argc = 0;
+
+    while (*p_line != '\0') {
+        while (*p_line == ' ') {
+            *p_line++ = '\0';
+        }
+        if (*p_line == '\0') {
+            break;
+        }
+        if (argc == SHELL_MAX_ARGS) {
+            /* rest of line stay in last argument */
+            break;
+        }
+        argv[argc++] = p_line;
+        while ( (*p_line != ' ') && (*p_line != '\0') ) {
+            p_line++;
+        }
+    }
+    return argc;
+}
+
+/**
+ * @brief bring terminal in line with what Rx interrupt edited since last call
+ */
+static void echo(void) {
+    crit_state_t primask;
+    uint8_t keep;
+    uint8_t len;
+
+    primask = Crit_enter();
+    keep = shell.keep;
+    len = shell.len;
+    shell.keep = len;
+    Crit_exit(primask);
+
+    while (shell.echo > keep) {
+        Shell_print(shell.p_serial, "\b \b");
+        shell.echo--;
+    }
+    if (len > shell.echo) {
+        print_n(shell.p_serial, &shell.line[shell.echo], (size_t)(len - shell.echo));
+        shell.echo = len;
+    }
+}
+
+static void exe(void) {
+    char *argv[SHELL_MAX_ARGS];
+    uint8_t argc;
+    const shell_cmd_t *p_cmd;
+
+    /* port taken over by a command (rpc, modbus) */
+    if (shell.p_serial->Rx_hook != &Rx_isr) {
+        return;
+    }
+    echo();
+    if (shell.ready_F == 0) {
+        return;
+    }
+    Shell_print(shell.p_serial, "\r\n");
+
+    argc = tokenize(shell.line, argv);
+    if (argc > 0) {
+        p_cmd = cmd_find(argv[0]);
+        if (p_cmd != NULL) {
+            p_cmd->fn(shell.p_serial, argc, argv);
+        } else {
+            Shell_print(shell.p_serial, "unknown command: ");
+            Shell_print(shell.p_serial, argv[0]);
+            Shell_print(shell.p_serial, "\r\n");
+        }
+    }
+    /* no prompt into a port taken over by command (rpc, modbus) */
+    if (shell.p_serial->Rx_hook == &Rx_isr) {
+        Shell_print(shell.p_serial, SHELL_PROMPT);
+    }
+
+    /* release line to Rx interrupt */
+    shell.len = 0;
+    shell.keep = 0;
+    shell.echo = 0;
+    shell.ready_F = 0;
+}
+
+/* called from uart Rx interrupt */
+static uint8_t Rx_isr(serial_ctrl_desc_t *p_serial, uint8_t byte) {
+    uint8_t last_chr = shell.last_chr;
+
+    (void)p_serial;
+    shell.last_chr = byte;
+    if (shell.ready_F != 0) {
+        /* previous command still running */
+        return 0;
+    }
+
+    if ( (byte == '\r') || (byte == '\n') ) {
+        if ( (byte == '\n') && (last_chr == '\r') ) {
+            return 0;
+        }
+        shell.line[shell.len] = '\0';
+        shell.ready_F = 1;
+    } else if ( (byte == CHR_BS) || (byte == CHR_DEL) ) {
+        if (shell.len > 0) {
+            shell.len--;
+            if (shell.len < shell.keep) {
+                shell.keep = shell.len;
+            }
+        }
+    } else if ( (byte >= ' ') && (byte <= '~') ) {
+        if (shell.len < (SHELL_LINE_SIZE - 1)) {
+            shell.line[shell.len++] = (char)byte;
+        }
+    }
+    return 0;
+}
+
+static void cmd_help(serial_ctrl_desc_t *p_serial, uint8_t argc, char *argv[]) {
+    const shell_cmd_t *p_cmd;
+
+    (void)argc;
+    (void)argv;
+
+    for (p_cmd = __shell_cmd_start; p_cmd < __shell_cmd_end; ++p_cmd) {
+        Shell_print(p_serial, p_cmd->name);
+        Shell_print(p_serial, "\t- ");
+        Shell_print(p_serial, p_cmd->help);
+        Shell_print(p_serial, "\r\n");
+    }
+}
@@ -0,0 +1,95 @@
+/**
+ * @file Shell.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief command line shell over serial. Line is edited in Rx interrupt, echo and command
+ * are done from main loop by Shell.exe(), so Serial Tx buffer is written from main loop
+ * only and is filled without masking interrupts.
+ *
+ * Commands are registered at compile time with SHELL_CMD() in any source file. Linker
+ * collects them into one table sorted by name (see .shell_cmd in STM32F103C8_FLASH.ld),
+ * command lookup is binary search. Line is tokenized in place, no copies are made.
+ * All memory is static: see Shell.ram_size()
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+
+#ifndef SHELL_H
+#define SHELL_H
+
+#include <stdint.h>
+
+#include "Serial.h"
+
+//=======================================================================================
+/**
+ * @brief max length of command line including '\0'
+ */
+#define SHELL_LINE_SIZE     64
+
+/**
+ * @brief max number of arguments including command name
+ */
+#define SHELL_MAX_ARGS      8
+
+#define SHELL_PROMPT        "> "
+//=======================================================================================
+
+/**
+ * @brief command handler
+ * @param p_serial  : serial port to write response to
+ * @param argc      : number of arguments, argv[0] is command name
+ * @param argv      : '\0' terminated arguments
+ */
+typedef void (*shell_cmd_fn_t)(serial_ctrl_desc_t *p_serial, uint8_t argc, char *argv[]);
+
+typedef struct _shell_cmd_t{
+    const char      *name;
+    shell_cmd_fn_t  fn;
+    const char      *help;
+}shell_cmd_t;
+
+/**
+ * @brief register command. Name must be valid C identifier
+ */
+#define SHELL_CMD(cmd_name, cmd_fn, help_str)                                           \
+    static const shell_cmd_t _shell_cmd_##cmd_name                                      \
+    __attribute__((section(".shell_cmd." #cmd_name), used)) = { #cmd_name, cmd_fn, help_str }
+
+/**
+ * @brief struct of all available methods of this module
+ */
+typedef struct _Shell_methods_t{
+    void     (*exe)      (void);     // call from main loop, execute received command line
+    uint16_t (*cmd_cnt)  (void);     // number of registered commands
+    uint32_t (*ram_size) (void);     // static RAM used by shell in bytes
+}Shell_methods_t;
+
+extern Shell_methods_t Shell;
+
+/**
+ * @brief attach shell to serial port. Serial must be initialized and read enabled.
+ * All received bytes are consumed by shell from now on.
+ * @param p_serial  : pointer to serial descriptor
+ */
+void Shell_init(serial_ctrl_desc_t *p_serial);
+
+/**
+ * @brief print string, wait for space in Tx buffer if needed, so response longer than
+ * Tx buffer is not lost. Use from main loop (command handlers) only.
+ */
+void Shell_print(serial_ctrl_desc_t *p_serial, const char *pStr);
+
+/**
+ * @brief print unsigned number (helper for command handlers)
+ */
+void Shell_print_u32(serial_ctrl_desc_t *p_serial, uint32_t num);
+
+/**
+ * @brief print 32 bit number as 8 hex digits, no prefix (helper for command handlers)
+ */
+void Shell_print_hex(serial_ctrl_desc_t *p_serial, uint32_t num);
+
+#endif /* SHELL_H */
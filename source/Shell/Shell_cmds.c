@@ -0,0 +1,566 @@
+/**
+ * @file Shell_cmds.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief application shell commands
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "Shell.h"
+/* dependencies */
+#include "stm32f1xx_hal.h"
+#include "Trace.h"
+#include "Rpc.h"
+#include "Modbus.h"
+#include "KVstore.h"
+#include "FlashLog.h"
+#include "Pool.h"
+#include "Stack.h"
+#include "Startup.h"
+#include "Fault.h"
+#include "Prof.h"
+#include "Latency.h"
+#include "Led.h"
+#include "Input.h"
+#include "Capture.h"
+#include "Wave.h"
+#include "Logic.h"
+#include "Adc.h"
+#include "Encoder.h"
+#include "Boot.h"
+#include "TimOwner.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static void cmd_trace(serial_ctrl_desc_t *p_serial, uint8_t argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+    /* binary dump is sent from main loop by Trace.dump_exe() */
+    Trace.dump_start(p_serial);
+}
+SHELL_CMD(trace, cmd_trace, "binary dump of event trace (tools/trace/trace_decode.py)");
+
+static void cmd_uptime(serial_ctrl_desc_t *p_serial, uint8_t argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+    Shell_print(p_serial, "upTime in seconds: ");
+    Shell_print_u32(p_serial, HAL_GetTick() / 1000);
+    Shell_print(p_serial, "\r\n");
+}
+SHELL_CMD(uptime, cmd_uptime, "time from reset");
+
+static void cmd_rpc(serial_ctrl_desc_t *p_serial, uint8_t argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+    /* binary frames from now on, until exit request (tools/rpc/rpc_bench.py) */
+    Rpc.start(p_serial);
+}
+SHELL_CMD(rpc, cmd_rpc, "switch port to binary RPC mode");
+
+static void cmd_modbus(serial_ctrl_desc_t *p_serial, uint8_t argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+    Shell_print(p_serial, "modbus RTU slave, address ");
+    Shell_print_u32(p_serial, MODBUS_SLAVE_ADDR);
+    Shell_print(p_serial, " (reset to leave)\r\n");
+    Modbus.start(p_serial);
+}
+SHELL_CMD(modbus, cmd_modbus, "switch port to Modbus RTU slave");
+
+static void kv_print_stats(serial_ctrl_desc_t *p_serial) {
+    const kv_stats_t *p_stats = KVstore.stats();
+    uint8_t page;
+
+    Shell_print(p_serial, "keys ");
+    Shell_print_u32(p_serial, p_stats->keys);
+    Shell_print(p_serial, ", live bytes ");
+    Shell_print_u32(p_serial, p_stats->live_bytes);
+    Shell_print(p_serial, ", page fill ");
+    Shell_print_u32(p_serial, p_stats->used_bytes);
+    Shell_print(p_serial, "/" );
+    Shell_print_u32(p_serial, KV_PAGE_SIZE);
+    Shell_print(p_serial, ", compactions ");
+    Shell_print_u32(p_serial, p_stats->compactions);
+    Shell_print(p_serial, "\r\nerases per page:");
+    for (page = 0; page < KV_PAGE_CNT; ++page) {
+        Shell_print(p_serial, " ");
+        Shell_print_u32(p_serial, p_stats->erase_cnt[page]);
+    }
+    Shell_print(p_serial, "\r\n");
+}
+
+static void cmd_kv(serial_ctrl_desc_t *p_serial, uint8_t argc, char *argv[]) {
+    char val[KV_VALUE_MAX + 1];
+    uint16_t key;
+    int16_t len;
+    kv_status_t status = KV_OK;
+
+    if (argc < 3) {
+        kv_print_stats(p_serial);
+        return;
+    }
+    key = (uint16_t)strtoul(argv[2], NULL, 0);
+    if (strcmp(argv[1], "get") == 0) {
+        len = KVstore.read(key, val, KV_VALUE_MAX);
+        if (len >= 0) {
+            val[len] = '\0';
+            Shell_print(p_serial, val);
+            Shell_print(p_serial, "\r\n");
+            return;
+        }
+        status = (kv_status_t)len;
+    } else if ( (strcmp(argv[1], "set") == 0) && (argc > 3) ) {
+        status = KVstore.write(key, argv[3], (uint8_t)strnlen(argv[3], KV_VALUE_MAX + 1));
+    } else if (strcmp(argv[1], "del") == 0) {
+        status = KVstore.remove(key);
+    } else {
+        Shell_print(p_serial, "usage: kv [get|set|del <key> [text]]\r\n");
+        return;
+    }
+    if (status != KV_OK) {
+        Shell_print(p_serial, "error ");
+        Shell_print_u32(p_serial, (uint32_t)(-status));
+        Shell_print(p_serial, "\r\n");
+    }
+}
+SHELL_CMD(kv, cmd_kv, "config store: kv [get|set|del <key> [text]], no args: stats");
+
+static void cmd_flog(serial_ctrl_desc_t *p_serial, uint8_t argc, char *argv[]) {
+    const flog_stats_t *p_stats;
+
+    if ( (argc > 1) && (strcmp(argv[1], "dump") == 0) ) {
+        /* binary export is sent from main loop by FlashLog.export_exe() */
+        FlashLog.export(p_serial);
+        return;
+    }
+    if ( (argc > 2) && (strcmp(argv[1], "add") == 0) ) {
+        (void)FlashLog.append(FLOG_ID_USER, (uint16_t)strtoul(argv[2], NULL, 0));
+        return;
+    }
+    p_stats = FlashLog.stats();
+    Shell_print(p_serial, "appended ");
+    Shell_print_u32(p_serial, p_stats->appended);
+    Shell_print(p_serial, ", programmed ");
+    Shell_print_u32(p_serial, p_stats->programmed);
+    Shell_print(p_serial, ", dropped ");
+    Shell_print_u32(p_serial, p_stats->dropped);
+    Shell_print(p_serial, ", errors ");
+    Shell_print_u32(p_serial, p_stats->errors);
+    Shell_print(p_serial, ", erases ");
+    Shell_print_u32(p_serial, p_stats->erases);
+    Shell_print(p_serial, ", staged max ");
+    Shell_print_u32(p_serial, p_stats->stage_max);
+    Shell_print(p_serial, "\r\n");
+}
+SHELL_CMD(flog, cmd_flog, "telemetry log: flog [dump|add <arg>], no args: stats");
+
+static void cmd_pool(serial_ctrl_desc_t *p_serial, uint8_t argc, char *argv[]) {
+    const pool_stats_t *p_stats;
+    uint8_t id;
+
+    (void)argc;
+    (void)argv;
+    for (id = 0; id < POOL_CNT; ++id) {
+        p_stats = Pool.stats((pool_id_t)id);
+        Shell_print(p_serial, "block ");
+        Shell_print_u32(p_serial, p_stats->block_size);
+        Shell_print(p_serial, " x ");
+        Shell_print_u32(p_serial, p_stats->block_cnt);
+        Shell_print(p_serial, ": used ");
+        Shell_print_u32(p_serial, p_stats->used);
+        Shell_print(p_serial, ", max ");
+        Shell_print_u32(p_serial, p_stats->used_max);
+        Shell_print(p_serial, ", allocs ");
+        Shell_print_u32(p_serial, p_stats->allocs);
+        Shell_print(p_serial, ", fallbacks ");
+        Shell_print_u32(p_serial, p_stats->fallbacks);
+        Shell_print(p_serial, ", fails ");
+        Shell_print_u32(p_serial, p_stats->fails);
+        Shell_print(p_serial, "\r\n");
+    }
+}
+SHELL_CMD(pool, cmd_pool, "memory pool usage and high water marks");
+
+static void cmd_stack(serial_ctrl_desc_t *p_serial, uint8_t argc, char *argv[]) {
+    stack_info_t info;
+
+    (void)argc;
+    (void)argv;
+    Stack_info(&info);
+    Shell_print(p_serial, "stack: now ");
+    Shell_print_u32(p_serial, info.used);
+    Shell_print(p_serial, ", peak ");
+    Shell_print_u32(p_serial, info.peak);
+    Shell_print(p_serial, " of reserved ");
+    Shell_print_u32(p_serial, info.reserved);
+    Shell_print(p_serial, (info.peak > info.reserved) ? " (OVER)" : "");
+    Shell_print(p_serial, ", headroom to static data ");
+    Shell_print_u32(p_serial, info.size - info.peak);
+    Shell_print(p_serial, " bytes\r\n");
+}
+SHELL_CMD(stack, cmd_stack, "stack depth now and peak since reset, headroom");
+
+static void cmd_startup(serial_ctrl_desc_t *p_serial, uint8_t argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+    Startup_print(p_serial);
+}
+SHELL_CMD(startup, cmd_startup, "boot time per init stage, last stage of previous boot");
+
+static void cmd_fault(serial_ctrl_desc_t *p_serial, uint8_t argc, char *argv[]) {
+    if ( (argc > 1) && (strcmp(argv[1], "test") == 0) ) {
+        Shell_print(p_serial, "undefined instruction in 10 ms\r\n");
+        HAL_Delay(10);
+        __asm volatile ("udf #0");
+        return;
+    }
+    if (Fault_last() == NULL) {
+        Shell_print(p_serial, "no fault since power on\r\n");
+        return;
+    }
+    Fault_print(p_serial);
+}
+SHELL_CMD(fault, cmd_fault, "last crash dump (tools/fault/fault_decode.py), fault test: crash");
+
+/**
+ * @brief start() refused, timer is held by another module
+ */
+static void print_tim_busy(serial_ctrl_desc_t *p_serial, const char *p_name, const TIM_TypeDef *p_tim) {
+    const char *p_owner = TimOwner_get(p_tim);
+
+    Shell_print(p_serial, p_name);
+    Shell_print(p_serial, " busy (");
+    Shell_print(p_serial, (p_owner != NULL) ? p_owner : "?");
+    Shell_print(p_serial, " running)\r\n");
+}
+
+static void cmd_prof(serial_ctrl_desc_t *p_serial, uint8_t argc, char *argv[]) {
+    const prof_stats_t *p_stats;
+    uint32_t rate;
+
+    if (argc > 1) {
+        if (strcmp(argv[1], "start") == 0) {
+            rate = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 10) : 0;
+            if ( (rate != 0) && ((rate < PROF_RATE_MIN) || (rate > PROF_RATE_MAX)) ) {
+                Shell_print(p_serial, "rate ");
+                Shell_print_u32(p_serial, PROF_RATE_MIN);
+                Shell_print(p_serial, " .. ");
+                Shell_print_u32(p_serial, PROF_RATE_MAX);
+                Shell_print(p_serial, " Hz\r\n");
+                return;
+            }
+            if (Prof.start(rate) == 0) {
+                print_tim_busy(p_serial, "TIM1", PROF_TIM);
+                return;
+            }
+        } else if (strcmp(argv[1], "stop") == 0) {
+            Prof.stop();
+        } else if (strcmp(argv[1], "dump") == 0) {
+            /* binary dump is sent from main loop by Prof.dump_exe() */
+            Prof.dump_start(p_serial);
+            return;
+        } else {
+            Shell_print(p_serial, "usage: prof [start [rate]|stop|dump]\r\n");
+            return;
+        }
+    }
+    p_stats = Prof.stats();
+    Shell_print(p_serial, "prof: ");
+    Shell_print_u32(p_serial, p_stats->samples);
+    Shell_print(p_serial, " samples at ");
+    Shell_print_u32(p_serial, p_stats->rate);
+    Shell_print(p_serial, " Hz, sram ");
+    Shell_print_u32(p_serial, p_stats->ram);
+    Shell_print(p_serial, ", other ");
+    Shell_print_u32(p_serial, p_stats->other);
+    Shell_print(p_serial, ", overhead ");
+    /* per mille, cycle counters are 64 bit */
+    Shell_print_u32(p_serial, (p_stats->elapsed != 0) ?
+                    (uint32_t)(((uint64_t)p_stats->isr_cycles * 1000u) / p_stats->elapsed) : 0);
+    Shell_print(p_serial, " permille\r\n");
+}
+SHELL_CMD(prof, cmd_prof, "sampling profiler: prof [start [rate]|stop|dump] (tools/prof/prof_report.py)");
+
+static void print_durations(serial_ctrl_desc_t *p_serial, const char *p_name, const crit_stats_t *p_stats) {
+    uint8_t i;
+
+    Shell_print(p_serial, p_name);
+    Shell_print(p_serial, ": ");
+    Shell_print_u32(p_serial, p_stats->cnt);
+    Shell_print(p_serial, ", avg ");
+    Shell_print_u32(p_serial, (p_stats->cnt != 0) ? (uint32_t)(p_stats->sum / p_stats->cnt) : 0);
+    Shell_print(p_serial, ", max ");
+    Shell_print_u32(p_serial, p_stats->max);
+    Shell_print(p_serial, " cycles at ");
+    Shell_print_hex(p_serial, p_stats->max_pc);
+    Shell_print(p_serial, "\r\n");
+    for (i = 0; i < CRIT_HIST_CNT; ++i) {
+        if (p_stats->hist[i] == 0) {
+            continue;
+        }
+        Shell_print(p_serial, (i < (CRIT_HIST_CNT - 1u)) ? "  < " : "  >= ");
+        Shell_print_u32(p_serial, (i < (CRIT_HIST_CNT - 1u)) ? (2ul << i) : (1ul << i));
+        Shell_print(p_serial, ": ");
+        Shell_print_u32(p_serial, p_stats->hist[i]);
+        Shell_print(p_serial, "\r\n");
+    }
+}
+
+static void cmd_lat(serial_ctrl_desc_t *p_serial, uint8_t argc, char *argv[]) {
+    if (argc > 1) {
+        if (strcmp(argv[1], "start") == 0) {
+            Crit_reset();
+            if (Latency.start((argc > 2) ? (uint8_t)strtoul(argv[2], NULL, 10)
+                                         : LATENCY_PRIO_DEFAULT) == 0) {
+                print_tim_busy(p_serial, "TIM2", LATENCY_TIM);
+            }
+        } else if (strcmp(argv[1], "stop") == 0) {
+            Latency.stop();
+        } else if (strcmp(argv[1], "reset") == 0) {
+            Crit_reset();
+        } else {
+            Shell_print(p_serial, "usage: lat [start [prio]|stop|reset]\r\n");
+        }
+        return;
+    }
+    print_durations(p_serial, "irq latency", Latency.stats());
+    print_durations(p_serial, "PRIMASK sections", Crit_stats(CRIT_PRIMASK));
+    print_durations(p_serial, "BASEPRI sections", Crit_stats(CRIT_BASEPRI));
+}
+SHELL_CMD(lat, cmd_lat, "irq latency and critical sections: lat [start [prio]|stop|reset]");
+
+static void cmd_led(serial_ctrl_desc_t *p_serial, uint8_t argc, char *argv[]) {
+    uint32_t code;
+
+    if ((argc > 1) && (strcmp(argv[1], "heart") == 0)) {
+        Led.play(&LED_HEARTBEAT);
+    } else if ((argc > 1) && (strcmp(argv[1], "activity") == 0)) {
+        Led.activity();
+    } else if ((argc > 1) && (strcmp(argv[1], "off") == 0)) {
+        Led.off();
+    } else if ((argc > 2) && (strcmp(argv[1], "code") == 0)) {
+        code = (uint32_t)strtoul(argv[2], NULL, 10);
+        if ((code == 0) || (code > LED_CODE_MAX)) {
+            Shell_print(p_serial, "code 1 .. 15\r\n");
+            return;
+        }
+        Led.code((uint8_t)code);
+    } else {
+        Shell_print(p_serial, "usage: led [heart|activity|code <n>|off]\r\n");
+    }
+}
+SHELL_CMD(led, cmd_led, "status LED: led [heart|activity|code <n>|off]");
+
+static void cmd_input(serial_ctrl_desc_t *p_serial, uint8_t argc, char *argv[]) {
+    const input_stats_t *p_stats = Input.stats();
+    input_event_t event;
+
+    (void)argc;
+    (void)argv;
+    while (Input.get(&event) != 0) {
+        Shell_print_u32(p_serial, event.time);
+        Shell_print(p_serial, " us ");
+        Shell_print(p_serial, Input.name((input_line_t)event.line));
+        Shell_print(p_serial, (event.level != 0) ? " high\r\n" : " low\r\n");
+    }
+    Shell_print(p_serial, "irq ");
+    Shell_print_u32(p_serial, p_stats->irq);
+    Shell_print(p_serial, ", events ");
+    Shell_print_u32(p_serial, p_stats->events);
+    Shell_print(p_serial, ", bounces ");
+    Shell_print_u32(p_serial, p_stats->bounces);
+    Shell_print(p_serial, ", glitches ");
+    Shell_print_u32(p_serial, p_stats->glitches);
+    Shell_print(p_serial, ", drops ");
+    Shell_print_u32(p_serial, p_stats->drops);
+    Shell_print(p_serial, "\r\n");
+}
+SHELL_CMD(input, cmd_input, "print queued input events and stats");
+
+static void cmd_cap(serial_ctrl_desc_t *p_serial, uint8_t argc, char *argv[]) {
+    capture_result_t res;
+
+    if (argc > 1) {
+        if (strcmp(argv[1], "start") == 0) {
+            if (Capture.start((argc > 2) ? (uint16_t)strtoul(argv[2], NULL, 10) : 0) == 0) {
+                print_tim_busy(p_serial, "TIM3", CAPTURE_TIM);
+            }
+        } else if (strcmp(argv[1], "stop") == 0) {
+            Capture.stop();
+        } else if (strcmp(argv[1], "stream") == 0) {
+            Capture.stream(p_serial);
+        } else if (strcmp(argv[1], "quiet") == 0) {
+            Capture.stream(NULL);
+        } else {
+            Shell_print(p_serial, "usage: cap [start [psc]|stop|stream|quiet]\r\n");
+        }
+        return;
+    }
+    (void)Capture.result(&res);
+    Capture_print(p_serial, &res);
+}
+SHELL_CMD(cap, cmd_cap, "frequency and duty on PB0: cap [start [psc]|stop|stream|quiet]");
+
+static void cmd_wave(serial_ctrl_desc_t *p_serial, uint8_t argc, char *argv[]) {
+    const wave_stats_t *p_stats;
+
+    if (argc > 1) {
+        if (strcmp(argv[1], "start") == 0) {
+            if (Wave.start((argc > 2) ? (uint16_t)strtoul(argv[2], NULL, 10) : 1000u,
+                           (argc > 3) ? (uint8_t)strtoul(argv[3], NULL, 10) : 0u) == 0) {
+                print_tim_busy(p_serial, "TIM1", WAVE_TIM);
+            }
+        } else if (strcmp(argv[1], "stop") == 0) {
+            Wave.stop();
+        } else if ((strcmp(argv[1], "ramp") == 0) && (argc > 3)) {
+            Wave.ramp((uint16_t)strtoul(argv[2], NULL, 10), strtoul(argv[3], NULL, 10));
+        } else {
+            Shell_print(p_serial, "usage: wave [start [period [repeat]]|stop|ramp <to> <samples>]\r\n");
+        }
+        return;
+    }
+    p_stats = Wave.stats();
+    Shell_print(p_serial, "wave: ");
+    Shell_print_u32(p_serial, p_stats->rate);
+    Shell_print(p_serial, " samples/s, segments ");
+    Shell_print_u32(p_serial, p_stats->segments);
+    Shell_print(p_serial, ", underruns ");
+    Shell_print_u32(p_serial, p_stats->underruns);
+    Shell_print(p_serial, ", load ");
+    Shell_print_u32(p_serial, (p_stats->elapsed != 0) ?
+                    (uint32_t)(((uint64_t)p_stats->busy * 1000u) / p_stats->elapsed) : 0);
+    Shell_print(p_serial, " permille\r\n");
+}
+SHELL_CMD(wave, cmd_wave, "PWM waveform on PA8: wave [start [period [repeat]]|stop|ramp <to> <samples>]");
+
+static void cmd_la(serial_ctrl_desc_t *p_serial, uint8_t argc, char *argv[]) {
+    const logic_stats_t *p_stats;
+
+    if (argc > 1) {
+        if ((strcmp(argv[1], "start") == 0) && (argc > 2)) {
+            /* binary stream is sent from main loop by Logic.exe() */
+            if ( (Logic.start(p_serial, strtoul(argv[2], NULL, 10), (argc > 3) ? argv[3][0] : 'B',
+                              (argc > 4) ? (uint16_t)strtoul(argv[4], NULL, 0) : 0u,
+                              (argc > 5) ? strtoul(argv[5], NULL, 10) : 0u) == 0) &&
+                 (TimOwner_get(LOGIC_TIM) != NULL) ) {
+                print_tim_busy(p_serial, "TIM2", LOGIC_TIM);
+            }
+        } else if (strcmp(argv[1], "stop") == 0) {
+            Logic.stop();
+        } else {
+            Shell_print(p_serial, "usage: la [start <rate> [a|b] [mask] [samples]|stop]\r\n");
+        }
+        return;
+    }
+    p_stats = Logic.stats();
+    Shell_print(p_serial, "la: ");
+    Shell_print_u32(p_serial, p_stats->samples);
+    Shell_print(p_serial, " samples, ");
+    Shell_print_u32(p_serial, p_stats->bytes);
+    Shell_print(p_serial, " bytes, lost ");
+    Shell_print_u32(p_serial, p_stats->lost);
+    Shell_print(p_serial, "\r\n");
+}
+SHELL_CMD(la, cmd_la, "logic analyzer: la [start <rate> [a|b] [mask] [samples]|stop] (tools/logic/la_capture.py)");
+
+static void cmd_adc(serial_ctrl_desc_t *p_serial, uint8_t argc, char *argv[]) {
+    const adc_stats_t *p_stats;
+    adc_rec_t rec;
+    uint8_t ch;
+
+    if (argc > 1) {
+        if ( (strcmp(argv[1], "start") == 0) || (strcmp(argv[1], "run") == 0) ) {
+            /* binary stream is sent from main loop by Adc.exe(), "run" only processes */
+            if (Adc.start((argv[1][0] == 's') ? p_serial : NULL,
+                          (argc > 2) ? (adc_smp_t)(strtoul(argv[2], NULL, 10) & 7u) : ADC_SMP_239,
+                          (argc > 3) ? (uint16_t)strtoul(argv[3], NULL, 10) : 0u) == 0) {
+                Shell_print(p_serial, "adc busy, end frame of previous stream not sent yet\r\n");
+            }
+        } else if (strcmp(argv[1], "stop") == 0) {
+            Adc.stop();
+        } else {
+            Shell_print(p_serial, "usage: adc [start|run [smp [decim]]|stop]\r\n");
+        }
+        return;
+    }
+    p_stats = Adc.stats();
+    Shell_print(p_serial, "adc: ");
+    Shell_print_u32(p_serial, p_stats->rate);
+    Shell_print(p_serial, " conversions/s, records ");
+    Shell_print_u32(p_serial, p_stats->records);
+    Shell_print(p_serial, ", drops ");
+    Shell_print_u32(p_serial, p_stats->drops);
+    Shell_print(p_serial, ", overruns ");
+    Shell_print_u32(p_serial, p_stats->overruns);
+    Shell_print(p_serial, ", load ");
+    Shell_print_u32(p_serial, (p_stats->elapsed != 0) ?
+                    (uint32_t)(((uint64_t)p_stats->busy * 1000u) / p_stats->elapsed) : 0);
+    Shell_print(p_serial, " permille\r\n");
+    if (Adc.last(&rec) != 0) {
+        for (ch = 0; ch < ADC_CH_CNT; ++ch) {
+            Shell_print_u32(p_serial, rec.ch[ch].mean);
+            Shell_print(p_serial, " [");
+            Shell_print_u32(p_serial, rec.ch[ch].min);
+            Shell_print(p_serial, " ");
+            Shell_print_u32(p_serial, rec.ch[ch].max);
+            Shell_print(p_serial, "]\r\n");
+        }
+    }
+}
+SHELL_CMD(adc, cmd_adc, "analog scan: adc [start|run [smp [decim]]|stop] (tools/adc/adc_capture.py)");
+
+static void cmd_enc(serial_ctrl_desc_t *p_serial, uint8_t argc, char *argv[]) {
+    const encoder_stats_t *p_stats;
+    int32_t pos;
+    int32_t vel;
+
+    if (argc > 1) {
+        if (strcmp(argv[1], "start") == 0) {
+            if (Encoder.start((argc > 2) ? (uint8_t)(strtoul(argv[2], NULL, 10) & 0x0Fu) : 0u) == 0) {
+                print_tim_busy(p_serial, "TIM3", ENCODER_TIM);
+            }
+        } else if (strcmp(argv[1], "stop") == 0) {
+            Encoder.stop();
+        } else if (strcmp(argv[1], "zero") == 0) {
+            Encoder.set(0);
+        } else {
+            Shell_print(p_serial, "usage: enc [start [filter]|stop|zero]\r\n");
+        }
+        return;
+    }
+    p_stats = Encoder.stats();
+    pos = Encoder.position();
+    vel = Encoder.velocity();
+    Shell_print(p_serial, (pos < 0) ? "enc: -" : "enc: ");
+    Shell_print_u32(p_serial, (uint32_t)((pos < 0) ? -pos : pos));
+    Shell_print(p_serial, (vel < 0) ? " counts, -" : " counts, ");
+    vel = (vel < 0) ? -vel : vel;
+    Shell_print_u32(p_serial, (uint32_t)vel >> ENCODER_VEL_SHIFT);
+    Shell_print(p_serial, ".");
+    Shell_print_u32(p_serial, (((uint32_t)vel & ((1u << ENCODER_VEL_SHIFT) - 1u)) * 10u) >> ENCODER_VEL_SHIFT);
+    Shell_print(p_serial, " counts/s, wraps ");
+    Shell_print_u32(p_serial, p_stats->wraps);
+    if (p_stats->saturated != 0) {
+        Shell_print(p_serial, ", velocity saturated ");
+        Shell_print_u32(p_serial, p_stats->saturated);
+    }
+    Shell_print(p_serial, "\r\n");
+}
+SHELL_CMD(enc, cmd_enc, "quadrature encoder on PA6/PA7: enc [start [filter]|stop|zero]");
+
+static void cmd_boot(serial_ctrl_desc_t *p_serial, uint8_t argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+    Shell_print(p_serial, "reset into bootloader (tools/boot/boot_flash.py)\r\n");
+    /* let the message out, bootloader starts at BOOT_BAUD */
+    HAL_Delay(10);
+    __HAL_RCC_PWR_CLK_ENABLE();
+    __HAL_RCC_BKP_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+    BKP->DR1 = BOOT_REQ_MAGIC;
+    NVIC_SystemReset();
+}
+SHELL_CMD(boot, cmd_boot, "reset into UART bootloader");
@@ -0,0 +1,36 @@
+/**
+ * @file Stack.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief stack watermark
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "Stack.h"
+/* dependencies */
+#include "stm32f1xx.h"
+
+/* linker symbols, only addresses are used */
+extern uint32_t _stack_paint_start;
+extern uint32_t _estack;
+extern uint32_t _Min_Stack_Size;
+
+uint32_t Stack_peak(void) {
+    const uint32_t *p_word = &_stack_paint_start;
+    const uint32_t *p_top = &_estack;
+
+    /* first word that is not painted anymore, from the bottom */
+    while ((p_word < p_top) && (*p_word == STACK_PAINT)) {
+        p_word++;
+    }
+    return (uint32_t)((const uint8_t *)p_top - (const uint8_t *)p_word);
+}
+
+void Stack_info(stack_info_t *p_info) {
+    p_info->size = (uint32_t)((uint8_t *)&_estack - (uint8_t *)&_stack_paint_start);
+    p_info->reserved = (uint32_t)&_Min_Stack_Size;
+    p_info->used = (uint32_t)&_estack - __get_MSP();
+    p_info->peak = Stack_peak();
+}
@@ -0,0 +1,47 @@
+/**
+ * @file Stack.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief stack watermark. Reset_Handler paints all RAM between end of static data
+ * (_stack_paint_start, end of .pool) and top of stack (_estack) with STACK_PAINT, before
+ * anything runs. Bootloader shares the startup file but paints nothing, its linker script
+ * sets _stack_paint_start to _estack. Peak stack depth is the distance from _estack to the
+ * lowest word that is no longer painted.
+ *
+ * Linker only reserves _Min_Stack_Size, the rest above static data is free RAM that stack can
+ * still grow into (newlib heap is not used, source/Pool). Headroom is reported against
+ * both. Shell command "stack" prints the figures.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef STACK_H
+#define STACK_H
+
+#include <stdint.h>
+
+/**
+ * @brief paint word, also used in startup/startup_stm32f103xb.s
+ */
+#define STACK_PAINT         0xDEADBEEFu
+
+typedef struct _stack_info_t{
+    uint32_t    size;       // RAM from _stack_paint_start to _estack, stack can grow into all of it
+    uint32_t    reserved;   // _Min_Stack_Size from linker script
+    uint32_t    used;       // current depth
+    uint32_t    peak;       // deepest since reset
+}stack_info_t;
+
+/**
+ * @brief scan painted region, O(peak free RAM), call from main loop or shell only
+ * @param p_info        : filled with current figures
+ */
+void Stack_info(stack_info_t *p_info);
+
+/**
+ * @brief peak depth since reset in bytes
+ */
+uint32_t Stack_peak(void);
+
+#endif /* STACK_H */
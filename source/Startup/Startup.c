@@ -0,0 +1,123 @@
+/**
+ * @file Startup.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief boot time profile
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "Startup.h"
+/* dependencies */
+#include "CycleCnt.h"
+#include "Shell.h"
+#include "assert_gorenje.h"
+
+#define STARTUP_MAGIC       0x50524F46u     // "PROF"
+
+typedef struct _startup_rec_t{
+    uint32_t    magic;
+    uint32_t    boot_cnt;                   // warm resets since power on
+    uint32_t    cycles[STARTUP_STAMP_CNT];  // 0: stage not finished
+}startup_rec_t;
+
+/* written by Reset_Handler (startup/startup_stm32f103xb.s) */
+extern uint32_t startup_mem_cycles;
+
+/* survives warm reset and bootloader, random after power on */
+KEEPRAM static startup_rec_t startup_rec;
+static startup_rec_t startup_prev;
+
+#define STARTUP_NAME(name, desc)    desc,
+static const char * const startup_name[STARTUP_STAMP_CNT] = {
+    STARTUP_STAMPS(STARTUP_NAME)
+};
+#undef STARTUP_NAME
+
+static void print_cycles(serial_ctrl_desc_t *p_serial, uint32_t cycles);
+
+void Startup_init(void) {
+    uint8_t id;
+
+    startup_prev = startup_rec;
+    if (startup_prev.magic != STARTUP_MAGIC) {
+        startup_prev.magic = 0;
+        startup_prev.boot_cnt = 0;
+    }
+    startup_rec.magic = STARTUP_MAGIC;
+    startup_rec.boot_cnt = (startup_prev.magic == STARTUP_MAGIC) ? (startup_prev.boot_cnt + 1u) : 0;
+    for (id = 0; id < STARTUP_STAMP_CNT; ++id) {
+        startup_rec.cycles[id] = 0;
+    }
+    startup_rec.cycles[STARTUP_MEM_INIT] = startup_mem_cycles;
+    Startup_stamp(STARTUP_MAIN);
+}
+
+void Startup_stamp(startup_stamp_t id) {
+    assert(id < STARTUP_STAMP_CNT);
+    if (startup_rec.cycles[id] == 0) {
+        startup_rec.cycles[id] = CycleCnt_get();
+    }
+}
+
+uint32_t Startup_cycles(startup_stamp_t id) {
+    assert(id < STARTUP_STAMP_CNT);
+    return startup_rec.cycles[id];
+}
+
+const char *Startup_name(startup_stamp_t id) {
+    assert(id < STARTUP_STAMP_CNT);
+    return startup_name[id];
+}
+
+void Startup_print(serial_ctrl_desc_t *p_serial) {
+    uint32_t last = 0;
+    uint32_t cycles;
+    uint8_t id;
+
+    Shell_print(p_serial, "boot #");
+    Shell_print_u32(p_serial, startup_rec.boot_cnt);
+    Shell_print(p_serial, " profile, stage: cycles (us), from reset: cycles (us)\r\n");
+    for (id = 0; id < STARTUP_STAMP_CNT; ++id) {
+        cycles = startup_rec.cycles[id];
+        Shell_print(p_serial, "  ");
+        Shell_print(p_serial, startup_name[id]);
+        if (cycles == 0) {
+            Shell_print(p_serial, ": -\r\n");
+            continue;
+        }
+        Shell_print(p_serial, ": ");
+        print_cycles(p_serial, cycles - last);
+        Shell_print(p_serial, ", ");
+        print_cycles(p_serial, cycles);
+        Shell_print(p_serial, "\r\n");
+        last = cycles;
+    }
+
+    if (startup_prev.magic != STARTUP_MAGIC) {
+        return;
+    }
+    /* last finished stage of previous boot, tells where a reset during init hit */
+    for (id = STARTUP_STAMP_CNT; id > 0u; --id) {
+        if (startup_prev.cycles[id - 1u] != 0) {
+            break;
+        }
+    }
+    Shell_print(p_serial, "previous boot: ");
+    if (id == 0) {
+        Shell_print(p_serial, "no stage finished\r\n");
+        return;
+    }
+    Shell_print(p_serial, startup_name[id - 1u]);
+    Shell_print(p_serial, " done at ");
+    print_cycles(p_serial, startup_prev.cycles[id - 1u]);
+    Shell_print(p_serial, "\r\n");
+}
+
+static void print_cycles(serial_ctrl_desc_t *p_serial, uint32_t cycles) {
+    Shell_print_u32(p_serial, cycles);
+    Shell_print(p_serial, " (");
+    Shell_print_u32(p_serial, CycleCnt_toUs(cycles));
+    Shell_print(p_serial, ")");
+}
@@ -0,0 +1,102 @@
+/**
+ * @file Startup.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief boot time profile, .noinit and .keepram placement. Reset_Handler starts DWT cycle counter
+ * as its first instruction, so stamps are core clock cycles from reset (bootloader time
+ * not included). Core runs from HSI 8 MHz from reset on, cycles convert to us directly.
+ *
+ * Each init stage is stamped when it ends (main.c and Cube USER CODE sections). Record
+ * lives in KEEPRAM, so after a warm reset (watchdog, NVIC_SystemReset) the previous boot
+ * is still readable, i.e. in which stage it stopped. Breakdown is printed once the serial
+ * port is up (STARTUP_PRINT_AT_BOOT) and with shell command "startup".
+ *
+ * Variables tagged NOINIT are placed in .noinit (STM32F103C8_FLASH.ld) and are neither
+ * copied nor zeroed by Reset_Handler. Use it for large buffers that their module
+ * initializes anyway (ring buffers, trace buffer, indexes), content after reset is random.
+ *
+ * Variables tagged KEEPRAM are placed in the top 512 bytes of RAM, reserved by both
+ * STM32F103C8_FLASH.ld and STM32F103C8_BOOT.ld. Bootloader runs with the same startup file
+ * on every reset and overwrites .noinit with its own data and stack, KEEPRAM is the only
+ * RAM that keeps its content until power off. Use it for small records only.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef STARTUP_H
+#define STARTUP_H
+
+#include <stdint.h>
+
+#include "Serial.h"
+
+/**
+ * @brief place variable in .noinit, not zeroed at reset
+ */
+#define NOINIT              __attribute__((section(".noinit")))
+
+/**
+ * @brief place variable in .keepram, kept over warm reset and bootloader run
+ */
+#define KEEPRAM             __attribute__((section(".keepram")))
+
+/**
+ * @brief print breakdown from main after last init stage
+ */
+#define STARTUP_PRINT_AT_BOOT   1
+
+/* profile points in boot order, stamped at end of stage: X(name, stage description) */
+#define STARTUP_STAMPS(X) \
+    X(MEM_INIT,     "Reset_Handler memory init") \
+    X(MAIN,         "SystemInit, libc init") \
+    X(HAL_INIT,     "HAL_Init") \
+    X(CLOCK,        "SystemClock_Config") \
+    X(GPIO,         "MX_GPIO_Init") \
+    X(USART,        "MX_USART1_UART_Init") \
+    X(TIM_NVIC,     "MX_TIM4_Init, MX_NVIC_Init") \
+    X(MODULES,      "RamFunc, Pool, Timebase, Trace, profilers init") \
+    X(SERIAL,       "serial_test_init") \
+    X(FLASHLOG,     "FlashLog_init") \
+    X(KVSTORE,      "KVstore_init") \
+    X(SHELL,        "Shell_init") \
+    X(SERIAL_TX,    "first serial byte") /* stamped by Serial when first byte goes to UART */
+
+#define STARTUP_ID(name, desc)    STARTUP_##name,
+typedef enum _startup_stamp_t{
+    STARTUP_STAMPS(STARTUP_ID)
+    STARTUP_STAMP_CNT
+}startup_stamp_t;
+#undef STARTUP_ID
+
+/**
+ * @brief start new record, first thing in main. Keeps previous one if it is valid
+ */
+void Startup_init(void);
+
+/**
+ * @brief record cycle count at profile point, only first call per point counts
+ * @param id            : profile point
+ */
+void Startup_stamp(startup_stamp_t id);
+
+/**
+ * @brief cycles from reset to profile point, 0 if not reached yet
+ * @param id            : profile point
+ */
+uint32_t Startup_cycles(startup_stamp_t id);
+
+/**
+ * @brief profile point description
+ * @param id            : profile point
+ */
+const char *Startup_name(startup_stamp_t id);
+
+/**
+ * @brief print per stage breakdown and last stage of previous boot, blocks until
+ * all is in Tx buffer
+ * @param p_serial      : port
+ */
+void Startup_print(serial_ctrl_desc_t *p_serial);
+
+#endif /* STARTUP_H */
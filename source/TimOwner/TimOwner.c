@@ -0,0 +1,65 @@
+/**
+ * @file TimOwner.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief owner of general purpose timers shared by modules
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "TimOwner.h"
+/* dependencies */
+#include <stddef.h>
+#include "Crit.h"
+#include "assert_gorenje.h"
+
+#define TIM_OWNER_CNT       4u
+
+//=========================================================
+/* create needed object  */
+static const char *tim_owner[TIM_OWNER_CNT];
+//=========================================================
+
+static uint8_t tim_idx(const TIM_TypeDef *p_tim) {
+    if (p_tim == TIM1) {
+        return 0;
+    } else if (p_tim == TIM2) {
+        return 1;
+    } else if (p_tim == TIM3) {
+        return 2;
+    }
+    assert(p_tim == TIM4);
+    return 3;
+}
+
+uint8_t TimOwner_claim(const TIM_TypeDef *p_tim, const char *p_owner) {
+    const uint8_t idx = tim_idx(p_tim);
+    crit_state_t primask;
+    uint8_t ok = 0;
+
+    assert(p_owner != NULL);
+
+    /* stop() of a module may run from its interrupt */
+    primask = Crit_enter();
+    if ( (tim_owner[idx] == NULL) || (tim_owner[idx] == p_owner) ) {
+        tim_owner[idx] = p_owner;
+        ok = 1;
+    }
+    Crit_exit(primask);
+    return ok;
+}
+
+void TimOwner_release(const TIM_TypeDef *p_tim, const char *p_owner) {
+    const uint8_t idx = tim_idx(p_tim);
+
+    /* nobody else can change it while p_owner holds it */
+    assert(tim_owner[idx] == p_owner);
+    if (tim_owner[idx] == p_owner) {
+        tim_owner[idx] = NULL;
+    }
+}
+
+const char *TimOwner_get(const TIM_TypeDef *p_tim) {
+    return tim_owner[tim_idx(p_tim)];
+}
@@ -0,0 +1,40 @@
+/**
+ * @file TimOwner.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief owner of general purpose timers shared by modules. TIM1: source/Wave and
+ * source/Prof, TIM2: source/Logic and source/Latency, TIM3: source/Encoder and
+ * source/Capture. start() of those modules claims its timer and refuses while another
+ * module holds it, stop() releases it. Owner is the module name, shell prints it.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef TIM_OWNER_H
+#define TIM_OWNER_H
+
+#include <stdint.h>
+
+#include "stm32f1xx.h"
+
+/**
+ * @brief claim timer for p_owner, claiming it again by the same owner succeeds
+ * @param p_tim         : TIM1 .. TIM4
+ * @param p_owner       : module name, static, compared by address
+ * @return uint8_t      : 1 claimed, 0 held by another owner
+ */
+uint8_t TimOwner_claim(const TIM_TypeDef *p_tim, const char *p_owner);
+
+/**
+ * @brief release timer, only its owner may do it
+ */
+void TimOwner_release(const TIM_TypeDef *p_tim, const char *p_owner);
+
+/**
+ * @brief current owner of timer
+ * @return const char*  : module name, NULL when free
+ */
+const char *TimOwner_get(const TIM_TypeDef *p_tim);
+
+#endif /* TIM_OWNER_H */
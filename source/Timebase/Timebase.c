@@ -0,0 +1,116 @@
+/**
+ * @file Timebase.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief micro second time base and deadlines on TIM compare channels
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "Timebase.h"
+/* dependencies */
+#include "Crit.h"
+#include "assert_gorenje.h"
+
+#if ( USE_HAL_TIM_REGISTER_CALLBACKS != 1 )
+    #error "Timebase need USE_HAL_TIM_REGISTER_CALLBACKS enabled in stm32f1xx_hal_conf.h"
+#endif
+
+/* CCx flags and interrupt enable bits are at the same position: CC1 = bit 1 .. CC4 = bit 4 */
+#define CH_MSK(ch)      (TIM_IT_CC1 << (ch))
+
+static uint32_t now      (void);
+static void     deadline (timebase_ch_t ch, uint16_t delay_us, timebase_cb_t cb);
+static void     cancel   (timebase_ch_t ch);
+
+//=========================================================
+/* create needed object  */
+static TIM_HandleTypeDef *p_tb_htim;
+static volatile uint16_t tb_overflow;
+static timebase_cb_t tb_cb[TIMEBASE_CH_CNT];
+
+Timebase_methods_t Timebase = {
+    &now,
+    &deadline,
+    &cancel
+};
+//=========================================================
+
+static void period_elapsed_cb(TIM_HandleTypeDef *htim) {
+    (void)htim;
+    tb_overflow++;
+}
+
+static void oc_delay_elapsed_cb(TIM_HandleTypeDef *htim) {
+    /* HAL_TIM_ACTIVE_CHANNEL_x is one bit per channel */
+    timebase_ch_t ch = (timebase_ch_t)__builtin_ctz(htim->Channel);
+    timebase_cb_t cb = tb_cb[ch];
+
+    __HAL_TIM_DISABLE_IT(htim, CH_MSK(ch));
+    if (cb != NULL) {
+        cb();
+    }
+}
+
+/* constructor */
+void Timebase_init(TIM_HandleTypeDef *p_htim) {
+    assert(p_htim != NULL);
+
+    assert(NVIC_GetPriority(TIM4_IRQn) == TIMEBASE_IRQ_PRIO);
+    /* prescaler is a constant in .ioc, tick must stay 1 us with the clock tree. Timer clock
+       is 2x PCLK1 when APB1 is divided */
+    assert( (HAL_RCC_GetPCLK1Freq() * (((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) ? 2u : 1u)) ==
+            ((p_htim->Instance->PSC + 1u) * 1000000u) );
+
+    p_tb_htim = p_htim;
+    tb_overflow = 0;
+
+    HAL_TIM_RegisterCallback(p_htim, HAL_TIM_PERIOD_ELAPSED_CB_ID, &period_elapsed_cb);
+    HAL_TIM_RegisterCallback(p_htim, HAL_TIM_OC_DELAY_ELAPSED_CB_ID, &oc_delay_elapsed_cb);
+    __HAL_TIM_CLEAR_FLAG(p_htim, TIM_FLAG_UPDATE);
+    HAL_TIM_Base_Start_IT(p_htim);
+}
+
+//=========================================================
+/* methods implementation */
+
+static uint32_t now(void) {
+    uint32_t hi;
+    uint32_t lo;
+    /* only overflow interrupt changes tb_overflow, higher priorities keep running */
+    crit_state_t basepri = Crit_enter_prio(TIMEBASE_IRQ_PRIO);
+    hi = tb_overflow;
+    lo = p_tb_htim->Instance->CNT;
+    /* overflow that was not handled yet (called from interrupt or with interrupts disabled) */
+    if ( (__HAL_TIM_GET_FLAG(p_tb_htim, TIM_FLAG_UPDATE) != RESET) && (lo < 0x8000u) ) {
+        hi++;
+    }
+    Crit_exit_prio(basepri);
+
+    return (hi << 16) | lo;
+}
+
+static void deadline(timebase_ch_t ch, uint16_t delay_us, timebase_cb_t cb) {
+    TIM_TypeDef *p_tim = p_tb_htim->Instance;
+    volatile uint32_t *p_ccr = &p_tim->CCR1 + ch;   // CCR1..CCR4 are consecutive
+    crit_state_t primask;
+
+    if (delay_us < TIMEBASE_MIN_DELAY) {
+        delay_us = TIMEBASE_MIN_DELAY;
+    }
+    /* deadlines are set from different interrupt levels, DIER is shared. Modbus sets them
+       from USART1 interrupt at priority 0, which BASEPRI can not mask */
+    primask = Crit_enter();
+    tb_cb[ch] = cb;
+    *p_ccr = (uint16_t)(p_tim->CNT + delay_us);
+    p_tim->SR = ~CH_MSK(ch);        // rc_w0, clear only our flag
+    p_tim->DIER |= CH_MSK(ch);
+    Crit_exit(primask);
+}
+
+static void cancel(timebase_ch_t ch) {
+    crit_state_t primask = Crit_enter();
+    p_tb_htim->Instance->DIER &= ~CH_MSK(ch);
+    Crit_exit(primask);
+}
@@ -0,0 +1,66 @@
+/**
+ * @file Timebase.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief micro second time base on free running 16 bit timer (TIM4 @ 1 MHz), extended to
+ * 32 bit with overflow interrupt. Timer compare channels are used as one shot deadlines
+ * with callback from timer interrupt. Each channel has one owner, see timebase_ch_t.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <stdint.h>
+
+#include "stm32f1xx_hal.h"
+
+/**
+ * @brief compare channel owners
+ */
+typedef enum _timebase_ch_t{
+    TIMEBASE_CH_MODBUS = 0,     // Modbus t1.5 / t3.5
+    TIMEBASE_CH_LED,            // status LED tick
+    TIMEBASE_CH_INPUT,          // input debounce (source/Input)
+    TIMEBASE_CH_CAPTURE,        // capture flush (source/Capture)
+    TIMEBASE_CH_CNT
+}timebase_ch_t;
+
+/**
+ * @brief TIM4 interrupt priority, NVIC.TIM4_IRQn in .ioc, generated into Core/Src/tim.c
+ * (HAL_TIM_Base_MspInit) and checked by Timebase_init(). Deadline callbacks and
+ * interrupts of modules that share it are masked with Crit_enter_prio(TIMEBASE_IRQ_PRIO)
+ */
+#define TIMEBASE_IRQ_PRIO   1u
+
+/**
+ * @brief shortest deadline in us. Shorter delays are extended, so compare is not missed
+ */
+#define TIMEBASE_MIN_DELAY  5
+
+/**
+ * @brief deadline callback, called from timer interrupt
+ */
+typedef void (*timebase_cb_t)(void);
+
+/**
+ * @brief struct of all available methods of this module
+ */
+typedef struct _Timebase_methods_t{
+    uint32_t (*now)      (void);     // time from start in us (wraps after ~71 min)
+    void     (*deadline) (timebase_ch_t ch, uint16_t delay_us, timebase_cb_t cb);
+    void     (*cancel)   (timebase_ch_t ch);
+}Timebase_methods_t;
+
+extern Timebase_methods_t Timebase;
+
+/**
+ * @brief start time base on timer initialized by cubeMX (MX_TIM4_Init)
+ * @param p_htim    : pointer to HAL timer handle
+ */
+void Timebase_init(TIM_HandleTypeDef *p_htim);
+
+#endif /* TIMEBASE_H */
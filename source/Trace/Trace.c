@@ -0,0 +1,149 @@
+/**
+ * @file Trace.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief binary event tracer, dump over serial
+ *
+ * dump format (little endian):
+ *  header : 'T','R','C','1' | uint16 evt_size | uint16 evt_cnt | uint32 core_clk | uint32 lost
+ *  data   : evt_cnt * trace_evt_t, oldest first
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "Trace.h"
+/* dependencies */
+#include "assert_gorenje.h"
+#include "Startup.h"
+
+#if ( (TRACE_BUFF_SIZE & (TRACE_BUFF_SIZE - 1)) != 0 )
+    #error "TRACE_BUFF_SIZE must be power of 2"
+#endif
+
+typedef struct _trace_dump_hdr_t{
+    uint8_t     magic[4];
+    uint16_t    evt_size;
+    uint16_t    evt_cnt;
+    uint32_t    core_clk;
+    uint32_t    lost;       // events overwritten before dump
+}trace_dump_hdr_t;
+
+/* dump state */
+typedef struct _trace_dump_t{
+    serial_ctrl_desc_t  *p_serial;
+    uint32_t            idx;        // next event to send
+    uint32_t            end;        // one after last event to send
+    uint8_t             hdr_F;      // header is still to be sent
+    uint8_t             resume_F;   // recording was active before dump
+}trace_dump_t;
+
+static void enable      (void);
+static void disable     (void);
+static void dump_start  (serial_ctrl_desc_t *p_serial);
+static uint8_t dump_exe (void);
+
+//=========================================================
+/* create needed object  */
+trace_ctrl_t trace_ctrl;
+/* only events below trace_ctrl.head are ever read, no zeroing at reset */
+NOINIT trace_evt_t  trace_buff[TRACE_BUFF_SIZE];
+
+static trace_dump_t trace_dump;
+static trace_dump_hdr_t trace_hdr;
+
+Trace_methods_t Trace = {
+    &enable,
+    &disable,
+    &dump_start,
+    &dump_exe
+};
+//=========================================================
+
+/* constructor */
+void Trace_init(void) {
+    CycleCnt_init();
+
+    trace_ctrl.head = 0;
+    trace_dump.p_serial = NULL;
+    enable();
+    TRACE_EVT(TRACE_ID_TRACE_START, 0, SystemCoreClock);
+}
+
+//=========================================================
+/* methods implementation */
+
+static void enable(void) {
+    trace_ctrl.enable_F = 1;
+}
+
+static void disable(void) {
+    trace_ctrl.enable_F = 0;
+}
+
+static void dump_start(serial_ctrl_desc_t *p_serial) {
+    uint32_t head;
+    uint32_t cnt;
+
+    assert(p_serial != NULL);
+
+    if (trace_dump.p_serial != NULL) {
+        /* dump already in progress */
+        return;
+    }
+
+    trace_dump.resume_F = trace_ctrl.enable_F;
+    disable();
+    /* ISR that claimed a slot before disable finish writing it before we continue here */
+    head = trace_ctrl.head;
+    cnt = (head > TRACE_BUFF_SIZE) ? TRACE_BUFF_SIZE : head;
+
+    trace_hdr.magic[0] = 'T';
+    trace_hdr.magic[1] = 'R';
+    trace_hdr.magic[2] = 'C';
+    trace_hdr.magic[3] = '1';
+    trace_hdr.evt_size = sizeof(trace_evt_t);
+    trace_hdr.evt_cnt  = (uint16_t)cnt;
+    trace_hdr.core_clk = SystemCoreClock;
+    trace_hdr.lost     = head - cnt;
+
+    trace_dump.idx   = head - cnt;
+    trace_dump.end   = head;
+    trace_dump.hdr_F = 1;
+    trace_dump.p_serial = p_serial;
+}
+
+static uint8_t dump_exe(void) {
+    serial_ctrl_desc_t *p_serial = trace_dump.p_serial;
+
+    if (p_serial == NULL) {
+        return 0;
+    }
+
+    if (trace_dump.hdr_F != 0) {
+        if (Serial.Tx_free(p_serial) < sizeof(trace_hdr)) {
+            return 1;
+        }
+        Serial.write(p_serial, (uint8_t *)&trace_hdr, sizeof(trace_hdr));
+        trace_dump.hdr_F = 0;
+    }
+
+    /* fill Tx buffer with as many whole events as it fits */
+    while ( (trace_dump.idx != trace_dump.end) && (Serial.Tx_free(p_serial) >= sizeof(trace_evt_t)) ) {
+        Serial.write(p_serial, (uint8_t *)&trace_buff[trace_dump.idx & (TRACE_BUFF_SIZE - 1)], sizeof(trace_evt_t));
+        trace_dump.idx++;
+    }
+
+    if (trace_dump.idx != trace_dump.end) {
+        return 1;
+    }
+
+    /* done. Start new recording */
+    trace_dump.p_serial = NULL;
+    trace_ctrl.head = 0;
+    if (trace_dump.resume_F != 0) {
+        enable();
+    }
+    return 0;
+}
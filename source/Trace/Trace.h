@@ -0,0 +1,129 @@
+/**
+ * @file Trace.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief binary event tracer. Fixed size events (id, cycle time stamp, 2 arguments) are
+ * recorded into RAM ring buffer from interrupts and tasks and dumped over serial on request.
+ * Recording is lock free (LDREX/STREX slot claim), so it can be used from any ISR level.
+ * Dump is decoded on PC with tools/trace/trace_decode.py
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+#include "stm32f1xx.h"
+#include "CycleCnt.h"
+#include "Serial.h"
+
+//=======================================================================================
+/**
+ * @brief set to 0 to remove all trace points from the build
+ */
+#define TRACE_ENABLE        1
+
+/**
+ * @brief number of events in ring buffer. Must be power of 2. Each event take 12 bytes of RAM
+ */
+#define TRACE_BUFF_SIZE     256
+//=======================================================================================
+
+/**
+ * @brief kind of event is coded in upper 2 bits of event id. Host decoder use it to
+ * build begin/end (duration) pairs.
+ */
+#define TRACE_KIND_INSTANT  0x0000u
+#define TRACE_KIND_BEGIN    0x4000u
+#define TRACE_KIND_END      0x8000u
+#define TRACE_KIND_MSK      0xC000u
+
+/**
+ * @brief event ids. Host decoder read names from this enum, so keep one id per line
+ * in form "TRACE_ID_<name>,"
+ */
+typedef enum _trace_id_t{
+    TRACE_ID_TRACE_START = 0,
+    TRACE_ID_ISR_UART_TX,
+    TRACE_ID_ISR_UART_RX,
+    TRACE_ID_USER,
+}trace_id_t;
+
+/**
+ * @brief one trace record as it is stored in RAM and sent over serial (little endian)
+ */
+typedef struct _trace_evt_t{
+    uint32_t    tm;     // DWT cycle counter
+    uint16_t    id;     // event id | event kind
+    uint16_t    arg0;   // user argument
+    uint32_t    arg1;   // user argument
+}trace_evt_t;
+
+/**
+ * @brief trace control block
+ */
+typedef struct _trace_ctrl_t{
+    volatile uint32_t   head;       // index of next slot (free running, never wrapped)
+    volatile uint8_t    enable_F;   // recording is active
+}trace_ctrl_t;
+
+extern trace_ctrl_t trace_ctrl;
+extern trace_evt_t  trace_buff[TRACE_BUFF_SIZE];
+
+/**
+ * @brief struct of all available methods of this module
+ */
+typedef struct _Trace_methods_t{
+    void     (*enable)      (void);
+    void     (*disable)     (void);
+    void     (*dump_start)  (serial_ctrl_desc_t *p_serial); // freeze recording and start dump
+    uint8_t  (*dump_exe)    (void); // call from main loop, returns 1 while dump is in progress
+}Trace_methods_t;
+
+extern Trace_methods_t Trace;
+
+/**
+ * @brief initialize tracer and start recording
+ */
+void Trace_init(void);
+
+/**
+ * @brief record one event. Takes a few cycles, safe from tasks and interrupts
+ * @param id    : event id (trace_id_t) with event kind
+ * @param arg0  : user argument
+ * @param arg1  : user argument
+ */
+static inline void Trace_record(uint16_t id, uint16_t arg0, uint32_t arg1) {
+    uint32_t idx;
+    trace_evt_t *p_evt;
+
+    if (trace_ctrl.enable_F == 0) {
+        return;
+    }
+    /* claim a slot. Interrupt that preempts us between LDREX and STREX makes STREX fail */
+    do {
+        idx = __LDREXW(&trace_ctrl.head);
+    } while (__STREXW(idx + 1, &trace_ctrl.head) != 0);
+
+    p_evt = &trace_buff[idx & (TRACE_BUFF_SIZE - 1)];
+    p_evt->tm   = CycleCnt_get();
+    p_evt->id   = id;
+    p_evt->arg0 = arg0;
+    p_evt->arg1 = arg1;
+}
+
+#if ( TRACE_ENABLE == 1 )
+    #define TRACE_EVT(id, arg0, arg1)   Trace_record((uint16_t)((id) | TRACE_KIND_INSTANT), (arg0), (arg1))
+    #define TRACE_BEGIN(id)             Trace_record((uint16_t)((id) | TRACE_KIND_BEGIN), 0, 0)
+    #define TRACE_END(id)               Trace_record((uint16_t)((id) | TRACE_KIND_END), 0, 0)
+#else
+    #define TRACE_EVT(id, arg0, arg1)
+    #define TRACE_BEGIN(id)
+    #define TRACE_END(id)
+#endif
+
+#endif /* TRACE_H */
@@ -0,0 +1,257 @@
+/**
+ * @file Wave.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief DMA driven PWM waveform engine, double buffered
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include "Wave.h"
+/* dependencies */
+#include "main.h"
+#include "CycleCnt.h"
+#include "Crit.h"
+#include "TimOwner.h"
+#include "assert_gorenje.h"
+
+typedef enum _wave_gen_t{
+    WAVE_GEN_HOLD = 0,
+    WAVE_GEN_TABLE,
+    WAVE_GEN_RAMP,
+    WAVE_GEN_USER
+}wave_gen_t;
+
+typedef struct _wave_ctrl_t{
+    wave_gen_t      gen;
+    const uint16_t  *p_table;
+    uint16_t        len;
+    uint16_t        idx;
+    uint32_t        acc;        // ramp level, 16.16
+    int32_t         step;
+    uint32_t        left;       // ramp samples
+    uint16_t        to;         // ramp end, exact after last step
+    wave_fill_cb_t  cb;
+    uint16_t        level;      // last generated sample
+    uint8_t         run_F;
+    uint32_t        start_cycles;
+}wave_ctrl_t;
+
+static uint8_t              start   (uint16_t period, uint8_t repeat);
+static void                 stop    (void);
+static void                 table   (const uint16_t *p_table, uint16_t len);
+static void                 ramp    (uint16_t to, uint32_t samples);
+static void                 user    (wave_fill_cb_t cb);
+static const wave_stats_t   *stats  (void);
+
+//=========================================================
+/* create needed object  */
+static uint16_t wave_buf[2u * WAVE_SEG];
+static wave_ctrl_t wave;
+static wave_stats_t wave_stats;
+static const char wave_owner[] = "wave";
+
+const Wave_methods_t Wave = {
+    &start,
+    &stop,
+    &table,
+    &ramp,
+    &user,
+    &stats
+};
+//=========================================================
+
+/* constructor */
+void Wave_init(void) {
+    CycleCnt_init();
+    stop();
+    wave.gen = WAVE_GEN_HOLD;
+    wave.level = 0;
+}
+
+static void fill(uint16_t *p_seg) {
+    uint16_t i;
+
+    switch (wave.gen) {
+    case WAVE_GEN_TABLE:
+        for (i = 0; i < WAVE_SEG; ++i) {
+            p_seg[i] = wave.p_table[wave.idx];
+            if (++wave.idx >= wave.len) {
+                wave.idx = 0;
+            }
+        }
+        break;
+    case WAVE_GEN_RAMP:
+        for (i = 0; i < WAVE_SEG; ++i) {
+            if (wave.left > 1u) {
+                wave.acc += (uint32_t)wave.step;
+                wave.left--;
+            } else if (wave.left != 0) {
+                wave.acc = (uint32_t)wave.to << 16;
+                wave.left = 0;
+            }
+            p_seg[i] = (uint16_t)(wave.acc >> 16);
+        }
+        break;
+    case WAVE_GEN_USER:
+        wave.cb(p_seg, WAVE_SEG);
+        break;
+    default:
+        for (i = 0; i < WAVE_SEG; ++i) {
+            p_seg[i] = wave.level;
+        }
+        break;
+    }
+    wave.level = p_seg[WAVE_SEG - 1u];
+}
+
+void DMA1_Channel5_IRQHandler(void) {
+    uint32_t start_cycles = CycleCnt_get();
+    uint32_t isr = DMA1->ISR & (DMA_ISR_HTIF5 | DMA_ISR_TCIF5);
+    uint16_t *p_seg;
+    uint8_t first_F;
+
+    DMA1->IFCR = DMA_IFCR_CGIF5;
+    /* both segments finished, one of them was played again */
+    if (isr == (DMA_ISR_HTIF5 | DMA_ISR_TCIF5)) {
+        wave_stats.underruns++;
+    }
+    /* refill the segment DMA is not reading */
+    first_F = (uint8_t)(WAVE_DMA->CNDTR <= WAVE_SEG);
+    p_seg = (first_F != 0) ? &wave_buf[0] : &wave_buf[WAVE_SEG];
+    fill(p_seg);
+    if ((uint8_t)(WAVE_DMA->CNDTR <= WAVE_SEG) != first_F) {
+        /* DMA reached the segment while it was written */
+        wave_stats.underruns++;
+    }
+    wave_stats.segments++;
+    wave_stats.busy += (CycleCnt_get() - start_cycles) + WAVE_ISR_OVERHEAD;
+}
+
+//=========================================================
+/* methods implementation */
+
+static uint8_t start(uint16_t period, uint8_t repeat) {
+    GPIO_InitTypeDef gpio_init = {0};
+    uint16_t first = wave.level;
+    uint32_t tim_clk;
+
+    assert(period > 1u);
+
+    stop();
+    if (TimOwner_claim(WAVE_TIM, wave_owner) == 0) {
+        return 0;
+    }
+
+    /* timer clock is 2x PCLK2 when APB2 is divided */
+    tim_clk = HAL_RCC_GetPCLK2Freq();
+    if ((RCC->CFGR & RCC_CFGR_PPRE2) != RCC_CFGR_PPRE2_DIV1) {
+        tim_clk *= 2u;
+    }
+    wave_stats = (wave_stats_t){ 0 };
+    wave_stats.rate = tim_clk / ((uint32_t)period * (repeat + 1u));
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_TIM1_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    gpio_init.Pin = GPIO_PIN_8;
+    gpio_init.Mode = GPIO_MODE_AF_PP;
+    gpio_init.Speed = GPIO_SPEED_FREQ_HIGH;
+    HAL_GPIO_Init(GPIOA, &gpio_init);
+
+    /* both segments ready before first update */
+    fill(&wave_buf[0]);
+    fill(&wave_buf[WAVE_SEG]);
+
+    WAVE_TIM->CR1 = TIM_CR1_ARPE;
+    WAVE_TIM->PSC = 0;
+    WAVE_TIM->ARR = (uint32_t)period - 1u;
+    WAVE_TIM->RCR = repeat;
+    WAVE_TIM->CCR1 = first;
+    WAVE_TIM->CCMR1 = TIM_CCMR1_OC1M_2 | TIM_CCMR1_OC1M_1 | TIM_CCMR1_OC1PE;  // PWM mode 1
+    WAVE_TIM->CCER = TIM_CCER_CC1E;
+    WAVE_TIM->BDTR = TIM_BDTR_MOE;
+    WAVE_TIM->EGR = TIM_EGR_UG;
+    WAVE_TIM->SR = 0;
+
+    /* first update loads previous level, CCR1 is preloaded one sample ahead */
+    WAVE_DMA->CCR = 0;
+    DMA1->IFCR = DMA_IFCR_CGIF5;
+    WAVE_DMA->CPAR = (uint32_t)&WAVE_TIM->CCR1;
+    WAVE_DMA->CMAR = (uint32_t)wave_buf;
+    WAVE_DMA->CNDTR = 2u * WAVE_SEG;
+    WAVE_DMA->CCR = DMA_CCR_PSIZE_0 | DMA_CCR_MSIZE_0 | DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_DIR |
+                    DMA_CCR_HTIE | DMA_CCR_TCIE | DMA_CCR_EN;
+
+    NVIC_SetPriority(WAVE_IRQn, WAVE_IRQ_PRIO);
+    NVIC_ClearPendingIRQ(WAVE_IRQn);
+    NVIC_EnableIRQ(WAVE_IRQn);
+
+    wave.start_cycles = CycleCnt_get();
+    wave.run_F = 1;
+    WAVE_TIM->DIER = TIM_DIER_UDE;
+    WAVE_TIM->CR1 |= TIM_CR1_CEN;
+    return 1;
+}
+
+static void stop(void) {
+    /* TIM1 may be running for source/Prof */
+    if (wave.run_F == 0) {
+        return;
+    }
+    NVIC_DisableIRQ(WAVE_IRQn);
+    WAVE_TIM->CR1 = 0;
+    WAVE_TIM->DIER = 0;
+    WAVE_TIM->BDTR = 0;
+    WAVE_TIM->CCER = 0;
+    WAVE_DMA->CCR = 0;
+    wave_stats.elapsed = CycleCnt_get() - wave.start_cycles;
+    wave.run_F = 0;
+    TimOwner_release(WAVE_TIM, wave_owner);
+}
+
+static void table(const uint16_t *p_table, uint16_t len) {
+    crit_state_t primask;
+
+    assert( (p_table != NULL) && (len != 0) );
+
+    primask = Crit_enter();
+    wave.p_table = p_table;
+    wave.len = len;
+    wave.idx = 0;
+    wave.gen = WAVE_GEN_TABLE;
+    Crit_exit(primask);
+}
+
+static void ramp(uint16_t to, uint32_t samples) {
+    crit_state_t primask;
+
+    assert(samples != 0);
+
+    primask = Crit_enter();
+    wave.acc = (uint32_t)wave.level << 16;
+    wave.step = (int32_t)((((int64_t)to - (int64_t)wave.level) * 65536) / (int64_t)samples);
+    wave.to = to;
+    wave.left = samples;
+    wave.gen = WAVE_GEN_RAMP;
+    Crit_exit(primask);
+}
+
+static void user(wave_fill_cb_t cb) {
+    crit_state_t primask;
+
+    assert(cb != NULL);
+
+    primask = Crit_enter();
+    wave.cb = cb;
+    wave.gen = WAVE_GEN_USER;
+    Crit_exit(primask);
+}
+
+static const wave_stats_t *stats(void) {
+    if (wave.run_F != 0) {
+        wave_stats.elapsed = CycleCnt_get() - wave.start_cycles;
+    }
+    return &wave_stats;
+}
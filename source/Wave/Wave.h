@@ -0,0 +1,71 @@
+/**
+ * @file Wave.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief PWM waveform engine on TIM1_CH1 (PA8). On every timer update DMA1 channel 5
+ * (TIM1_UP) writes next sample from RAM into CCR1 (preloaded, takes effect on following
+ * update), so update rate is not limited by interrupts. Samples are duty in timer ticks
+ * (0 .. period), each is held repeat + 1 PWM periods (TIM1 repetition counter).
+ *
+ * Buffer is 2 segments of WAVE_SEG samples played in circular DMA. Half and full transfer
+ * interrupt refills the segment that just finished from the active generator (table loop,
+ * linear ramp, user callback) while the other one plays. Generator change takes effect
+ * at next segment. Segment that is not ready in time is counted as underrun.
+ *
+ * TIM1 is shared with source/Prof (source/TimOwner), start() refuses while profiler runs.
+ * Shell command "wave".
+ * Benchmark: source/Wave/test.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef WAVE_H
+#define WAVE_H
+
+#include <stdint.h>
+
+#define WAVE_TIM            TIM1
+#define WAVE_DMA            DMA1_Channel5       // TIM1_UP
+#define WAVE_IRQn           DMA1_Channel5_IRQn
+#define WAVE_IRQ_PRIO       2u                  // below Timebase, generators may take a while
+
+#define WAVE_SEG            64u                 // samples per segment
+
+/* exception entry and exit, not seen by cycle counter in handler */
+#define WAVE_ISR_OVERHEAD   24u
+
+/**
+ * @brief generator, fill cnt samples, called from DMA interrupt
+ */
+typedef void (*wave_fill_cb_t)(uint16_t *p_seg, uint16_t cnt);
+
+typedef struct _wave_stats_t{
+    uint32_t    rate;       // samples per second
+    uint32_t    segments;   // refilled
+    uint32_t    underruns;
+    uint32_t    busy;       // cycles in DMA interrupt, generator included
+    uint32_t    elapsed;    // cycles since start
+}wave_stats_t;
+
+/**
+ * @brief struct of all available methods of this module
+ */
+typedef struct _Wave_methods_t{
+    /* period in timer ticks (core clock), returns 0 when TIM1 is held by source/Prof */
+    uint8_t             (*start)    (uint16_t period, uint8_t repeat);
+    void                (*stop)     (void);
+    void                (*table)    (const uint16_t *p_table, uint16_t len);   // loop table, kept by caller
+    void                (*ramp)     (uint16_t to, uint32_t samples);   // from current level, then hold
+    void                (*user)     (wave_fill_cb_t cb);
+    const wave_stats_t  *(*stats)   (void);
+}Wave_methods_t;
+
+extern const Wave_methods_t Wave;
+
+/**
+ * @brief engine stopped, level 0
+ */
+void Wave_init(void);
+
+#endif /* WAVE_H */
@@ -0,0 +1,89 @@
+#include "Wave_test.h"
+#include "Wave.h"
+#include "Serial.h"
+#include "Shell.h"
+#include "stm32f1xx_hal.h"
+
+/* PWM period in timer ticks, one sample per period */
+static const uint16_t test_period[] = { 1000, 400, 200, 100, 64, 48, 32, 24, 16 };
+
+static uint16_t tri_level;
+static uint16_t tri_top;
+static int8_t tri_dir;
+
+static void tri_fill(uint16_t *p_seg, uint16_t cnt) {
+    uint16_t i;
+
+    for (i = 0; i < cnt; ++i) {
+        if (tri_level >= tri_top) {
+            tri_dir = -1;
+        } else if (tri_level == 0) {
+            tri_dir = 1;
+        }
+        tri_level = (uint16_t)(tri_level + tri_dir);
+        p_seg[i] = tri_level;
+    }
+}
+
+void wave_test_run(void) {
+    const wave_stats_t *p_stats;
+    uint32_t best = 0;
+    uint32_t samples;
+    uint32_t start;
+    uint32_t mid;
+    uint32_t fails = 0;
+    uint8_t stall_F;
+    uint8_t i;
+
+    Shell_print(&serial_0, "\r\nwave benchmark, core clock ");
+    Shell_print_u32(&serial_0, SystemCoreClock / 1000000u);
+    Shell_print(&serial_0, " MHz, segment ");
+    Shell_print_u32(&serial_0, WAVE_SEG);
+    Shell_print(&serial_0, " samples\r\n");
+    Shell_print(&serial_0, "period ticks, samples/s, underruns, load permille, cycles per sample x10\r\n");
+
+    for (i = 0; i < (sizeof(test_period) / sizeof(test_period[0])); ++i) {
+        tri_level = 0;
+        tri_top = test_period[i];
+        Wave.user(&tri_fill);
+        if (Wave.start(test_period[i], 0) == 0) {
+            Shell_print(&serial_0, "TIM1 busy\r\n");
+            return;
+        }
+        start = HAL_GetTick();
+        while ((HAL_GetTick() - start) < (WAVE_TEST_MS / 2u)) {
+        }
+        /* refills must go on for the whole run, DMA plays the buffer in circles */
+        mid = Wave.stats()->segments;
+        while ((HAL_GetTick() - start) < WAVE_TEST_MS) {
+        }
+        stall_F = (uint8_t)(Wave.stats()->segments == mid);
+        Wave.stop();
+
+        p_stats = Wave.stats();
+        samples = p_stats->segments * WAVE_SEG;
+        Shell_print_u32(&serial_0, test_period[i]);
+        Shell_print(&serial_0, " ");
+        Shell_print_u32(&serial_0, p_stats->rate);
+        Shell_print(&serial_0, " ");
+        Shell_print_u32(&serial_0, p_stats->underruns);
+        Shell_print(&serial_0, " ");
+        Shell_print_u32(&serial_0, (p_stats->elapsed != 0) ?
+                        (uint32_t)(((uint64_t)p_stats->busy * 1000u) / p_stats->elapsed) : 0);
+        Shell_print(&serial_0, " ");
+        Shell_print_u32(&serial_0, (samples != 0) ? ((p_stats->busy * 10u) / samples) : 0);
+        if (stall_F != 0) {
+            Shell_print(&serial_0, " FAIL: refill stopped\r\n");
+            fails++;
+            continue;
+        }
+        Shell_print(&serial_0, "\r\n");
+        if ( (p_stats->underruns == 0) && (p_stats->rate > best) ) {
+            best = p_stats->rate;
+        }
+    }
+    Shell_print(&serial_0, "sustained update rate: ");
+    Shell_print_u32(&serial_0, best);
+    Shell_print(&serial_0, " samples/s\r\n");
+    Shell_print(&serial_0, (fails == 0) ? "wave test ok\r\n" : "wave test FAIL\r\n");
+}
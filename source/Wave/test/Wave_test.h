@@ -0,0 +1,26 @@
+/**
+ * @file Wave_test.h
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief sustained update rate and CPU overhead of source/Wave. Triangle generator (user
+ * callback) plays for WAVE_TEST_MS at shrinking PWM period, one sample per period.
+ * Reports samples per second, underruns, CPU load of refill interrupt and cycles per
+ * sample. Highest rate without underruns is the sustained rate. A run in which refill
+ * interrupts stop before its end fails.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#ifndef WAVE_TEST_H
+#define WAVE_TEST_H
+
+#define WAVE_TEST_MS        200u
+
+/**
+ * @brief run benchmark once and print result over serial_0. Serial must be initialized,
+ * profiler stopped (TIM1).
+ */
+void wave_test_run(void);
+
+#endif /* WAVE_TEST_H */
@@ -61,33 +61,50 @@ defined in linker script */
   .type Reset_Handler, %function
 Reset_Handler:
 
-/* Copy the data segment initializers from flash to SRAM */
+/* Start DWT cycle counter, boot profile (source/Startup) counts from here */
+  ldr r0, =0xE000EDFC         /* CoreDebug->DEMCR */
+  ldr r1, [r0]
+  orr r1, r1, #0x01000000     /* TRCENA */
+  str r1, [r0]
+  ldr r0, =0xE0001000         /* DWT->CTRL */
   movs r1, #0
-  b LoopCopyDataInit
+  str r1, [r0, #4]            /* DWT->CYCCNT */
+  ldr r1, [r0]
+  orr r1, r1, #1              /* CYCCNTENA */
+  str r1, [r0]
 
-CopyDataInit:
-  ldr r3, =_sidata
-  ldr r3, [r3, r1]
-  str r3, [r0, r1]
-  adds r1, r1, #4
+/* Copy the code executed from SRAM (.ramfunc) from flash to SRAM */
+  ldr r0, =_sramfunc
+  ldr r1, =_eramfunc
+  ldr r2, =_siramfunc
+  bl CopyWords
 
-LoopCopyDataInit:
+/* Copy the data segment initializers from flash to SRAM */
   ldr r0, =_sdata
-  ldr r3, =_edata
-  adds r2, r0, r1
-  cmp r2, r3
-  bcc CopyDataInit
-  ldr r2, =_sbss
-  b LoopFillZerobss
-/* Zero fill the bss segment. */
-FillZerobss:
-  movs r3, #0
-  str r3, [r2], #4
-
-LoopFillZerobss:
-  ldr r3, = _ebss
-  cmp r2, r3
-  bcc FillZerobss
+  ldr r1, =_edata
+  ldr r2, =_sidata
+  bl CopyWords
+
+/* Zero fill the bss segment. Buffers that are initialized by their module
+   are placed in .noinit instead and are not touched here */
+  ldr r0, =_sbss
+  ldr r1, =_ebss
+  movs r2, #0
+  bl FillWords
+
+/* Paint free RAM up to top of stack with STACK_PAINT (source/Stack/Stack.h),
+   peak stack depth is measured from it. Bootloader sets _stack_paint_start to
+   _estack and paints nothing, RAM above its own data belongs to the application */
+  ldr r0, =_stack_paint_start
+  ldr r1, =_estack
+  ldr r2, =0xDEADBEEF
+  bl FillWords
+
+/* Memory init done, keep cycle count for boot profile */
+  ldr r0, =0xE0001004         /* DWT->CYCCNT */
+  ldr r1, [r0]
+  ldr r0, =startup_mem_cycles
+  str r1, [r0]
 
 /* Call the clock system intitialization function.*/
     bl  SystemInit
@@ -96,8 +113,55 @@ LoopFillZerobss:
 /* Call the application's entry point.*/
   bl main
   bx lr
+
+/* Copy words from r2 to r0 up to r1, four at a time with LDM/STM, then the rest.
+   Linker script keeps all section bounds word aligned. Uses r0-r6 */
+CopyWords:
+  adds r3, r0, #16
+  cmp r3, r1
+  bhi LoopCopyWords
+  ldmia r2!, {r3-r6}
+  stmia r0!, {r3-r6}
+  b CopyWords
+
+CopyWordsTail:
+  ldr r3, [r2], #4
+  str r3, [r0], #4
+
+LoopCopyWords:
+  cmp r0, r1
+  bcc CopyWordsTail
+  bx lr
+
+/* Fill words from r0 up to r1 with r2, four at a time with STM. Uses r0-r6 */
+FillWords:
+  mov r3, r2
+  mov r4, r2
+  mov r5, r2
+
+LoopFillWords4:
+  adds r6, r0, #16
+  cmp r6, r1
+  bhi LoopFillWords
+  stmia r0!, {r2-r5}
+  b LoopFillWords4
+
+FillWordsTail:
+  str r2, [r0], #4
+
+LoopFillWords:
+  cmp r0, r1
+  bcc FillWordsTail
+  bx lr
 .size Reset_Handler, .-Reset_Handler
 
+/* Reset_Handler cycle count after memory init, read by source/Startup */
+  .section .bss.startup_mem_cycles,"aw",%nobits
+  .align 2
+  .global startup_mem_cycles
+startup_mem_cycles:
+  .space 4
+
 /**
  * @brief  This is the code that gets called when the processor receives an
  *         unexpected interrupt.  This simply enters an infinite loop, preserving
@@ -0,0 +1,164 @@
+/**
+ * @file adc_bench.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief host build of source/Adc processing stage fed with synthetic samples. Scans of
+ * 12 bit samples (sine with noise, ramp, square, constant, full scale spikes) are handed
+ * over in blocks of BLOCK_SCANS like the DMA interrupt does, every record is checked
+ * against a plain per scan reference, for decimations that do and do not line up with
+ * blocks. Throughput is reported per sample; host figures only compare variants of the
+ * stage, on target cost is measured by source/Adc/test.
+ *
+ * build and run from repository root:
+ *  gcc -O2 -Itools/adc/host -Isource/Adc tools/adc/adc_bench.c source/Adc/Adc_proc.c -lm -o adc_bench
+ *  ./adc_bench
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "Adc_proc.h"
+
+#define NCH             5u          // like ADC_CHANNELS
+#define BLOCK_SCANS     32u         // like ADC_SCANS
+#define SCANS           (BLOCK_SCANS * 2048u)
+#define ROUNDS          50u
+
+static uint16_t samples[SCANS * NCH];
+static const uint16_t *p_expect;    // first scan of record being checked
+static uint32_t checked;
+static uint32_t errors;
+static uint16_t expect_seq;
+static uint16_t decim;
+
+static uint32_t rnd_state = 1;
+
+static uint32_t rnd(void) {
+    rnd_state = (rnd_state * 1103515245u) + 12345u;
+    return rnd_state >> 16;
+}
+
+static uint16_t clamp12(double v) {
+    if (v < 0.0) {
+        return 0;
+    }
+    if (v > 4095.0) {
+        return 4095;
+    }
+    return (uint16_t)lround(v);
+}
+
+static void synth(void) {
+    const double pi = 3.14159265358979;
+    uint32_t k;
+    uint16_t *p_s = samples;
+
+    for (k = 0; k < SCANS; ++k) {
+        *p_s++ = clamp12(2048.0 + (1500.0 * sin(2.0 * pi * k / 977.0)) + (double)(rnd() % 64u) - 32.0);
+        *p_s++ = (uint16_t)(k & 0x0FFFu);
+        *p_s++ = ((k / 50u) & 1u) ? 3900u : 150u;
+        *p_s++ = 1737u;                                     // temperature sensor, constant
+        *p_s++ = ((rnd() % 1000u) == 0u) ? (((rnd() & 1u) != 0u) ? 4095u : 0u) : 1490u;
+    }
+}
+
+static void check(const adc_rec_t *p_rec) {
+    uint32_t sum;
+    uint16_t min;
+    uint16_t max;
+    uint16_t v;
+    uint16_t k;
+    uint8_t ch;
+
+    if ( (p_rec->seq != expect_seq) || (p_rec->scans != decim) ) {
+        errors++;
+    }
+    for (ch = 0; ch < NCH; ++ch) {
+        sum = 0;
+        min = 0xFFFFu;
+        max = 0;
+        for (k = 0; k < decim; ++k) {
+            v = p_expect[(k * NCH) + ch];
+            sum += v;
+            min = (v < min) ? v : min;
+            max = (v > max) ? v : max;
+        }
+        if ( (p_rec->ch[ch].mean != (uint16_t)((sum + (decim / 2u)) / decim)) ||
+             (p_rec->ch[ch].min != min) || (p_rec->ch[ch].max != max) ) {
+            errors++;
+        }
+    }
+    p_expect += (uint32_t)decim * NCH;
+    expect_seq++;
+    checked++;
+}
+
+static void count(const adc_rec_t *p_rec) {
+    (void)p_rec;
+    checked++;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+static void verify(uint16_t d) {
+    adc_proc_t proc;
+    uint32_t k;
+
+    decim = d;
+    p_expect = samples;
+    expect_seq = 0;
+    checked = 0;
+    Adc_proc_init(&proc, NCH, decim);
+    for (k = 0; k < SCANS; k += BLOCK_SCANS) {
+        Adc_proc_block(&proc, &samples[k * NCH], BLOCK_SCANS, &check);
+    }
+    printf("decim %5u: %6u records checked, partial %u scans\n", decim, checked, proc.cnt);
+}
+
+static void bench(uint16_t d) {
+    adc_proc_t proc;
+    uint64_t start;
+    uint64_t ns;
+    uint32_t round;
+    uint32_t k;
+
+    checked = 0;
+    Adc_proc_init(&proc, NCH, d);
+    start = now_ns();
+    for (round = 0; round < ROUNDS; ++round) {
+        for (k = 0; k < SCANS; k += BLOCK_SCANS) {
+            Adc_proc_block(&proc, &samples[k * NCH], BLOCK_SCANS, &count);
+        }
+    }
+    ns = now_ns() - start;
+    printf("decim %5u: %5.2f ns per sample, %7.1f Msamples/s, %u records\n", d,
+           (double)ns / ((double)SCANS * NCH * ROUNDS), ((double)SCANS * NCH * ROUNDS * 1000.0) / (double)ns,
+           checked);
+}
+
+int main(void) {
+    static const uint16_t test_decim[] = { 1, 7, 32, 100, 1000, 65535 };
+    uint8_t i;
+
+    synth();
+    printf("%u channels, %u scans in blocks of %u\n", NCH, SCANS, BLOCK_SCANS);
+    for (i = 0; i < (sizeof(test_decim) / sizeof(test_decim[0])); ++i) {
+        verify(test_decim[i]);
+    }
+    for (i = 0; i < (sizeof(test_decim) / sizeof(test_decim[0])); ++i) {
+        bench(test_decim[i]);
+    }
+    printf("%s: %u mismatches\n", (errors == 0) ? "ok" : "FAIL", errors);
+    return (errors == 0) ? 0 : 1;
+}
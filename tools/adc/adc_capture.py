@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+"""
+Capture ADC record stream (source/Adc) and write CSV.
+
+Acquisition is started with "adc start <smp> <decim>\\r" on serial_0 and stopped with
+"adc stop\\r" after --seconds. Stream is a sequence of frames 'A', type, len, seq, payload:
+'H' header, 'R' record (mean, min, max of every channel over decim scans), 'E' end with
+statistics. Shell echo between frames is skipped. Raw stream can be saved and decoded
+again later with --file.
+
+Columns are ADC counts; when VREF (channel 17) is scanned, every channel is also given in
+mV against VDDA derived from it, and TEMP (channel 16) in degC (typical datasheet slope).
+
+usage:
+    adc_capture.py --port COM5 --smp 7 --decim 100 --seconds 10 -o adc.csv
+    adc_capture.py --file raw.bin -o adc.csv
+"""
+import argparse
+import struct
+import sys
+import time
+
+HDR_FMT = "<IHHB"
+END_FMT = "<2Q5I4x"
+END_NAMES = ("busy", "elapsed", "rate", "blocks", "records", "drops", "overruns")
+CH_TEMP = 16
+CH_VREF = 17
+VREFINT_MV = 1200.0
+TEMP_V25_MV = 1430.0
+TEMP_SLOPE_MV = 4.3
+
+
+class Recorder:
+    """ stream wrapper that keeps a copy of everything read """
+
+    def __init__(self, stream):
+        self.stream = stream
+        self.data = bytearray()
+
+    def read(self, n):
+        chunk = self.stream.read(n)
+        self.data += chunk
+        return chunk
+
+
+class TimedPort(Recorder):
+    """ serial port that stops acquisition at stop_at, reads wait for data until then """
+
+    def __init__(self, port, stop_at):
+        Recorder.__init__(self, port)
+        self.stop_at = stop_at
+        self.stopped = False
+
+    def read(self, n):
+        while True:
+            if not self.stopped and time.monotonic() > self.stop_at:
+                self.stream.write(b"adc stop\r")
+                self.stopped = True
+            chunk = Recorder.read(self, n)
+            if chunk or self.stopped:
+                return chunk
+
+
+def read_exact(stream, n):
+    data = b""
+    while len(data) < n:
+        chunk = stream.read(n - len(data))
+        if not chunk:
+            raise EOFError("stream ended inside a frame")
+        data += chunk
+    return data
+
+
+def read_frames(stream):
+    """ yield (type, payload) until end frame, skipping bytes between frames """
+    while True:
+        b = stream.read(1)
+        if not b:
+            raise EOFError("stream ended before end frame")
+        if b != b"A":
+            continue
+        kind = stream.read(1)
+        if kind not in (b"H", b"R", b"E"):
+            continue
+        length, _ = read_exact(stream, 2)
+        yield kind, read_exact(stream, length)
+        if kind == b"E":
+            return
+
+
+def parse_header(payload):
+    adc_clk, conv_x2, decim, nch = struct.unpack_from(HDR_FMT, payload)
+    channels = list(payload[struct.calcsize(HDR_FMT):struct.calcsize(HDR_FMT) + nch])
+    return {"adc_clk": adc_clk, "conv_x2": conv_x2, "decim": decim, "channels": channels}
+
+
+def parse_record(payload, nch):
+    seq, scans = struct.unpack_from("<HH", payload)
+    values = struct.unpack_from("<%dH" % (3 * nch), payload, 4)
+    return seq, scans, [values[3 * i:3 * i + 3] for i in range(nch)]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    src = parser.add_mutually_exclusive_group(required=True)
+    src.add_argument("--file", help="raw stream saved before with --save")
+    src.add_argument("--port", help="serial port, acquisition is started by the tool")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--smp", type=int, default=7, help="sample time code 0 .. 7 (adc_smp_t)")
+    parser.add_argument("--decim", type=int, default=1000, help="scans per record")
+    parser.add_argument("--seconds", type=float, default=5.0)
+    parser.add_argument("--save", help="also save raw stream")
+    parser.add_argument("-o", "--out", required=True, help="CSV file")
+    args = parser.parse_args()
+
+    if args.port:
+        import serial
+        port = serial.Serial(args.port, args.baud, timeout=1.0)
+        port.reset_input_buffer()
+        port.write(("adc start %d %d\r" % (args.smp, args.decim)).encode())
+        stream = TimedPort(port, time.monotonic() + args.seconds)
+    else:
+        stream = Recorder(open(args.file, "rb"))
+
+    hdr = None
+    end = None
+    rows = []
+    for kind, payload in read_frames(stream):
+        if kind == b"H":
+            hdr = parse_header(payload)
+        elif kind == b"R" and hdr is not None:
+            rows.append(parse_record(payload, len(hdr["channels"])))
+        elif kind == b"E":
+            end = dict(zip(END_NAMES, struct.unpack(END_FMT, payload)))
+    if args.save:
+        with open(args.save, "wb") as f:
+            f.write(stream.data)
+    if hdr is None:
+        sys.exit("header frame not found")
+
+    channels = hdr["channels"]
+    nch = len(channels)
+    scan_s = nch * hdr["conv_x2"] / (2.0 * hdr["adc_clk"])
+    vref = channels.index(CH_VREF) if CH_VREF in channels else None
+    names = ["ch%d" % c for c in channels]
+
+    cols = ["time_s", "seq"]
+    for n in names:
+        cols += [n + "_mean", n + "_min", n + "_max"]
+    if vref is not None:
+        cols += ["vdda_mv"] + [n + ("_degc" if c == CH_TEMP else "_mv") for n, c in zip(names, channels)]
+
+    missing = 0
+    scans = 0
+    last_seq = None
+    with open(args.out, "w") as out:
+        out.write(",".join(cols) + "\n")
+        for seq, rec_scans, stat in rows:
+            if last_seq is not None and seq != (last_seq + 1) & 0xFFFF:
+                gap = (seq - last_seq - 1) & 0xFFFF
+                missing += gap
+                scans += gap * hdr["decim"]
+            last_seq = seq
+            line = ["%.6f" % (scans * scan_s), "%d" % seq]
+            for mean, lo, hi in stat:
+                line += ["%d" % mean, "%d" % lo, "%d" % hi]
+            if vref is not None and stat[vref][0]:
+                vdda = VREFINT_MV * 4095.0 / stat[vref][0]
+                line.append("%.0f" % vdda)
+                for c, (mean, _, _) in zip(channels, stat):
+                    mv = mean * vdda / 4095.0
+                    if c == CH_TEMP:
+                        line.append("%.1f" % ((TEMP_V25_MV - mv) / TEMP_SLOPE_MV + 25.0))
+                    else:
+                        line.append("%.0f" % mv)
+            out.write(",".join(line) + "\n")
+            scans += rec_scans
+
+    rate = 2.0 * hdr["adc_clk"] / hdr["conv_x2"]
+    print("%d channels %s, %.0f conversions/s (%.0f scans/s), %d scans per record" % (
+        nch, channels, rate, rate / nch, hdr["decim"]))
+    print("%d records, %.3f s" % (len(rows), scans * scan_s))
+    if end:
+        if end["elapsed"]:
+            print("cpu load %.1f %%" % (100.0 * end["busy"] / end["elapsed"]))
+        if end["drops"] or missing:
+            print("%d records dropped on target (link too slow, raise decim), %d missing in stream" % (
+                end["drops"], missing))
+        if end["overruns"]:
+            print("%d half buffers overwritten before processed" % end["overruns"])
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
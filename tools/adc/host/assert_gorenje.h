@@ -0,0 +1,7 @@
+/* host build of source/Adc processing stage (tools/adc/adc_bench.c) */
+#ifndef ASSERT_GORENJE_HOST_H
+#define ASSERT_GORENJE_HOST_H
+
+#include <assert.h>
+
+#endif /* ASSERT_GORENJE_HOST_H */
@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+"""
+Make patch of new application image against installed one, for DELTA update of UART
+bootloader (format in bootloader/Boot.h). Patch is applied in place, page by page, so
+while page q is built COPY can read new image below page q and old image from page q on.
+Matches are searched in that view only.
+
+Patch is checked with simulation of the bootloader applier (in place flash, page commits)
+and its transfer size is reported against full image.
+
+usage:
+    boot_delta.py old.bin new.bin -o patch.bin
+    boot_delta.py old.bin new.bin --baud 115200
+"""
+import argparse
+import struct
+import sys
+
+PAGE_SIZE = 1024            # BOOT_PAGE_SIZE
+APP_SIZE = 32 * 1024        # BOOT_APP_SIZE
+BLOCK_SIZE = 256            # BOOT_BLOCK_SIZE
+FRAME_OVERHEAD = 10         # SOF, type, seq, len, crc32
+
+OP_COPY = 0x01
+OP_LIT = 0x02
+COPY_HDR = 5
+LIT_HDR = 3
+
+KEY_LEN = 4                 # hash key
+MIN_COPY = 8                # shorter match costs more than literal
+MAX_CANDIDATES = 32
+
+
+def view_of(old, new, page):
+    """ flash content while page is built """
+    start = page * PAGE_SIZE
+    return new[:start] + old[start:]
+
+
+def build_index(view):
+    index = {}
+    for i in range(len(view) - KEY_LEN + 1):
+        index.setdefault(view[i:i + KEY_LEN], []).append(i)
+    return index
+
+
+def match_len(view, src, new, pos, end):
+    n = 0
+    while pos + n < end and src + n < len(view) and view[src + n] == new[pos + n]:
+        n += 1
+    return n
+
+
+def make_patch(old, new):
+    """ COPY / LIT ops, no op crosses page boundary of new image """
+    ops = bytearray()
+    lit = bytearray()
+
+    def flush_lit():
+        if lit:
+            ops.extend(struct.pack("<BH", OP_LIT, len(lit)) + lit)
+            lit.clear()
+
+    last_delta = 0
+    for page in range((len(new) + PAGE_SIZE - 1) // PAGE_SIZE):
+        view = view_of(old, new, page)
+        index = build_index(view)
+        pos = page * PAGE_SIZE
+        end = min(pos + PAGE_SIZE, len(new))
+        while pos < end:
+            best_len = 0
+            best_src = 0
+            # continuation of previous copy first, then same offset, then hashed candidates
+            candidates = [pos + last_delta, pos]
+            candidates += index.get(bytes(new[pos:pos + KEY_LEN]), [])[-MAX_CANDIDATES:]
+            for src in candidates:
+                if 0 <= src < len(view):
+                    n = match_len(view, src, new, pos, end)
+                    if n > best_len:
+                        best_len, best_src = n, src
+                        if pos + n == end:
+                            break
+            if best_len >= MIN_COPY:
+                flush_lit()
+                ops.extend(struct.pack("<BHH", OP_COPY, best_len, best_src))
+                last_delta = best_src - pos
+                pos += best_len
+            else:
+                lit.append(new[pos])
+                pos += 1
+        flush_lit()
+    return bytes(ops)
+
+
+def apply_sim(old, patch, size):
+    """ bootloader applier: in place flash, changed page erased and programmed when complete """
+    flash = bytearray(old) + b"\xff" * (APP_SIZE - len(old))
+    page_buf = bytearray(b"\xff" * PAGE_SIZE)
+    out = 0
+    commits = 0
+
+    def put(data):
+        nonlocal out, commits
+        page_buf[out % PAGE_SIZE] = data
+        out += 1
+        if out % PAGE_SIZE == 0 or out == size:
+            page = (out - 1) // PAGE_SIZE
+            if flash[page * PAGE_SIZE:(page + 1) * PAGE_SIZE] != page_buf:
+                flash[page * PAGE_SIZE:(page + 1) * PAGE_SIZE] = page_buf
+                commits += 1
+            page_buf[:] = b"\xff" * PAGE_SIZE
+
+    i = 0
+    while i < len(patch):
+        op = patch[i]
+        if op == OP_LIT:
+            (n,) = struct.unpack_from("<H", patch, i + 1)
+            for b in patch[i + LIT_HDR:i + LIT_HDR + n]:
+                put(b)
+            i += LIT_HDR + n
+        elif op == OP_COPY:
+            n, src = struct.unpack_from("<HH", patch, i + 1)
+            assert src + n <= APP_SIZE
+            for k in range(n):
+                put(flash[src + k])
+            i += COPY_HDR
+        else:
+            raise ValueError("bad op at %d" % i)
+        assert out <= size
+    return bytes(flash[:size]), commits
+
+
+def wire_bytes(stream_size):
+    """ host -> device bytes on the line for data phase """
+    blocks = (stream_size + BLOCK_SIZE - 1) // BLOCK_SIZE
+    return stream_size + blocks * FRAME_OVERHEAD
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("old")
+    parser.add_argument("new")
+    parser.add_argument("-o", "--out")
+    parser.add_argument("--baud", type=int, default=115200, help="for transfer time estimate")
+    args = parser.parse_args()
+
+    with open(args.old, "rb") as f:
+        old = f.read()
+    with open(args.new, "rb") as f:
+        new = f.read()
+    if len(old) > APP_SIZE or not 0 < len(new) <= APP_SIZE:
+        sys.exit("images must fit application region (%d bytes)" % APP_SIZE)
+
+    patch = make_patch(old, new)
+    rebuilt, commits = apply_sim(old, patch, len(new))
+    if rebuilt != new:
+        sys.exit("simulated apply does not match new image")
+
+    full_tx = wire_bytes(len(new))
+    delta_tx = wire_bytes(len(patch))
+    print("image %d bytes, patch %d bytes (%.1f %%), pages erased %d" %
+          (len(new), len(patch), 100.0 * len(patch) / len(new), commits))
+    print("on the line: full %d bytes %.2f s, delta %d bytes %.2f s at %d baud" %
+          (full_tx, full_tx * 10.0 / args.baud, delta_tx, delta_tx * 10.0 / args.baud, args.baud))
+    if args.out:
+        with open(args.out, "wb") as f:
+            f.write(patch)
+
+
+if __name__ == "__main__":
+    main()
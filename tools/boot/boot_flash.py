@@ -0,0 +1,225 @@
+#!/usr/bin/env python3
+"""
+Flash application binary over UART bootloader (bootloader/, protocol in bootloader/Boot.h).
+
+Application must be linked with STM32F103C8_FLASH.ld (starts at 0x08002000), binary made by
+    arm-none-eabi-objcopy -O binary app.elf app.bin
+With --enter "boot" shell command is sent first, otherwise device must already be in
+bootloader (no valid application, or reset after "boot").
+
+Blocks are sent in sliding window, --window 1 gives stop-and-wait for comparison.
+Achieved throughput is reported against line rate.
+
+With --old (image installed on device) only patch made by boot_delta.py is sent. Device
+checks crc of installed image, on mismatch full image is sent instead.
+
+usage:
+    boot_flash.py --port COM5 --bin app.bin --enter
+    boot_flash.py --port COM5 --bin app.bin --fast-baud 1000000 --window 6
+    boot_flash.py --port COM5 --bin app.bin --old installed.bin --fast-baud 0
+"""
+import argparse
+import struct
+import sys
+import time
+import zlib
+
+import serial
+
+import boot_delta
+
+SOF_HOST = 0x5A
+SOF_DEV = 0xA5
+
+T_START = 0x01
+T_DATA = 0x02
+T_END = 0x03
+T_DELTA = 0x04
+T_ACK = 0x80
+T_NAK = 0x81
+T_DONE = 0x82
+T_ERR = 0x83
+
+ERR_BASE = 6
+ERR_NAMES = {1: "size", 2: "state", 3: "flash", 4: "crc", 5: "baud", ERR_BASE: "base image", 7: "patch"}
+
+BLOCK_SIZE = 256            # BOOT_BLOCK_SIZE
+APP_SIZE = 32 * 1024        # BOOT_APP_SIZE
+WINDOW_MAX = 6              # BOOT_WINDOW, device ring holds this many frames
+BOOT_BAUD = 115200
+
+START_TIMEOUT = 3.0         # device erases application region before ACK
+TIMEOUT = 0.5
+
+
+def frame(ftype, seq, payload=b""):
+    body = struct.pack("<BHH", ftype, seq, len(payload)) + payload
+    return bytes([SOF_HOST]) + body + struct.pack("<I", zlib.crc32(body) & 0xFFFFFFFF)
+
+
+class Replies:
+    """ device replies: SOF_DEV, type, seq (u16), ~sum """
+
+    def __init__(self, port):
+        self.port = port
+        self.buf = bytearray()
+
+    def get(self, timeout):
+        """ next valid reply (type, seq) or None on timeout """
+        end = time.monotonic() + timeout
+        while True:
+            while len(self.buf) >= 5:
+                if self.buf[0] != SOF_DEV:
+                    del self.buf[0]
+                    continue
+                ftype, seq_lo, seq_hi, check = self.buf[1:5]
+                if ((ftype + seq_lo + seq_hi + check) & 0xFF) != 0xFF:
+                    del self.buf[0]
+                    continue
+                del self.buf[:5]
+                return ftype, seq_lo | (seq_hi << 8)
+            left = end - time.monotonic()
+            if left <= 0:
+                return None
+            self.port.timeout = min(left, 0.01)
+            self.buf += self.port.read(max(1, self.port.in_waiting))
+
+    def clear(self):
+        self.buf.clear()
+        self.port.reset_input_buffer()
+
+
+class BootError(Exception):
+    def __init__(self, msg, code=0):
+        super().__init__(msg)
+        self.code = code
+
+
+def check_err(reply):
+    if reply is not None and reply[0] == T_ERR:
+        raise BootError("device error: " + ERR_NAMES.get(reply[1], str(reply[1])), reply[1])
+
+
+def start(port, replies, image, fast_baud, old=None, patch=None):
+    """ START for full image, DELTA when patch against old is given """
+    ftype = T_START
+    payload = struct.pack("<III", len(image), zlib.crc32(image) & 0xFFFFFFFF, fast_baud)
+    if patch is not None:
+        ftype = T_DELTA
+        payload += struct.pack("<III", len(old), zlib.crc32(old) & 0xFFFFFFFF, len(patch))
+    for _ in range(3):
+        replies.clear()
+        port.write(frame(ftype, 0, payload))
+        reply = replies.get(START_TIMEOUT)
+        check_err(reply)
+        if reply == (T_ACK, 0):
+            break
+    else:
+        raise BootError("no answer to START")
+    if fast_baud:
+        port.flush()
+        port.baudrate = fast_baud
+
+
+def transfer(port, replies, stream, window):
+    """ go-back-N: ACK n is cumulative, NAK n or timeout restarts sending from n """
+    blocks = [stream[i:i + BLOCK_SIZE] for i in range(0, len(stream), BLOCK_SIZE)]
+    base = 0
+    nxt = 0
+    resent = 0
+    last_progress = time.monotonic()
+    while base < len(blocks):
+        while nxt < len(blocks) and nxt < base + window:
+            port.write(frame(T_DATA, nxt, blocks[nxt]))
+            nxt += 1
+        reply = replies.get(TIMEOUT)
+        check_err(reply)
+        now = time.monotonic()
+        if reply is None:
+            if now - last_progress > TIMEOUT:
+                resent += nxt - base
+                nxt = base
+                last_progress = now
+            continue
+        ftype, seq = reply
+        if seq > base:
+            base = min(seq, len(blocks))
+            last_progress = now
+        if ftype == T_NAK and seq < nxt:
+            resent += nxt - seq
+            nxt = seq
+        nxt = max(nxt, base)
+    return resent
+
+
+def end(port, replies):
+    for _ in range(3):
+        port.write(frame(T_END, 0))
+        reply = replies.get(START_TIMEOUT)
+        check_err(reply)
+        if reply is not None and reply[0] == T_DONE:
+            return
+    raise BootError("no answer to END")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--port", required=True)
+    parser.add_argument("--baud", type=int, default=BOOT_BAUD, help="bootloader baud after reset")
+    parser.add_argument("--fast-baud", type=int, default=1000000, help="baud for transfer, 0: keep")
+    parser.add_argument("--bin", required=True)
+    parser.add_argument("--window", type=int, default=WINDOW_MAX)
+    parser.add_argument("--enter", action="store_true", help='send "boot" shell command first')
+    parser.add_argument("--old", help="image installed on device, send patch only")
+    args = parser.parse_args()
+
+    with open(args.bin, "rb") as f:
+        image = f.read()
+    if not 0 < len(image) <= APP_SIZE:
+        sys.exit("image size %d, application region is %d" % (len(image), APP_SIZE))
+    window = max(1, min(args.window, WINDOW_MAX))
+    old = None
+    patch = None
+    if args.old:
+        with open(args.old, "rb") as f:
+            old = f.read()
+        patch = boot_delta.make_patch(old, image)
+        if boot_delta.apply_sim(old, patch, len(image))[0] != image:
+            sys.exit("patch does not rebuild image")
+    stream = image
+
+    port = serial.Serial(args.port, args.baud, timeout=TIMEOUT)
+    replies = Replies(port)
+    try:
+        if args.enter:
+            port.write(b"boot\r")
+            time.sleep(0.3)
+        if patch is not None:
+            try:
+                start(port, replies, image, args.fast_baud, old, patch)
+                stream = patch
+            except BootError as e:
+                if e.code != ERR_BASE:
+                    raise
+                print("installed image differs from --old, sending full image")
+        if stream is image:
+            start(port, replies, image, args.fast_baud)
+        t_start = time.monotonic()
+        resent = transfer(port, replies, stream, window)
+        t_data = time.monotonic() - t_start
+        end(port, replies)
+    except BootError as e:
+        sys.exit(str(e))
+    finally:
+        port.close()
+
+    baud = args.fast_baud or args.baud
+    rate = len(stream) / t_data
+    print("%d bytes in %.3f s, window %d, resent blocks %d" % (len(stream), t_data, window, resent))
+    print("%.1f kB/s, %.0f %% of line rate %d baud" % (rate / 1000.0, 100.0 * rate * 10 / baud, baud))
+    if stream is patch:
+        print("delta: sent %d of %d image bytes (%.1f %%)" % (len(patch), len(image), 100.0 * len(patch) / len(image)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+"""
+Decode crash dump printed by source/Fault (at boot after a fault, or shell command "fault").
+
+Fault status registers are explained bit by bit, pc and lr of the stacked frame are
+symbolized against the .elf with arm-none-eabi-addr2line. Stack words that look like
+return addresses (odd, inside application flash) are listed as call chain candidates,
+innermost first; not every candidate is a real frame (stale stack content).
+
+Dump is read from log file, stdin, or directly from serial port (waits for next dump).
+
+usage:
+    fault_decode.py crash.log --elf Debug/STM32F103_bluePil_evaluation.elf
+    fault_decode.py --port COM5 --elf Debug/STM32F103_bluePil_evaluation.elf
+"""
+import argparse
+import re
+import subprocess
+import sys
+
+APP_START = 0x08002000      # STM32F103C8_FLASH.ld
+APP_END = 0x0800A000
+
+CFSR_BITS = {
+    0: "IACCVIOL: instruction access violation",
+    1: "DACCVIOL: data access violation (MMFAR)",
+    3: "MUNSTKERR: MemManage on exception return unstacking",
+    4: "MSTKERR: MemManage on exception entry stacking",
+    7: "MMARVALID: MMFAR holds fault address",
+    8: "IBUSERR: instruction bus error",
+    9: "PRECISERR: precise data bus error (BFAR)",
+    10: "IMPRECISERR: imprecise data bus error, pc is after the access",
+    11: "UNSTKERR: BusFault on exception return unstacking",
+    12: "STKERR: BusFault on exception entry stacking, stack overflow?",
+    15: "BFARVALID: BFAR holds fault address",
+    16: "UNDEFINSTR: undefined instruction",
+    17: "INVSTATE: invalid state, branch to even address or bad EXC_RETURN",
+    18: "INVPC: invalid EXC_RETURN on exception return",
+    19: "NOCP: coprocessor access",
+    24: "UNALIGNED: unaligned access with UNALIGN_TRP",
+    25: "DIVBYZERO: divide by zero with DIV_0_TRP",
+}
+HFSR_BITS = {
+    1: "VECTTBL: bus fault on vector table read",
+    30: "FORCED: escalated from configurable fault (see CFSR)",
+    31: "DEBUGEVT: debug event",
+}
+
+HEAD_RE = re.compile(r"^FAULT (\S+) cnt (\d+) tick (\d+)")
+PAIR_RE = re.compile(r"(\w+) ([0-9a-f]{8})")
+
+
+def parse(lines):
+    """ last complete dump in lines: dict with name, cnt, tick, registers and stack list """
+    dump = None
+    found = None
+    for line in lines:
+        line = line.strip()
+        m = HEAD_RE.match(line)
+        if m:
+            dump = {"name": m.group(1), "cnt": int(m.group(2)), "tick": int(m.group(3)), "stack": []}
+            continue
+        if dump is None:
+            continue
+        if line == "END":
+            found = dump
+            dump = None
+        elif line.startswith("stack"):
+            dump["stack"] += [int(w, 16) for w in line.split()[1:]]
+        else:
+            for name, value in PAIR_RE.findall(line):
+                dump[name] = int(value, 16)
+    return found
+
+
+def read_port(port_name, baud):
+    import serial
+
+    lines = []
+    with serial.Serial(port_name, baud, timeout=None) as port:
+        print("waiting for dump on %s (reset device or send \"fault\")" % port_name, file=sys.stderr)
+        while True:
+            line = port.readline().decode("ascii", "replace")
+            if HEAD_RE.match(line.strip()):
+                lines = []
+            lines.append(line)
+            if line.strip() == "END" and parse(lines):
+                return lines
+
+
+def symbolize(elf, addrs, addr2line):
+    """ addr -> 'function at file:line' """
+    if not elf or not addrs:
+        return {}
+    out = subprocess.run([addr2line, "-e", elf, "-f", "-i", "-p", "-C"] + ["0x%08x" % a for a in addrs],
+                         stdout=subprocess.PIPE, universal_newlines=True, check=True).stdout
+    # -i adds inlined callers on lines starting with " (inlined by)"
+    result = {}
+    it = iter(addrs)
+    for line in out.splitlines():
+        if line.startswith(" (inlined by)"):
+            result[addr] += "\n" + " " * 24 + line.strip()
+            continue
+        addr = next(it)
+        result[addr] = line.strip()
+    return result
+
+
+def bits(value, names):
+    return [text for bit, text in sorted(names.items()) if value & (1 << bit)]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("log", nargs="?", help="log file with dump, stdin if omitted")
+    parser.add_argument("--port", help="read dump from serial port instead")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--elf", help="application .elf, without it addresses are not symbolized")
+    parser.add_argument("--addr2line", default="arm-none-eabi-addr2line")
+    args = parser.parse_args()
+
+    if args.port:
+        lines = read_port(args.port, args.baud)
+    elif args.log:
+        with open(args.log, "r", errors="replace") as f:
+            lines = f.readlines()
+    else:
+        lines = sys.stdin.readlines()
+    dump = parse(lines)
+    if dump is None:
+        sys.exit("no complete FAULT ... END dump found")
+
+    # return addresses on stack have thumb bit set, call instruction is just before them
+    chain = [w for w in dump["stack"] if (w & 1) and APP_START <= w < APP_END]
+    code = [dump["pc"], (dump["lr"] & ~1) - 2] + [(w & ~1) - 2 for w in chain]
+    code = [a for a in code if APP_START <= a < APP_END]
+    sym = symbolize(args.elf, sorted(set(code)), args.addr2line)
+
+    def where(addr):
+        return sym.get(addr, "-")
+
+    print("%s #%d at tick %d ms" % (dump["name"], dump["cnt"], dump["tick"]))
+    print("  pc   0x%08x  %s" % (dump["pc"], where(dump["pc"])))
+    print("  lr   0x%08x  %s" % (dump["lr"], where((dump["lr"] & ~1) - 2)))
+    print("  sp   0x%08x  exc_return 0x%08x (%s stack, %s mode)" % (
+        dump["sp"], dump["exc_return"], "process" if dump["exc_return"] & 4 else "main",
+        "thread" if dump["exc_return"] & 8 else "handler"))
+    print("  r0 0x%08x r1 0x%08x r2 0x%08x r3 0x%08x r12 0x%08x psr 0x%08x" % (
+        dump["r0"], dump["r1"], dump["r2"], dump["r3"], dump["r12"], dump["psr"]))
+    if dump["pc"] == 0 and dump["psr"] == 0:
+        print("  frame not captured, SP was outside RAM when fault was taken")
+
+    print("cfsr 0x%08x" % dump["cfsr"])
+    for text in bits(dump["cfsr"], CFSR_BITS):
+        print("  " + text)
+    if dump["cfsr"] & (1 << 7):
+        print("  MMFAR 0x%08x" % dump["mmfar"])
+    if dump["cfsr"] & (1 << 15):
+        print("  BFAR  0x%08x" % dump["bfar"])
+    print("hfsr 0x%08x" % dump["hfsr"])
+    for text in bits(dump["hfsr"], HFSR_BITS):
+        print("  " + text)
+
+    if chain:
+        print("call chain candidates from stack (%d words):" % len(dump["stack"]))
+        for w in chain:
+            print("  0x%08x  %s" % (w, where((w & ~1) - 2)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
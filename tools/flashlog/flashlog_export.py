@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+"""
+Read telemetry log export (source/FlashLog) and print it as CSV, oldest record first.
+
+Export is requested by sending "flog dump\\r" to serial_0. Input is either a file with raw
+captured bytes or serial port (needs pyserial). With --port, achieved transfer rate is
+reported against line rate, so export speed can be checked.
+
+usage:
+    flashlog_export.py --ids source/FlashLog/FlashLog.h --file dump.bin -o log.csv
+    flashlog_export.py --ids source/FlashLog/FlashLog.h --port COM5 --baud 115200 -o log.csv
+"""
+import argparse
+import re
+import struct
+import sys
+import time
+
+HDR_FMT = "<4sBBHI"
+HDR_SIZE = struct.calcsize(HDR_FMT)
+REC_FMT = "<IHH"
+REC_SIZE = struct.calcsize(REC_FMT)
+MAGIC = b"FLG1"
+
+
+def load_ids(header_path):
+    """ read flog_id_t enum from FlashLog.h -> {id: name} """
+    names = {}
+    if header_path is None:
+        return names
+    with open(header_path, "r") as f:
+        text = f.read()
+    body = re.search(r"typedef\s+enum\s+_flog_id_t\s*\{(.*?)\}", text, re.S).group(1)
+    value = 0
+    for line in body.splitlines():
+        m = re.match(r"\s*FLOG_ID_(\w+)\s*(?:=\s*(\w+))?\s*,?", line)
+        if not m:
+            continue
+        if m.group(2) is not None:
+            value = int(m.group(2), 0)
+        names[value] = m.group(1)
+        value += 1
+    return names
+
+
+def id_name(names, rec_id):
+    if rec_id in names:
+        return names[rec_id]
+    user = names.get(0x100)
+    if user is not None and rec_id > 0x100:
+        return "%s+%d" % (user, rec_id - 0x100)
+    return "0x%04X" % rec_id
+
+
+def read_export(stream):
+    """ find header in byte stream (shell echo may precede it), return tick and records """
+    window = b""
+    while True:
+        b = stream.read(1)
+        if not b:
+            raise EOFError("export header not found")
+        window = (window + b)[-4:]
+        if window == MAGIC:
+            break
+    t_start = time.perf_counter()
+    rest = stream.read(HDR_SIZE - 4)
+    _, rec_size, _, rec_cnt, tick = struct.unpack(HDR_FMT, MAGIC + rest)
+    if rec_size != REC_SIZE:
+        raise ValueError("unexpected record size %d" % rec_size)
+    data = b""
+    while len(data) < rec_cnt * REC_SIZE:
+        chunk = stream.read(rec_cnt * REC_SIZE - len(data))
+        if not chunk:
+            raise EOFError("export truncated (%d of %d records)" % (len(data) // REC_SIZE, rec_cnt))
+        data += chunk
+    elapsed = time.perf_counter() - t_start
+    records = [struct.unpack_from(REC_FMT, data, i * REC_SIZE) for i in range(rec_cnt)]
+    return tick, records, HDR_SIZE + len(data), elapsed
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--ids", help="FlashLog.h with flog_id_t enum")
+    ap.add_argument("--file", help="raw captured export")
+    ap.add_argument("--port", help="serial port, export is requested")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("-o", "--out", help="CSV output (default stdout)")
+    args = ap.parse_args()
+
+    names = load_ids(args.ids)
+    if args.file:
+        with open(args.file, "rb") as f:
+            tick, records, nbytes, elapsed = read_export(f)
+    elif args.port:
+        import serial
+        with serial.Serial(args.port, args.baud, timeout=2) as port:
+            port.reset_input_buffer()
+            port.write(b"\rflog dump\r")
+            tick, records, nbytes, elapsed = read_export(port)
+        line_rate = args.baud / 10.0  # 8N1
+        if elapsed > 0:
+            sys.stderr.write("%d bytes in %.2f s: %.0f B/s, line rate %.0f B/s (%.0f %%)\n"
+                             % (nbytes, elapsed, nbytes / elapsed, line_rate, 100.0 * nbytes / elapsed / line_rate))
+    else:
+        ap.error("--file or --port is required")
+
+    out = open(args.out, "w") if args.out else sys.stdout
+    out.write("boot,tm_ms,id,arg\n")
+    boot = 0
+    for tm, arg, rec_id in records:
+        if rec_id == 0 and names.get(0) == "BOOT":
+            boot += 1
+        out.write("%d,%d,%s,%d\n" % (boot, tm, id_name(names, rec_id), arg))
+    if out is not sys.stdout:
+        out.close()
+    sys.stderr.write("%d records, device tick at export %d ms\n" % (len(records), tick))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,13 @@
+/* host build of source/KVstore test (tools/kvstore/kv_test_host.c): port is stdout */
+#ifndef SERIAL_HOST_H
+#define SERIAL_HOST_H
+
+#include <stdint.h>
+
+typedef struct _serial_ctrl_desc_t{
+    uint8_t     unused;
+}serial_ctrl_desc_t;
+
+extern serial_ctrl_desc_t serial_0;
+
+#endif /* SERIAL_HOST_H */
@@ -0,0 +1,12 @@
+/* host build of source/KVstore test (tools/kvstore/kv_test_host.c): prints to stdout */
+#ifndef SHELL_HOST_H
+#define SHELL_HOST_H
+
+#include <stdint.h>
+
+#include "Serial.h"
+
+void Shell_print(serial_ctrl_desc_t *p_serial, const char *pStr);
+void Shell_print_u32(serial_ctrl_desc_t *p_serial, uint32_t num);
+
+#endif /* SHELL_HOST_H */
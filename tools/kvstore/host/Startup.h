@@ -0,0 +1,7 @@
+/* host build of source/KVstore test (tools/kvstore/kv_test_host.c): no .noinit section */
+#ifndef STARTUP_HOST_H
+#define STARTUP_HOST_H
+
+#define NOINIT
+
+#endif /* STARTUP_HOST_H */
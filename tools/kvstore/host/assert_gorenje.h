@@ -0,0 +1,7 @@
+/* host build of source/KVstore test (tools/kvstore/kv_test_host.c) */
+#ifndef ASSERT_GORENJE_HOST_H
+#define ASSERT_GORENJE_HOST_H
+
+#include <assert.h>
+
+#endif /* ASSERT_GORENJE_HOST_H */
@@ -0,0 +1,42 @@
+/**
+ * @file kv_test_host.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief host build of source/KVstore test. Same test code as on target, simulated flash
+ * lives in host RAM and serial_0 prints to stdout. Exit code is 0 when all checks pass.
+ *
+ * build and run from repository root:
+ *  gcc -O2 -Itools/kvstore/host -Isource/KVstore -Isource/KVstore/test tools/kvstore/kv_test_host.c
+ *   source/KVstore/KVstore.c source/KVstore/test/KVstore_test.c -o kv_test
+ *  ./kv_test
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#include <stdio.h>
+
+#include "KVstore_test.h"
+#include "Serial.h"
+#include "Shell.h"
+
+serial_ctrl_desc_t serial_0;
+
+void Shell_print(serial_ctrl_desc_t *p_serial, const char *pStr) {
+    (void)p_serial;
+    /* target line ends are \r\n */
+    for (; *pStr != '\0'; ++pStr) {
+        if (*pStr != '\r') {
+            putchar(*pStr);
+        }
+    }
+}
+
+void Shell_print_u32(serial_ctrl_desc_t *p_serial, uint32_t num) {
+    (void)p_serial;
+    printf("%u", num);
+}
+
+int main(void) {
+    return (kv_test_run() == 0) ? 0 : 1;
+}
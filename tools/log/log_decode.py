@@ -0,0 +1,137 @@
+#!/usr/bin/env python3
+"""
+Decode deferred log output (source/Log). Format strings are read from .log_fmt section
+of the firmware .elf, frames are read from serial port or captured file. Bytes outside
+of log frames (normal Serial.print text) are passed through unchanged.
+
+usage:
+    log_decode.py Debug/STM32F103_bluePil_evaluation.elf --port COM5
+    log_decode.py Debug/STM32F103_bluePil_evaluation.elf --file capture.bin
+"""
+import argparse
+import re
+import struct
+import sys
+
+FRAME_START = 0x1E
+LEVELS = {"E": "ERR", "W": "WRN", "I": "INF", "D": "DBG"}
+
+
+def elf_section(path, name):
+    """ minimal ELF32 little endian reader -> (sh_addr, data) of named section """
+    with open(path, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF" or elf[4] != 1:
+        raise ValueError("not an ELF32 file")
+    e_shoff, = struct.unpack_from("<I", elf, 0x20)
+    e_shentsize, e_shnum, e_shstrndx = struct.unpack_from("<HHH", elf, 0x2E)
+
+    def shdr(i):
+        return struct.unpack_from("<IIIIIIIIII", elf, e_shoff + i * e_shentsize)
+
+    strtab = shdr(e_shstrndx)
+    for i in range(e_shnum):
+        sh = shdr(i)
+        off = strtab[4] + sh[0]
+        sec_name = elf[off:elf.index(b"\0", off)].decode()
+        if sec_name == name:
+            return sh[3], elf[sh[4]:sh[4] + sh[5]]
+    raise KeyError("section %s not found" % name)
+
+
+def load_formats(elf_path):
+    """ {address: (level, format)} for every string in .log_fmt """
+    addr, data = elf_section(elf_path, ".log_fmt")
+    fmts = {}
+    pos = 0
+    while pos < len(data):
+        end = data.index(b"\0", pos)
+        s = data[pos:end].decode("ascii", "replace")
+        if s:
+            fmts[addr + pos] = (LEVELS.get(s[0], "?"), s[1:])
+        pos = end + 1
+        # strings may be padded to alignment
+        while pos < len(data) and data[pos] == 0:
+            pos += 1
+    return fmts
+
+
+def varints(payload):
+    vals = []
+    val = shift = 0
+    for b in payload:
+        val |= (b & 0x7F) << shift
+        shift += 7
+        if not b & 0x80:
+            vals.append(val)
+            val = shift = 0
+    return vals
+
+
+SPEC = re.compile(r"%([-+ 0#]*\d*(?:\.\d+)?)(hh|h|ll|l|z)?([diuxXc%])")
+
+
+def format_msg(fmt, args):
+    out = []
+    pos = 0
+    args = list(args)
+    for m in SPEC.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        conv = m.group(3)
+        if conv == "%":
+            out.append("%")
+            continue
+        val = args.pop(0) if args else 0
+        if conv in "di" and val & 0x80000000:
+            val -= 0x100000000
+        out.append(("%" + m.group(1) + conv) % val)
+    out.append(fmt[pos:])
+    return "".join(out)
+
+
+def decode(stream, fmts, out):
+    while True:
+        b = stream.read(1)
+        if not b:
+            return
+        if b[0] != FRAME_START:
+            out.write(b.decode("ascii", "replace"))
+            continue
+        n = stream.read(1)
+        if not n:
+            return
+        payload = stream.read(n[0])
+        vals = varints(payload)
+        if not vals or vals[0] not in fmts:
+            out.write("<bad log frame %s>\n" % payload.hex())
+            continue
+        level, fmt = fmts[vals[0]]
+        out.write("[%s] %s\n" % (level, format_msg(fmt, vals[1:])))
+        out.flush()
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("elf", help="firmware .elf with .log_fmt section")
+    ap.add_argument("--file", help="captured raw serial data")
+    ap.add_argument("--port", help="serial port (needs pyserial)")
+    ap.add_argument("--baud", type=int, default=115200)
+    args = ap.parse_args()
+
+    fmts = load_formats(args.elf)
+    if args.port:
+        import serial
+        stream = serial.Serial(args.port, args.baud)
+    elif args.file:
+        stream = open(args.file, "rb")
+    else:
+        stream = sys.stdin.buffer
+    try:
+        decode(stream, fmts, sys.stdout)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+"""
+Capture logic analyzer stream (source/Logic) and write VCD (GTKWave, PulseView).
+
+Capture is started with "la start <rate> <port> <mask> <samples>\\r" on serial_0 and
+runs until the end frame. Stream is a sequence of frames 'L', type, len, seq, payload:
+'H' header, 'D' run-length records, 'E' end with statistics. Shell echo between frames
+is skipped. Raw stream can be saved and decoded again later with --file.
+
+usage:
+    la_capture.py --port COM5 --rate 100000 --gpio B --samples 1000000 -o capture.vcd
+    la_capture.py --port COM5 --rate 20000 --gpio A --mask 0x00ff --save raw.bin -o a.vcd
+    la_capture.py --file raw.bin -o capture.vcd
+"""
+import argparse
+import struct
+import sys
+
+HDR_FMT = "<IIBBH"
+END_FMT = "<5I"
+END_NAMES = ("samples", "lost", "bytes", "busy", "elapsed")
+
+
+class Recorder:
+    """ stream wrapper that keeps a copy of everything read """
+
+    def __init__(self, stream):
+        self.stream = stream
+        self.data = bytearray()
+
+    def read(self, n):
+        chunk = self.stream.read(n)
+        self.data += chunk
+        return chunk
+
+
+def read_exact(stream, n):
+    data = b""
+    while len(data) < n:
+        chunk = stream.read(n - len(data))
+        if not chunk:
+            raise EOFError("stream ended inside a frame")
+        data += chunk
+    return data
+
+
+def read_frames(stream):
+    """ yield (type, payload) until end frame, skipping bytes between frames """
+    seq = None
+    while True:
+        b = stream.read(1)
+        if not b:
+            raise EOFError("stream ended before end frame")
+        if b != b"L":
+            continue
+        kind = stream.read(1)
+        if kind not in (b"H", b"D", b"E"):
+            continue
+        length, frame_seq = read_exact(stream, 2)
+        payload = read_exact(stream, length)
+        if seq is not None and frame_seq != (seq + 1) & 0xFF:
+            print("frame %d missing, data after it is shifted" % ((seq + 1) & 0xFF), file=sys.stderr)
+        seq = frame_seq
+        yield kind, payload
+        if kind == b"E":
+            return
+
+
+def varint(data, pos):
+    value = 0
+    shift = 0
+    while True:
+        b = data[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        shift += 7
+        if not b & 0x80:
+            return value, pos
+
+
+def decode(records):
+    """ run-length records -> [(run, value)], value None for gaps """
+    runs = []
+    pos = 0
+    while pos < len(records):
+        run, pos = varint(records, pos)
+        if run == 0:
+            lost, pos = varint(records, pos)
+            runs.append((lost, None))
+            continue
+        value = records[pos] | (records[pos + 1] << 8)
+        pos += 2
+        runs.append((run, value))
+    return runs
+
+
+def write_vcd(out, hdr, runs):
+    tim_clk, ticks, port, _, mask = hdr
+    bits = [b for b in range(16) if mask & (1 << b)]
+    ident = {b: chr(33 + i) for i, b in enumerate(bits)}
+    ns_per_sample = ticks * 1e9 / tim_clk
+    out.write("$timescale 1 ns $end\n$scope module P%s $end\n" % chr(port))
+    for b in bits:
+        out.write("$var wire 1 %s P%s%d $end\n" % (ident[b], chr(port), b))
+    out.write("$upscope $end\n$enddefinitions $end\n")
+    last = {}
+    sample = 0
+    for run, value in runs:
+        changes = []
+        for b in bits:
+            level = "x" if value is None else "01"[(value >> b) & 1]
+            if last.get(b) != level:
+                changes.append("%s%s" % (level, ident[b]))
+                last[b] = level
+        if changes:
+            out.write("#%d\n%s\n" % (round(sample * ns_per_sample), "\n".join(changes)))
+        sample += run
+    out.write("#%d\n" % round(sample * ns_per_sample))
+    return sample
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    src = parser.add_mutually_exclusive_group(required=True)
+    src.add_argument("--file", help="raw stream saved before with --save")
+    src.add_argument("--port", help="serial port, capture is started by the tool")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--rate", type=int, default=100000, help="samples per second")
+    parser.add_argument("--gpio", default="B", choices=["A", "B", "a", "b"])
+    parser.add_argument("--mask", default="0", help="probed pins, 0: port default")
+    parser.add_argument("--samples", type=int, default=1000000, help="0: until \"la stop\"")
+    parser.add_argument("--save", help="also save raw stream")
+    parser.add_argument("-o", "--out", required=True, help="VCD file")
+    args = parser.parse_args()
+
+    if args.port:
+        import serial
+        port = serial.Serial(args.port, args.baud, timeout=5.0)
+        port.reset_input_buffer()
+        port.write(("la start %d %s %s %d\r" % (args.rate, args.gpio, args.mask, args.samples)).encode())
+        stream = Recorder(port)
+    else:
+        stream = Recorder(open(args.file, "rb"))
+
+    hdr = None
+    end = None
+    records = bytearray()
+    for kind, payload in read_frames(stream):
+        if kind == b"H":
+            hdr = struct.unpack(HDR_FMT, payload)
+        elif kind == b"D":
+            records += payload
+        else:
+            end = dict(zip(END_NAMES, struct.unpack(END_FMT, payload)))
+    if args.save:
+        with open(args.save, "wb") as f:
+            f.write(stream.data)
+    if hdr is None:
+        sys.exit("header frame not found")
+
+    runs = decode(records)
+    with open(args.out, "w") as out:
+        total = write_vcd(out, hdr, runs)
+
+    tim_clk, ticks = hdr[0], hdr[1]
+    rate = tim_clk / ticks
+    print("%d samples at %.0f Hz (%.3f s), %d runs, %d bytes" % (
+        end["samples"], rate, end["samples"] / rate, len(runs), end["bytes"]))
+    if total != end["samples"]:
+        print("decoded %d samples, stream is incomplete" % total)
+    if end["bytes"]:
+        print("compression %.1f : 1 against 2 bytes per sample, %.0f bytes/s on link" % (
+            2.0 * end["samples"] / end["bytes"], end["bytes"] * rate / max(end["samples"], 1)))
+    if end["elapsed"]:
+        print("cpu load %.1f %% (%.1f cycles per sample)" % (
+            100.0 * end["busy"] / end["elapsed"], end["busy"] / max(end["samples"], 1)))
+    if end["lost"]:
+        print("%d samples lost to full output ring, link slower than signal activity" % end["lost"])
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
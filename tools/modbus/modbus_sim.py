@@ -0,0 +1,182 @@
+#!/usr/bin/env python3
+"""
+Modbus RTU master simulator and test for the board (source/Modbus).
+
+Switches the port to Modbus mode ("modbus" shell command), checks functions, exceptions
+and framing rules, then measures turnaround. Exit code is non zero if any check fails
+or the turnaround is above the limit.
+
+Turnaround is checked twice:
+ - device side: max time from t3.5 frame end to response start (input register 4)
+ - host side  : round trip minus request/response line time and t3.5; includes USB
+                serial latency, so it is reported with its own (looser) limit
+
+usage:
+    modbus_sim.py --port COM5 [--baud 115200] [--max-turnaround-us 500]
+"""
+import argparse
+import struct
+import sys
+import time
+
+import serial
+
+SLAVE = 1
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0xA001 if crc & 1 else crc >> 1
+    return crc
+
+
+def adu(pdu, addr=SLAVE):
+    body = bytes([addr]) + pdu
+    return body + struct.pack("<H", crc16(body))
+
+
+class Master:
+    def __init__(self, port, baud):
+        self.port = port
+        self.char_s = 10.0 / baud  # 8N1 on the line
+        self.t35_s = 0.00175 if baud > 19200 else 3.5 * 11.0 / baud
+
+    def transact(self, frame, gap_at=None, gap_s=0.0):
+        """ send frame, return (response or None, round trip s) """
+        self.port.reset_input_buffer()
+        time.sleep(self.t35_s * 2)
+        t0 = time.perf_counter()
+        if gap_at is None:
+            self.port.write(frame)
+        else:
+            self.port.write(frame[:gap_at])
+            self.port.flush()
+            time.sleep(gap_s)
+            self.port.write(frame[gap_at:])
+        self.port.flush()
+        resp = bytearray()
+        t_end = time.perf_counter() + 0.1
+        while time.perf_counter() < t_end:
+            chunk = self.port.read(max(1, self.port.in_waiting))
+            if chunk:
+                resp += chunk
+                if len(resp) >= 5 and self._complete(resp):
+                    break
+        rtt = time.perf_counter() - t0
+        if not resp:
+            return None, rtt
+        return bytes(resp), rtt
+
+    @staticmethod
+    def _complete(resp):
+        if resp[1] & 0x80:
+            return len(resp) >= 5
+        if resp[1] in (3, 4):
+            return len(resp) >= 5 + resp[2]
+        return len(resp) >= 8
+
+    def read(self, fc, addr, qty):
+        resp, rtt = self.transact(adu(struct.pack(">BHH", fc, addr, qty)))
+        return resp, rtt
+
+    def write_single(self, addr, val):
+        return self.transact(adu(struct.pack(">BHH", 6, addr, val)))
+
+    def write_multiple(self, addr, vals):
+        pdu = struct.pack(">BHHB", 0x10, addr, len(vals), 2 * len(vals)) + struct.pack(">%dH" % len(vals), *vals)
+        return self.transact(adu(pdu))
+
+
+def check_crc(resp):
+    return resp is not None and len(resp) >= 4 and crc16(resp) == 0
+
+
+def regs(resp):
+    n = resp[2] // 2
+    return list(struct.unpack(">%dH" % n, resp[3:3 + 2 * n]))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--port", required=True)
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("-n", type=int, default=200, help="requests for turnaround measurement")
+    ap.add_argument("--max-turnaround-us", type=int, default=500, help="device side limit")
+    ap.add_argument("--max-host-turnaround-ms", type=float, default=5.0, help="host side limit")
+    args = ap.parse_args()
+
+    port = serial.Serial(args.port, args.baud, timeout=0.01)
+    port.write(b"\rmodbus\r")
+    time.sleep(0.2)
+    m = Master(port, args.baud)
+    failed = []
+
+    def check(name, ok):
+        print("%-40s %s" % (name, "ok" if ok else "FAIL"))
+        if not ok:
+            failed.append(name)
+
+    resp, _ = m.read(4, 0x0000, 5)
+    check("read input registers", check_crc(resp) and resp[1] == 4 and resp[2] == 10)
+
+    resp, _ = m.write_single(0x0101, 0x1234)
+    check("write single register", check_crc(resp) and resp[:6] == adu(struct.pack(">BHH", 6, 0x0101, 0x1234))[:6])
+    resp, _ = m.read(3, 0x0101, 1)
+    check("read back single", check_crc(resp) and regs(resp) == [0x1234])
+
+    resp, _ = m.write_multiple(0x0101, [1, 2, 3, 4])
+    check("write multiple registers", check_crc(resp) and resp[1] == 0x10)
+    resp, _ = m.read(3, 0x0101, 4)
+    check("read back multiple", check_crc(resp) and regs(resp) == [1, 2, 3, 4])
+
+    resp, _ = m.transact(adu(bytes([0x2B, 0, 0])))
+    check("illegal function -> exception 1", check_crc(resp) and resp[1] == 0xAB and resp[2] == 1)
+    resp, _ = m.read(3, 0x0200, 1)
+    check("illegal address -> exception 2", check_crc(resp) and resp[1] == 0x83 and resp[2] == 2)
+    resp, _ = m.write_single(0x0100, 7)
+    check("illegal value -> exception 3", check_crc(resp) and resp[1] == 0x86 and resp[2] == 3)
+    resp, _ = m.read(3, 0x0000, 1)
+    check("holding read of input register -> exc 2", check_crc(resp) and resp[1] == 0x83 and resp[2] == 2)
+
+    bad = bytearray(adu(struct.pack(">BHH", 4, 0, 1)))
+    bad[-1] ^= 0xFF
+    resp, _ = m.transact(bytes(bad))
+    check("bad crc -> no response", resp is None)
+    resp, _ = m.transact(adu(struct.pack(">BHH", 4, 0, 1), addr=SLAVE + 1))
+    check("other slave address -> no response", resp is None)
+    resp, _ = m.transact(adu(struct.pack(">BHH", 4, 0, 1)), gap_at=3, gap_s=0.005)
+    check("gap inside frame -> no response", resp is None)
+
+    # turnaround
+    host = []
+    req = adu(struct.pack(">BHH", 4, 0, 5))
+    resp_len = 5 + 10
+    for _ in range(args.n):
+        resp, rtt = m.transact(req)
+        if not check_crc(resp):
+            check("turnaround request", False)
+            break
+        host.append(rtt - (len(req) + resp_len) * m.char_s - m.t35_s)
+    resp, _ = m.read(4, 0x0004, 1)
+    dev_max = regs(resp)[0] if check_crc(resp) else 0xFFFF
+
+    host_ms = sorted(x * 1000 for x in host)
+    if host_ms:
+        print("host turnaround: min %.2f ms, median %.2f ms, max %.2f ms (incl. USB latency)"
+              % (host_ms[0], host_ms[len(host_ms) // 2], host_ms[-1]))
+    print("device turnaround max: %d us" % dev_max)
+    check("device turnaround <= %d us" % args.max_turnaround_us, dev_max <= args.max_turnaround_us)
+    check("host turnaround <= %.1f ms" % args.max_host_turnaround_ms,
+          bool(host_ms) and host_ms[-1] <= args.max_host_turnaround_ms)
+
+    if failed:
+        print("%d check(s) failed" % len(failed))
+        sys.exit(1)
+    print("all checks passed")
+
+
+if __name__ == "__main__":
+    main()
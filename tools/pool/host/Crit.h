@@ -0,0 +1,12 @@
+/* host build of source/Pool (tools/pool/pool_bench.c): no interrupts to mask */
+#ifndef CRIT_HOST_H
+#define CRIT_HOST_H
+
+#include <stdint.h>
+
+typedef uint32_t crit_state_t;
+
+static inline crit_state_t Crit_enter(void) { return 0; }
+static inline void Crit_exit(crit_state_t primask) { (void)primask; }
+
+#endif /* CRIT_HOST_H */
@@ -0,0 +1,188 @@
+/**
+ * @file pool_bench.c
+ * @author Peter Medvesek (peter.medvesek@gorenje.com)
+ * @brief host benchmark of source/Pool against malloc/free. Same random alloc/free
+ * sequence (message buffer like sizes, up to LIVE_MAX blocks held) is run on both.
+ * Average and tail of single operation time is reported, tail is what matters when
+ * allocating from interrupts. Per operation time includes clock_gettime() overhead,
+ * max includes host scheduler preemption, so compare percentiles.
+ *
+ * build and run from repository root:
+ *  gcc -O2 -Itools/pool/host -Isource/Pool tools/pool/pool_bench.c source/Pool/Pool.c -o pool_bench
+ *  ./pool_bench
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2020 Gorenje d.o.o
+ *
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Pool.h"
+
+#define OPS         2000000u
+#define LIVE_MAX    12u
+#define ROUNDS      5u
+#define HIST_NS     10u         // histogram bucket
+#define HIST_CNT    1000u       // last bucket holds everything above
+
+typedef struct _bench_t{
+    const char  *p_name;
+    void        *(*alloc)(size_t size);
+    void        (*free)(void *p_block);
+    uint64_t    ns_sum;
+    uint64_t    ns_batch;   // whole untimed run, no per operation clock overhead
+    uint64_t    ns_max;
+    uint32_t    hist[HIST_CNT];
+    uint32_t    ops;
+    uint32_t    fails;
+}bench_t;
+
+static uint32_t rnd_state;
+
+static uint32_t rnd(void) {
+    rnd_state = (rnd_state * 1103515245u) + 12345u;
+    return rnd_state >> 8;
+}
+
+/* mostly small messages, some medium, few large */
+static size_t rnd_size(void) {
+    uint32_t r = rnd() % 100u;
+
+    if (r < 70u) {
+        return 1u + (rnd() % 16u);
+    }
+    if (r < 95u) {
+        return 17u + (rnd() % 48u);
+    }
+    return 65u + (rnd() % 192u);
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_batch(bench_t *p_bench) {
+    void *live[LIVE_MAX] = { 0 };
+    uint64_t start;
+    uint32_t i;
+    uint32_t slot;
+    size_t size;
+
+    rnd_state = 1;
+    start = now_ns();
+    for (i = 0; i < OPS; ++i) {
+        slot = rnd() % LIVE_MAX;
+        size = rnd_size();
+        if (live[slot] == NULL) {
+            live[slot] = p_bench->alloc(size);
+            if (live[slot] != NULL) {
+                memset(live[slot], (int)i, size);
+            }
+        } else {
+            p_bench->free(live[slot]);
+            live[slot] = NULL;
+        }
+    }
+    p_bench->ns_batch += now_ns() - start;
+    for (slot = 0; slot < LIVE_MAX; ++slot) {
+        p_bench->free(live[slot]);
+    }
+}
+
+static void bench_run(bench_t *p_bench) {
+    void *live[LIVE_MAX] = { 0 };
+    uint64_t start;
+    uint64_t ns;
+    uint32_t i;
+    uint32_t slot;
+    size_t size;
+
+    rnd_state = 1;
+    for (i = 0; i < OPS; ++i) {
+        slot = rnd() % LIVE_MAX;
+        size = rnd_size();
+        start = now_ns();
+        if (live[slot] == NULL) {
+            live[slot] = p_bench->alloc(size);
+        } else {
+            p_bench->free(live[slot]);
+            live[slot] = NULL;
+        }
+        ns = now_ns() - start;
+        p_bench->ns_sum += ns;
+        if (ns > p_bench->ns_max) {
+            p_bench->ns_max = ns;
+        }
+        p_bench->hist[(ns / HIST_NS) < HIST_CNT ? (ns / HIST_NS) : (HIST_CNT - 1u)]++;
+        p_bench->ops++;
+        if (live[slot] != NULL) {
+            memset(live[slot], (int)i, size);
+        }
+    }
+    for (slot = 0; slot < LIVE_MAX; ++slot) {
+        p_bench->free(live[slot]);
+    }
+}
+
+static uint64_t percentile(const bench_t *p_bench, double pct) {
+    uint64_t limit = (uint64_t)((double)p_bench->ops * pct / 100.0);
+    uint64_t cnt = 0;
+    uint32_t i;
+
+    for (i = 0; i < HIST_CNT; ++i) {
+        cnt += p_bench->hist[i];
+        if (cnt >= limit) {
+            break;
+        }
+    }
+    return (uint64_t)(i + 1u) * HIST_NS;
+}
+
+int main(void) {
+    static bench_t bench[2];
+    uint32_t round;
+    uint8_t b;
+    uint8_t id;
+
+    Pool_init();
+    bench[0].p_name = "malloc";
+    bench[0].alloc = &malloc;
+    bench[0].free = &free;
+    bench[1].p_name = "pool  ";
+    bench[1].alloc = Pool.alloc;
+    bench[1].free = Pool.free;
+    /* interleaved rounds, so both see the same machine state */
+    for (round = 0; round < ROUNDS; ++round) {
+        for (b = 0; b < 2u; ++b) {
+            bench_batch(&bench[b]);
+            bench_run(&bench[b]);
+        }
+    }
+    for (id = 0; id < POOL_CNT; ++id) {
+        bench[1].fails += Pool.stats((pool_id_t)id)->fails;
+    }
+
+    printf("%u ops per round, %u rounds, up to %u blocks held\n", OPS, ROUNDS, LIVE_MAX);
+    for (b = 0; b < 2u; ++b) {
+        printf("%s: avg %5.1f ns (batch %4.1f ns), p99 <%4llu ns, p99.99 <%5llu ns, max %8llu ns, failed allocs %u\n",
+               bench[b].p_name, (double)bench[b].ns_sum / bench[b].ops, (double)bench[b].ns_batch / bench[b].ops,
+               (unsigned long long)percentile(&bench[b], 99.0), (unsigned long long)percentile(&bench[b], 99.99),
+               (unsigned long long)bench[b].ns_max, bench[b].fails);
+    }
+    for (id = 0; id < POOL_CNT; ++id) {
+        const pool_stats_t *p_stats = Pool.stats((pool_id_t)id);
+
+        printf("pool %3u x %2u: used max %2u, fallbacks %lu, fails %lu\n", p_stats->block_size,
+               p_stats->block_cnt, p_stats->used_max, (unsigned long)p_stats->fallbacks,
+               (unsigned long)p_stats->fails);
+    }
+    return 0;
+}
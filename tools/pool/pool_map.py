@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+"""
+Report RAM reserved by each memory pool (source/Pool) from linker map file.
+
+Every block class has its own input section .pool.<name> (STM32F103C8_FLASH.ld), its
+size is taken from the map and checked against POOL_CLASSES in Pool.h when given.
+Other RAM output sections are listed too, so pools can be weighed against the rest.
+
+usage:
+    pool_map.py Debug/STM32F103_bluePil_evaluation.map
+    pool_map.py Debug/STM32F103_bluePil_evaluation.map --header source/Pool/Pool.h
+"""
+import argparse
+import re
+import sys
+
+RAM_START = 0x20000000
+RAM_SIZE = 20 * 1024
+
+# input section: name and address/size on same line, or size on the next one for long names
+POOL_RE = re.compile(r"^ \.pool\.(\w+)\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)", re.M)
+OUT_RE = re.compile(r"^(\.\w+|\._\w+)\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)", re.M)
+CLASS_RE = re.compile(r"X\(\s*(\w+)\s*,\s*(\w+)\s*,\s*(\w+)\s*\)")
+
+
+def unwrap(text):
+    """ join lines ld wraps after long section names """
+    return re.sub(r"^( \S+)\n\s+(0x)", r"\1 \2", text, flags=re.M)
+
+
+def read_classes(header_path):
+    with open(header_path, "r") as f:
+        text = f.read()
+    body = re.search(r"#define\s+POOL_CLASSES\(X\)(.*?)\n\s*\n", text + "\n\n", re.S).group(1)
+    return {m.group(1): (int(m.group(2), 0), int(m.group(3), 0)) for m in CLASS_RE.finditer(body)}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("map")
+    parser.add_argument("--header", help="Pool.h, check sizes against POOL_CLASSES")
+    args = parser.parse_args()
+
+    with open(args.map, "r") as f:
+        text = unwrap(f.read())
+
+    pools = [(m.group(1), int(m.group(2), 16), int(m.group(3), 16)) for m in POOL_RE.finditer(text)]
+    if not pools:
+        sys.exit("no .pool.* sections in map file")
+    ram = [(m.group(1), int(m.group(2), 16), int(m.group(3), 16)) for m in OUT_RE.finditer(text)]
+    ram = [r for r in ram if RAM_START <= r[1] < RAM_START + RAM_SIZE and r[2] != 0]
+
+    classes = read_classes(args.header) if args.header else {}
+    errors = 0
+    print("%-10s %10s %7s %6s  %s" % ("pool", "address", "bytes", "RAM %", "blocks"))
+    for name, addr, size in pools:
+        blocks = ""
+        if name in classes:
+            block_size, block_cnt = classes[name]
+            blocks = "%d x %d" % (block_cnt, block_size)
+            if block_size * block_cnt != size:
+                blocks += "  MISMATCH with Pool.h"
+                errors += 1
+        print("%-10s 0x%08x %7d %5.1f%%  %s" % (name, addr, size, 100.0 * size / RAM_SIZE, blocks))
+    total = sum(p[2] for p in pools)
+    print("%-10s %10s %7d %5.1f%%" % ("total", "", total, 100.0 * total / RAM_SIZE))
+
+    print()
+    print("%-18s %10s %7s %6s" % ("RAM section", "address", "bytes", "RAM %"))
+    for name, addr, size in ram:
+        print("%-18s 0x%08x %7d %5.1f%%" % (name, addr, size, 100.0 * size / RAM_SIZE))
+    used = sum(r[2] for r in ram)
+    print("%-18s %10s %7d %5.1f%%, free %d" % ("total", "", used, 100.0 * used / RAM_SIZE, RAM_SIZE - used))
+    return 1 if errors else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+"""
+Flat profile from sampling profiler histogram (source/Prof).
+
+Dump is requested by sending "prof dump\\r" to serial_0 (profiler started before with
+"prof start [rate]"). Input is either a file with raw captured bytes or serial port
+(needs pyserial, dump is requested by the tool).
+
+Functions are taken from the linker map file (one .text.<name> input section per function,
+-ffunction-sections) or from the .elf with arm-none-eabi-nm. A bin that spans more than
+one function is split between them by overlap.
+
+usage:
+    prof_report.py --map Debug/STM32F103_bluePil_evaluation.map --file prof.bin
+    prof_report.py --elf Debug/STM32F103_bluePil_evaluation.elf --port COM5 --top 30
+"""
+import argparse
+import bisect
+import re
+import struct
+import subprocess
+import sys
+
+HDR_FMT = "<4sIHHI2Q5I4x"
+HDR_SIZE = struct.calcsize(HDR_FMT)
+BIN_FMT = "<HH"
+BIN_SIZE = struct.calcsize(BIN_FMT)
+MAGIC = b"PRF2"
+
+# " .text.name  0x08002134  0x48 file.o", ld wraps the line after long names
+SECT_RE = re.compile(r"^ \.text\.(\S+)\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)", re.M)
+
+
+def unwrap(text):
+    """ join lines ld wraps after long section names """
+    return re.sub(r"^( \S+)\n\s+(0x)", r"\1 \2", text, flags=re.M)
+
+
+def funcs_from_map(path):
+    with open(path, "r") as f:
+        text = unwrap(f.read())
+    funcs = [(int(a, 16), int(s, 16), n) for n, a, s in SECT_RE.findall(text)]
+    return [f for f in funcs if f[0] != 0 and f[1] != 0]
+
+
+def funcs_from_elf(path, nm):
+    out = subprocess.run([nm, "-C", "-S", "-n", path], stdout=subprocess.PIPE,
+                         universal_newlines=True, check=True).stdout
+    funcs = []
+    for line in out.splitlines():
+        parts = line.split(None, 3)
+        if len(parts) == 4 and parts[2] in "tTwW":
+            funcs.append((int(parts[0], 16) & ~1, int(parts[1], 16), parts[3]))
+    return funcs
+
+
+def read_dump(stream):
+    """ find header in byte stream (shell echo may precede it) and return header + bins """
+    window = b""
+    while True:
+        b = stream.read(1)
+        if not b:
+            raise EOFError("profile header not found")
+        window = (window + b)[-4:]
+        if window == MAGIC:
+            break
+    hdr = struct.unpack(HDR_FMT, MAGIC + stream.read(HDR_SIZE - 4))
+    _, base, bin_size, bin_cnt, core_clk = hdr[:5]
+    names = ("isr_cycles", "elapsed", "samples", "ram", "other", "saturated", "rate")
+    stats = dict(zip(names, hdr[5:]))
+    data = b""
+    while len(data) < bin_cnt * BIN_SIZE:
+        chunk = stream.read(bin_cnt * BIN_SIZE - len(data))
+        if not chunk:
+            raise EOFError("dump truncated (%d of %d bins)" % (len(data) // BIN_SIZE, bin_cnt))
+        data += chunk
+    bins = [struct.unpack_from(BIN_FMT, data, i * BIN_SIZE) for i in range(bin_cnt)]
+    return base, bin_size, core_clk, stats, bins
+
+
+def attribute(base, bin_size, bins, funcs):
+    """ {function: samples}, bin split by overlap with functions, rest is '?' """
+    funcs = sorted(funcs)
+    starts = [f[0] for f in funcs]
+    result = {}
+    for idx, cnt in bins:
+        lo = base + idx * bin_size
+        hi = lo + bin_size
+        i = max(bisect.bisect_right(starts, lo) - 1, 0)
+        covered = 0
+        parts = []
+        while i < len(funcs) and funcs[i][0] < hi:
+            overlap = min(hi, funcs[i][0] + funcs[i][1]) - max(lo, funcs[i][0])
+            if overlap > 0:
+                parts.append((funcs[i][2], overlap))
+                covered += overlap
+            i += 1
+        if covered == 0:
+            result["?"] = result.get("?", 0) + cnt
+            continue
+        for name, overlap in parts:
+            result[name] = result.get(name, 0) + cnt * overlap / covered
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    src = parser.add_mutually_exclusive_group(required=True)
+    src.add_argument("--file", help="raw captured dump")
+    src.add_argument("--port", help="serial port, dump is requested with \"prof dump\"")
+    parser.add_argument("--baud", type=int, default=115200)
+    sym = parser.add_mutually_exclusive_group(required=True)
+    sym.add_argument("--map", help="linker map file")
+    sym.add_argument("--elf", help="application .elf")
+    parser.add_argument("--nm", default="arm-none-eabi-nm")
+    parser.add_argument("--top", type=int, default=20, help="functions to list")
+    args = parser.parse_args()
+
+    if args.port:
+        import serial
+        with serial.Serial(args.port, args.baud, timeout=2.0) as port:
+            port.reset_input_buffer()
+            port.write(b"prof dump\r")
+            base, bin_size, core_clk, stats, bins = read_dump(port)
+    else:
+        with open(args.file, "rb") as f:
+            base, bin_size, core_clk, stats, bins = read_dump(f)
+
+    funcs = funcs_from_map(args.map) if args.map else funcs_from_elf(args.elf, args.nm)
+    profile = attribute(base, bin_size, bins, funcs)
+
+    total = stats["samples"]
+    if total == 0:
+        sys.exit("no samples, start profiler with \"prof start\"")
+    seconds = stats["elapsed"] / core_clk
+    print("%d samples at %d Hz over %.1f s, %d B bins" % (total, stats["rate"], seconds, bin_size))
+    print("overhead %.2f %% of CPU (%.0f cycles per sample)" % (
+        100.0 * stats["isr_cycles"] / max(stats["elapsed"], 1), stats["isr_cycles"] / total))
+    if stats["saturated"]:
+        print("%d samples lost to full bins, profile is skewed, use shorter run" % stats["saturated"])
+    print()
+    print("%7s %6s  %s" % ("samples", "%", "function"))
+    rows = sorted(profile.items(), key=lambda kv: -kv[1])[:args.top]
+    rows += [("(sram, .ramfunc)", stats["ram"]), ("(other)", stats["other"])]
+    for name, cnt in rows:
+        if cnt:
+            print("%7.0f %5.1f%%  %s" % (cnt, 100.0 * cnt / total, name))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
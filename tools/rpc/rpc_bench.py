@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""
+Benchmark of pipelined RPC (source/Rpc) against stop-and-wait polling.
+
+Baseline is the current pattern: one text request ("uptime" shell command) and wait for
+the answer before sending the next one. Then the port is switched to RPC mode and echo
+requests are sent with 1 (stop-and-wait), 4 and 16 requests in flight.
+
+usage:
+    rpc_bench.py --port COM5 [--baud 115200] [-n 500] [--size 16]
+"""
+import argparse
+import statistics
+import struct
+import time
+
+import serial
+
+SOF = 0xA5
+OP_EXIT, OP_ECHO, OP_DELAY_ECHO, OP_GET_TICK = range(4)
+STATUS = {0: "ok", 1: "bad op", 2: "bad arg", 3: "busy"}
+
+
+def crc8(data):
+    crc = 0
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def frame(req_id, op, payload=b""):
+    body = bytes([len(payload), req_id, op]) + payload
+    return bytes([SOF]) + body + bytes([crc8(body)])
+
+
+class Parser:
+    """ incremental response parser -> list of (id, status, payload) """
+
+    def __init__(self):
+        self.buf = bytearray()
+
+    def feed(self, data):
+        self.buf += data
+        out = []
+        while True:
+            start = self.buf.find(bytes([SOF]))
+            if start < 0:
+                self.buf.clear()
+                return out
+            del self.buf[:start]
+            if len(self.buf) < 2 or len(self.buf) < self.buf[1] + 5:
+                return out
+            n = self.buf[1]
+            body = bytes(self.buf[1:4 + n])
+            if crc8(body) == self.buf[4 + n]:
+                out.append((body[1], body[2], body[3:]))
+                del self.buf[:5 + n]
+            else:
+                del self.buf[:1]
+
+
+def bench_text(port, n):
+    """ current pattern: text command, wait for prompt """
+    lat = []
+    port.reset_input_buffer()
+    t0 = time.perf_counter()
+    for _ in range(n):
+        t = time.perf_counter()
+        port.write(b"uptime\r")
+        port.read_until(b"> ")
+        lat.append(time.perf_counter() - t)
+    return n / (time.perf_counter() - t0), lat
+
+
+def bench_rpc(port, n, depth, size):
+    parser = Parser()
+    sent = {}
+    lat = []
+    next_id = 0
+    done = 0
+    errors = 0
+    payload = bytes(range(size))
+    t0 = time.perf_counter()
+    while done < n:
+        while len(sent) < depth and next_id < n:
+            rid = next_id & 0xFF
+            port.write(frame(rid, OP_ECHO, payload))
+            sent[rid] = time.perf_counter()
+            next_id += 1
+        for rid, status, data in parser.feed(port.read(max(1, port.in_waiting))):
+            if rid not in sent:
+                continue
+            lat.append(time.perf_counter() - sent.pop(rid))
+            done += 1
+            if status != 0 or data != payload:
+                errors += 1
+        if sent and time.perf_counter() - min(sent.values()) > 1.0:
+            raise TimeoutError("no response for %s" % list(sent))
+    return n / (time.perf_counter() - t0), lat, errors
+
+
+def show_order(port):
+    """ async completion: longer delays are sent first and answered last """
+    parser = Parser()
+    for rid, delay in enumerate((40, 30, 20, 10)):
+        port.write(frame(rid, OP_DELAY_ECHO, struct.pack("<H", delay) + bytes([rid])))
+    got = []
+    t_end = time.time() + 1.0
+    while len(got) < 4 and time.time() < t_end:
+        got += [rid for rid, _, _ in parser.feed(port.read(max(1, port.in_waiting)))]
+    print("request order 0,1,2,3 -> response order %s" % ",".join(map(str, got)))
+
+
+def report(name, rate, lat):
+    lat_ms = sorted(x * 1000 for x in lat)
+    p99 = lat_ms[min(len(lat_ms) - 1, int(len(lat_ms) * 0.99))]
+    print("%-22s %8.0f req/s   latency mean %6.2f ms  p50 %6.2f ms  p99 %6.2f ms"
+          % (name, rate, statistics.mean(lat_ms), statistics.median(lat_ms), p99))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--port", required=True)
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("-n", type=int, default=500, help="requests per run")
+    ap.add_argument("--size", type=int, default=16, help="echo payload size")
+    args = ap.parse_args()
+
+    port = serial.Serial(args.port, args.baud, timeout=0.05)
+    port.write(b"\r")
+    time.sleep(0.1)
+
+    rate, lat = bench_text(port, args.n)
+    report("text stop-and-wait", rate, lat)
+
+    port.write(b"rpc\r")
+    time.sleep(0.1)
+    port.reset_input_buffer()
+
+    for depth in (1, 4, 16):
+        rate, lat, errors = bench_rpc(port, args.n, depth, args.size)
+        name = "rpc %2d in flight" % depth + (" (%d err)" % errors if errors else "")
+        report(name, rate, lat)
+
+    show_order(port)
+
+    port.write(frame(0, OP_EXIT))
+    time.sleep(0.1)
+
+
+if __name__ == "__main__":
+    main()
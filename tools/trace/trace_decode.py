@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+"""
+Decode binary trace dump (source/Trace) into Chrome trace JSON (chrome://tracing, Perfetto).
+
+Dump is requested by sending "trace\\r" to serial_0. Input is either a file with raw
+captured bytes or serial port (needs pyserial).
+
+usage:
+    trace_decode.py --ids source/Trace/Trace.h --file dump.bin -o trace.json
+    trace_decode.py --ids source/Trace/Trace.h --port COM5 --baud 115200 -o trace.json
+"""
+import argparse
+import json
+import re
+import struct
+import sys
+
+HDR_FMT = "<4sHHII"
+HDR_SIZE = struct.calcsize(HDR_FMT)
+EVT_FMT = "<IHHI"
+EVT_SIZE = struct.calcsize(EVT_FMT)
+MAGIC = b"TRC1"
+
+KIND_MSK = 0xC000
+KIND_PHASE = {0x0000: "i", 0x4000: "B", 0x8000: "E"}
+
+
+def load_ids(header_path):
+    """ read trace_id_t enum from Trace.h -> {id: name} """
+    names = {}
+    if header_path is None:
+        return names
+    with open(header_path, "r") as f:
+        text = f.read()
+    body = re.search(r"typedef\s+enum\s+_trace_id_t\s*\{(.*?)\}", text, re.S).group(1)
+    value = 0
+    for line in body.splitlines():
+        m = re.match(r"\s*TRACE_ID_(\w+)\s*(?:=\s*(\w+))?\s*,?", line)
+        if not m:
+            continue
+        if m.group(2) is not None:
+            value = int(m.group(2), 0)
+        names[value] = m.group(1)
+        value += 1
+    return names
+
+
+def read_dump(stream):
+    """ find header in byte stream (other text may precede it) and return header + events """
+    window = b""
+    while True:
+        b = stream.read(1)
+        if not b:
+            raise EOFError("trace header not found")
+        window = (window + b)[-4:]
+        if window == MAGIC:
+            break
+    rest = stream.read(HDR_SIZE - 4)
+    _, evt_size, evt_cnt, core_clk, lost = struct.unpack(HDR_FMT, MAGIC + rest)
+    if evt_size != EVT_SIZE:
+        raise ValueError("unexpected event size %d" % evt_size)
+    data = b""
+    while len(data) < evt_cnt * EVT_SIZE:
+        chunk = stream.read(evt_cnt * EVT_SIZE - len(data))
+        if not chunk:
+            raise EOFError("dump truncated (%d of %d events)" % (len(data) // EVT_SIZE, evt_cnt))
+        data += chunk
+    events = [struct.unpack_from(EVT_FMT, data, i * EVT_SIZE) for i in range(evt_cnt)]
+    return core_clk, lost, events
+
+
+def to_chrome(core_clk, events, names):
+    """ unwrap 32 bit cycle counter and build chrome trace events """
+    out = []
+    t64 = 0
+    last = None
+    for tm, evt_id, arg0, arg1 in events:
+        if last is not None:
+            delta = (tm - last) & 0xFFFFFFFF
+            if delta >= 0x80000000:
+                # recorded by preempting ISR a bit earlier than previous slot
+                delta -= 0x100000000
+            t64 += delta
+        last = tm
+        num = evt_id & ~KIND_MSK & 0xFFFF
+        name = names.get(num, "evt_%d" % num)
+        out.append({
+            "name": name,
+            "ph": KIND_PHASE.get(evt_id & KIND_MSK, "i"),
+            "ts": t64 * 1e6 / core_clk,
+            "pid": 0,
+            "tid": 1 if name.startswith("ISR") else 0,
+            "s": "t",
+            "args": {"arg0": arg0, "arg1": arg1},
+        })
+    out.sort(key=lambda e: e["ts"])
+    return {"traceEvents": out, "displayTimeUnit": "ns"}
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--ids", help="path to Trace.h with trace_id_t enum")
+    ap.add_argument("--file", help="raw dump file")
+    ap.add_argument("--port", help="serial port, sends 'trace' request and reads dump")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("-o", "--out", default="-", help="output json (default stdout)")
+    args = ap.parse_args()
+
+    names = load_ids(args.ids)
+    if args.port:
+        import serial
+        stream = serial.Serial(args.port, args.baud, timeout=5)
+        stream.reset_input_buffer()
+        stream.write(b"trace\r")
+    elif args.file:
+        stream = open(args.file, "rb")
+    else:
+        stream = sys.stdin.buffer
+
+    core_clk, lost, events = read_dump(stream)
+    sys.stderr.write("%d events, %d lost, core clock %d Hz\n" % (len(events), lost, core_clk))
+
+    trace = to_chrome(core_clk, events, names)
+    if args.out == "-":
+        json.dump(trace, sys.stdout, indent=1)
+    else:
+        with open(args.out, "w") as f:
+            json.dump(trace, f, indent=1)
+
+
+if __name__ == "__main__":
+    main()